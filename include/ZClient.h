@@ -2,10 +2,18 @@
 #define ZCLIENT_H
 
 #include <WiFiClient.h>
+#include "z/options.h"
+#include "ZTelnet.h"
+#include "ZInflate.h"
+#include "ZTls.h"
 
 #define ZCLIENT_FLAG_PETSCII    0x01
 #define ZCLIENT_FLAG_TELNET     0x02
 
+#define ZBACKLOG_HOLD           0   // stop reading, let TCP push back
+#define ZBACKLOG_DROP_OLDEST    1
+#define ZBACKLOG_DROP_NEWEST    2
+
 class ZClient : public WiFiClient
 {
 private:
@@ -15,17 +23,73 @@ private:
     int m_id;
     char m_host[32];
     bool m_answered;
+    bool m_inbound;
     uint8_t flags;
+    ZTelnet m_telnet;
+    ZInflate *m_inflate;
+    ZTls *m_tls;
+    unsigned long m_compressedBytes;
+    unsigned long m_decompressedBytes;
+    uint8_t *m_backlog;
+    size_t m_backlogSize;
+    size_t m_backlogHead;
+    size_t m_backlogLen;
+    unsigned long m_backlogDropped;
+    size_t m_muxCredit;
+    uint8_t *m_muxHold;
+    size_t m_muxHoldLen;
+
+    static size_t telnetOutput(void *arg, const uint8_t *data, size_t len);
 
 public:
     ZClient();
+    ZClient(const WiFiClient &client);
+    ~ZClient();
 
     int connect(const char *host, uint16_t port);
+    void adopt(int fd, const char *host);
+    int receive(uint8_t *buf, size_t size);
+    bool startCompression(const uint8_t *data, size_t len);
+    bool startTls();
+    int pollTls();
+    size_t pushBacklog(const uint8_t *data, size_t len, uint8_t policy);
+    size_t popBacklog(uint8_t *buf, size_t size);
+    size_t holdMux(const uint8_t *data, size_t len);
+    void releaseMux(size_t len);
+
+    // routed through TLS once startTls() was called
+    using Base::write;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    uint8_t connected() override;
+    void stop() override;
     
     inline int id() { return m_id; }
     inline char *host() { return m_host; }
     inline uint16_t port() { return remotePort(); }
     inline bool answered() { return m_answered; }
+    inline bool inbound() { return m_inbound; }
+    inline bool ringing() { return m_inbound && !m_answered; }
+    inline void answer() { m_answered = true; }
+    inline ZTelnet &telnet() { return m_telnet; }
+    inline bool compressing() { return m_inflate != nullptr; }
+    inline bool secure() { return m_tls != nullptr; }
+    inline ZTls *tls() { return m_tls; }
+    inline unsigned long compressedBytes() { return m_compressedBytes; }
+    inline unsigned long decompressedBytes() { return m_decompressedBytes; }
+    inline size_t backlogLength() { return m_backlogLen; }
+    inline size_t backlogSpace() { return (m_backlog != nullptr ? m_backlogSize : ZCLIENT_BACKLOG_SIZE) - m_backlogLen; }
+    inline unsigned long backlogDropped() { return m_backlogDropped; }
+    inline size_t muxCredit() { return m_muxCredit; }
+    inline void setMuxCredit(size_t bytes) { m_muxCredit = bytes; }
+    inline void grantMux(size_t bytes) { m_muxCredit += bytes; }
+    inline void spendMux(size_t bytes) { m_muxCredit -= bytes; }
+    inline const uint8_t *muxHeld() { return m_muxHold; }
+    inline size_t muxHeldLength() { return m_muxHoldLen; }
     inline bool petsciiMode() { return (flags & ZCLIENT_FLAG_PETSCII) == ZCLIENT_FLAG_PETSCII; }
     inline bool telnetMode() { return (flags & ZCLIENT_FLAG_TELNET) == ZCLIENT_FLAG_TELNET; }
     inline void setPetsciiMode(bool state)
@@ -0,0 +1,94 @@
+#ifndef ZCOMMAND_H
+#define ZCOMMAND_H
+
+#include "z/types.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define MAX_COMMAND_SIZE 256
+#define MAX_COMMAND_KEY 16
+
+// One sub-command of an AT line.  vbuf points into the parser and is only
+// valid until the next call to next().
+struct ZCommand
+{
+    char cmd;           // lower case letter, or one of & % + $
+    char sec;           // letter after & or %
+    char name[MAX_COMMAND_KEY]; // dispatch key: "d", "&v", "%c", "+mux", "$ssid"
+    uint8_t *vbuf;      // argument, NUL terminated; the value for $name=value
+    int vlen;
+    long vval;          // digits of the argument, when isNumber
+    bool isNumber;
+    const char *dmodifiers;
+};
+
+// Splits AT command lines without touching the heap.  The line is copied in,
+// so the caller may reuse its input buffer straight after begin().
+class ZCommandParser
+{
+private:
+    char line[MAX_COMMAND_SIZE + 1];
+    char last[MAX_COMMAND_SIZE + 1];
+    uint8_t arg[MAX_COMMAND_SIZE + 1];
+    char modifiers[MAX_COMMAND_SIZE + 1];
+    int len = 0;
+    int pos = 0;
+
+public:
+    static char lc(char c);
+
+    ZCommandParser();
+
+    bool begin(const char *input, size_t size);
+    bool next(ZCommand &c);
+
+    inline const char *current() const { return line; }
+};
+
+// Dispatch tables map a command key to a handler of the owning class.  They
+// are sorted by key so lookup is a binary search; commandTableSorted() lets
+// the owner check that at compile time.
+template <class T>
+struct ZCommandEntry
+{
+    const char *name;
+    ZResult (T::*handler)(const ZCommand &c, ZResult rc);
+};
+
+constexpr int commandKeyCompare(const char *a, const char *b)
+{
+    return (*a != *b || *a == '\0') ? (unsigned char)*a - (unsigned char)*b : commandKeyCompare(a + 1, b + 1);
+}
+
+template <class T>
+constexpr bool commandTableSorted(const ZCommandEntry<T> *table, size_t n)
+{
+    return n < 2 || (commandKeyCompare(table[0].name, table[1].name) < 0 && commandTableSorted(table + 1, n - 1));
+}
+
+template <class T>
+const ZCommandEntry<T> *commandLookup(const ZCommandEntry<T> *table, size_t n, const char *name)
+{
+    size_t lo = 0;
+    while (n > 0)
+    {
+        size_t half = n / 2;
+        int d = commandKeyCompare(table[lo + half].name, name);
+        if (d == 0)
+        {
+            return &table[lo + half];
+        }
+        if (d < 0)
+        {
+            lo += half + 1;
+            n -= half + 1;
+        }
+        else
+        {
+            n = half;
+        }
+    }
+    return nullptr;
+}
+
+#endif
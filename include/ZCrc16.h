@@ -0,0 +1,14 @@
+#ifndef ZCRC16_H
+#define ZCRC16_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-16 with polynomial 0x1021, most significant bit first.  Packet mode
+// frames start from 0xFFFF (CCITT), XMODEM blocks from 0.
+namespace ZCrc16
+{
+    uint16_t update(uint16_t crc, const uint8_t *data, size_t len);
+}
+
+#endif
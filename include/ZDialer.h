@@ -0,0 +1,69 @@
+#ifndef ZDIALER_H
+#define ZDIALER_H
+
+#include "z/options.h"
+#include "ZClient.h"
+#include "ZPhonebook.h"
+
+#define ZDIALER_PENDING -2
+#define ZDIALER_FAILED  -1
+
+// Races non-blocking connects to every mirror of a phonebook entry.
+// Attempts start DIAL_STAGGER ms apart, fastest known mirror first; the
+// first one to complete wins and the rest are closed.  poll() never
+// blocks, so a dial can be driven from tick() and aborted at any time.
+class ZDialer
+{
+private:
+    enum AttemptState
+    {
+        IDLE,
+        RESOLVING,
+        CONNECTING,
+        FAILED
+    };
+
+    struct Attempt
+    {
+        AttemptState state;
+        int fd;
+        unsigned long started;
+    };
+
+    PBEntry m_entry;
+    Attempt attempts[ZPHONEBOOK_ENDPOINTS];
+    int m_order[ZPHONEBOOK_ENDPOINTS];
+    int m_count;
+    int m_next;
+    int m_active;
+    int m_winner;
+    int m_winnerFd;
+    unsigned long m_begin;
+    unsigned long m_lastStart;
+    unsigned long m_timeout;
+    unsigned long m_races;
+    unsigned long m_lastTime;
+    bool m_reordered;
+
+    void order();
+    void fail(int index);
+    void finish(bool measured = true);
+    static uint16_t split(const char *address, char *host, size_t size);
+    static int open(IPAddress ip, uint16_t port);
+
+public:
+    ZDialer();
+
+    void begin(const PBEntry &pbe, unsigned long timeout = DIAL_TIMEOUT);
+    int poll();
+    void abort();
+    bool take(ZClient &client);
+
+    inline bool active() { return m_count > 0 && m_winner == ZDIALER_PENDING; }
+    inline PBEntry &entry() { return m_entry; }
+    inline unsigned long races() { return m_races; }
+    inline unsigned long lastTime() { return m_lastTime; }
+    inline bool reordered() { return m_reordered; }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef ZFLOWCONTROL_H
+#define ZFLOWCONTROL_H
+
+#include "z/options.h"
+#include "z/types.h"
+#include <stddef.h>
+
+struct ZFlowStats
+{
+    unsigned long holds;
+    unsigned long heldTime;     // ms
+    unsigned long longestHold;  // ms
+    unsigned long socketStalls;
+    unsigned long unprotected;  // holds needed with flow control off
+};
+
+// Holds the DTE off (RTS or XOFF) when the data it sends piles up faster
+// than the socket takes it, and lets it go again with hysteresis.
+class ZFlowControl
+{
+private:
+    FlowControlMode mode = FCM_DISABLED;
+    bool held = false;
+    unsigned long heldAt = 0;
+    volatile bool stalled = false;
+    ZFlowStats stats = {};
+
+    void hold();
+
+public:
+    void begin(FlowControlMode mode);
+    void update(size_t used, size_t capacity);
+    void release();
+    void socketWrite(size_t requested, size_t written, unsigned long elapsed);
+
+    inline bool holding() { return held; }
+    inline bool socketStalled() { return stalled; }
+    inline const ZFlowStats &statistics() { return stats; }
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef ZGATEWAY_H
+#define ZGATEWAY_H
+
+#include <IPAddress.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <lwip/opt.h>
+#include <lwip/netif.h>
+#include <lwip/pbuf.h>
+#include "z/options.h"
+#if PPP_SUPPORT
+#include <netif/ppp/ppp.h>
+#endif
+
+enum ZGatewayProtocol
+{
+    ZGATEWAY_NONE,
+    ZGATEWAY_SLIP,
+    ZGATEWAY_PPP
+};
+
+struct ZGatewayStats
+{
+    unsigned long framesIn;
+    unsigned long framesOut;
+    unsigned long bytesIn;
+    unsigned long bytesOut;
+    unsigned long errors;
+};
+
+// Terminates an IP link on the DTE serial line in a local lwIP netif and
+// translates it (NAPT) onto the WiFi station.  SLIP frames are decoded
+// straight into the pbuf handed to lwIP.  Outgoing packets are queued by
+// the tcpip thread, which must never wait on the UART, and written out by
+// output() as the UART has room; input() and output() run in tick().
+class ZGateway
+{
+private:
+    ZGatewayProtocol m_protocol = ZGATEWAY_NONE;
+    struct netif m_netif;
+    ip4_addr_t m_local;
+    ip4_addr_t m_peer;
+    volatile bool m_up = false;
+    volatile bool m_lost = false;
+    volatile bool m_napt = false;
+#if PPP_SUPPORT
+    ppp_pcb *m_ppp = nullptr;
+#endif
+    struct pbuf *m_frame = nullptr; // SLIP frame being received
+    size_t m_frameLen = 0;
+    bool m_escaped = false;
+    bool m_discard = false;
+    QueueHandle_t m_txQueue = nullptr; // pbufs from the tcpip thread
+    uint8_t m_txBuf[2 * GATEWAY_MTU + 2]; // frame being written to the UART
+    size_t m_txLen = 0;
+    size_t m_txPos = 0;
+    ZGatewayStats stats = {};
+
+    static err_t callbackSlipInit(struct netif *netif);
+    static err_t callbackSlipOutput(struct netif *netif, struct pbuf *p, const ip4_addr_t *addr);
+    static void callbackNapt(void *arg);
+#if PPP_SUPPORT
+    static u32_t callbackPppOutput(ppp_pcb *pcb, u8_t *data, u32_t len, void *ctx);
+    static void callbackPppStatus(ppp_pcb *pcb, int code, void *ctx);
+    void pppStatus(int code);
+#endif
+
+    bool beginSlip();
+    bool beginPpp(IPAddress dns);
+    err_t queueOutput(struct pbuf *p);
+    size_t slipEncode(struct pbuf *p, uint8_t *out);
+    void slipInput(const uint8_t *data, size_t len);
+    void napt();
+    void setNapt(bool state);
+
+public:
+    bool begin(ZGatewayProtocol protocol, IPAddress dns);
+    void end();
+    void input(const uint8_t *data, size_t len);
+    bool output();
+
+    static bool supported(ZGatewayProtocol protocol);
+
+    inline ZGatewayProtocol protocol() { return m_protocol; }
+    inline bool linkUp() { return m_up; }
+    inline bool linkLost() { return m_lost; }
+    inline IPAddress localIP() { return IPAddress(m_local.addr); }
+    inline IPAddress peerIP() { return IPAddress(m_peer.addr); }
+    inline const ZGatewayStats &statistics() { return stats; }
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef ZINFLATE_H
+#define ZINFLATE_H
+
+#include <Client.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp32/rom/miniz.h"
+
+#define ZINFLATE_IN_SIZE 512
+
+// Streaming zlib inflater for MCCP2. The decompressor state and the 32k
+// LZ window are only allocated between begin() and end().
+class ZInflate
+{
+private:
+    tinfl_decompressor *decomp;
+    uint8_t *dict;
+    size_t dictOfs;
+    size_t outPos;
+    size_t outLen;
+    uint8_t in[ZINFLATE_IN_SIZE];
+    size_t inPos;
+    size_t inLen;
+    tinfl_status status;
+
+    void compact();
+
+public:
+    ZInflate();
+    ~ZInflate();
+
+    bool begin();
+    void end();
+
+    size_t feed(const uint8_t *data, size_t len);
+    size_t fill(Client &src, size_t avail);
+    size_t read(uint8_t *out, size_t size);
+
+    inline size_t inputSpace() { return sizeof(in) - (inLen - inPos); }
+    inline size_t pendingInput() { return inLen - inPos; }
+    inline size_t pendingOutput() { return outLen; }
+    inline bool finished() { return status == TINFL_STATUS_DONE; }
+    inline bool failed() { return status < 0; }
+};
+
+#endif
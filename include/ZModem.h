@@ -11,12 +11,27 @@
 #include "ZConsole.h"
 #include "ZUpdater.h"
 #include "ZDebug.h"
+#include "ZRingBuffer.h"
+#include "ZDialer.h"
+#include "ZFlowControl.h"
+#include "ZMux.h"
+#include "ZGateway.h"
+#include "ZV42bis.h"
+#include "ZXmodem.h"
+#include "ZCommand.h"
+#include <CString.h>
 #include <Arduino.h>
 #include <LinkedList.h>
 #include <WebServer.h>
+#include <WiFiServer.h>
 #include <ESPmDNS.h>
+#include <esp_timer.h>
+#include <freertos/event_groups.h>
+#include <atomic>
 
-#define MAX_COMMAND_SIZE 256
+// bridgeEvents bits, held by the bridge tasks while they are parked
+#define BRIDGE_DTE_PARKED BIT0
+#define BRIDGE_NET_PARKED BIT1
 
 const char compile_date[] = __DATE__ " " __TIME__;
 
@@ -25,13 +40,38 @@ class ZModem
 private:
 	static const char *const RESULT_CODES_V0[];
 	static const char *const RESULT_CODES_V1[];
-	static const unsigned char PET2ASC_TABLE[256];
-	static const unsigned char ASC2PET_TABLE[256];
+	static const ZCommandEntry<ZModem> COMMANDS[];
+	static const size_t COMMAND_COUNT;
 
 	static char lc(char c);
-	static bool asc2pet(char *c);
 	static int modifierCompare(const char *ma, const char *m2);
 
+	static void callbackDteTask(void *arg)
+	{
+		reinterpret_cast<ZModem *>(arg)->dteTask();
+	}
+
+	static void callbackNetTask(void *arg)
+	{
+		reinterpret_cast<ZModem *>(arg)->netTask();
+	}
+
+	static void callbackXmodemRemote(void *arg, const uint8_t *data, size_t len)
+	{
+		reinterpret_cast<ZModem *>(arg)->xmodemRemote(data, len);
+	}
+
+	static void callbackXmodemDte(void *arg, const uint8_t *data, size_t len)
+	{
+		reinterpret_cast<ZModem *>(arg)->xmodemDte(data, len);
+	}
+
+	static void callbackEscapeTimer(void *arg)
+	{
+		reinterpret_cast<ZModem *>(arg)->escTimerFired = true;
+		Serial2.wake();
+	}
+
 	ZMode mode;
 	ZEscape esc;
 	ZProfile SREG;
@@ -40,12 +80,75 @@ private:
 	ZShell shell;
 	ZConsole console;
 	LinkedList<ZClient *> clients;
+	ZDialer dialer;
+	ZFlowControl flow;
+	ZXmodem xmodem;
+	ZV42bisEncoder v42;
+	bool v42Active = false;
+	unsigned long v42Stamp = 0;
+	unsigned long v42BytesIn = 0;
+	unsigned long v42BytesOut = 0;
+	uint64_t v42Time = 0;
+	ZGateway gateway;
+	ZMux mux;
+	LinkedList<String> muxOpens;
+	bool muxStarted = false;
+	bool muxDialing = false;
+	WiFiServer *listener = nullptr;
+	uint16_t listenerPort = 0;
+	String listenModifiers;
+	unsigned long ringTimer = 0;
+	bool ringActive = false;
 	WebServer httpServer;
 	ZUpdater httpUpdater;
-	uint8_t buffer[MAX_COMMAND_SIZE];
+	char reportBuf[REPORT_BUFFER_SIZE];
+	CString report;		// ATI / AT&V output, drained by ZOP_REPORT
+	size_t reportSent = 0;
+	uint8_t buffer[MAX_COMMAND_SIZE + 1];
 	size_t buflen;
+	uint8_t txChunk[BRIDGE_CHUNK_SIZE];
+	uint8_t rxChunk[BRIDGE_CHUNK_SIZE];
+	uint8_t dteChunk[BRIDGE_CHUNK_SIZE];
+	uint8_t netChunk[BRIDGE_CHUNK_SIZE];
+	uint8_t idleChunk[BRIDGE_CHUNK_SIZE];
+	uint8_t xmodemChunk[BRIDGE_CHUNK_SIZE];
+	uint8_t packedChunk[V42BIS_MAX_OUTPUT(BRIDGE_CHUNK_SIZE)];
+	ZRingBuffer<BRIDGE_RING_SIZE> uplink;	// DTE to network
+	ZRingBuffer<BRIDGE_RING_SIZE> downlink; // network to DTE
+	TaskHandle_t dteTaskHandle = nullptr;
+	TaskHandle_t netTaskHandle = nullptr;
+	EventGroupHandle_t bridgeEvents = nullptr;
+	std::atomic<bool> bridgeRunning{false};
+	std::atomic<bool> escapeDetected{false};
+	std::atomic<bool> forwardMark{false};
+	std::atomic<unsigned long> uplinkStamp{0};
+	unsigned long netWrites = 0;
+	std::atomic<bool> escTimerFired{false};
+	bool hwEscape = false;
+	esp_timer_handle_t escTimer = nullptr;
+	int64_t escArmedAt = 0;
+	int64_t escWait = 0;
+	int64_t lastDataAt = 0;
+	int bridgeSocketId = 0;
+	std::atomic<uint64_t> dteBusyTime{0};
+	std::atomic<uint64_t> netBusyTime{0};
+	int64_t bridgeUpTime = 0;
 	String termType;
-	String lastCommand;
+	ZCommandParser parser;
+	char cmdQueue[MAX_QUEUED_COMMANDS][MAX_COMMAND_SIZE + 1];
+	int queueHead = 0;
+	int queueCount = 0;
+	ZOperation operation = ZOP_NONE;
+	unsigned long opStarted = 0;
+	int opCount = 0;
+	bool opStream = false;
+	bool opSave = false;
+	String opModifiers;
+	String opSSID;
+	String opPSWD;
+	IPAddress *opIP[4] = {nullptr, nullptr, nullptr, nullptr};
+	unsigned long wifiStarted = 0;
+	ZClient *opClient = nullptr;	// dialed, TLS handshake still running
 	IPAddress *staticIP = nullptr;
 	IPAddress *staticDNS = nullptr;
 	IPAddress *staticGW = nullptr;
@@ -55,35 +158,124 @@ private:
 	unsigned long maxRateTx = 0;
 	unsigned long maxRateRx = 0;
 
-	bool processIAC(char *c);
 	void setStaticIPs(IPAddress *ip, IPAddress *dns, IPAddress *gateway, IPAddress *subnet);
+	bool beginWiFi(const char *ssid, const char *pswd, IPAddress *ip, IPAddress *dns, IPAddress *gateway, IPAddress *subnet);
+	ZResult pollWiFi();
 	bool connectWiFi(const char *ssid, const char *pswd, IPAddress *ip, IPAddress *dns, IPAddress *gateway, IPAddress *subnet);
+	void sendScanResults(int n);
 	bool readSerialStream();
-	void sendNewline();
+	void sendNewline(Print &out = Serial2);
+	ZResult sendReport(ZResult rc);
+	void flushReport();
+	ZResult pollReport();
 	void sendAnnouncement();
 	void sendConfiguration();
+	void reportProfile(ZProfile &p, uint8_t flags);
 	void sendResponse(ZResult rc);
 	void sendConnectionNotice(int id);
-	
-	int activeProfile();
-	void setActiveProfile(int num);
 
 	size_t socketWrite(uint8_t c);
 	size_t socketWrite(const uint8_t *buf, size_t size);
-	uint8_t socketRead(unsigned long tmout);
+
+	void dteTask();
+	void netTask();
+	bool pumpSerialRx();
+	bool pumpSerialRxPattern();
+	void checkEscapeTimer();
+	bool pumpSerialTx();
+	bool pumpSerialTxPacked(size_t room);
+	bool pumpSocketTx();
+	bool forwardReady();
+	void markUplink(const uint8_t *data, size_t len);
+	bool pumpSocketRx();
+	void xmodemRemote(const uint8_t *data, size_t len);
+	size_t xmodemWrite(const uint8_t *data, size_t len);
+	void xmodemDte(const uint8_t *data, size_t len);
+	int receiveClean(ZClient *client, uint8_t *buf, size_t size);
+	void drainBackground();
+	size_t clientWrite(ZClient *client, const uint8_t *buf, size_t size);
+	ZResult execGateway(ZGatewayProtocol protocol);
+	void tickGateway();
+	void tickMux();
+	void handleMuxFrame(const ZMuxFrame &frame);
+	void pollMuxDial();
+	void openMuxChannel(ZClient *client);
+	void closeMuxChannel(int index);
+	void pollListener();
+	void stopRinging();
+	ZResult answerCaller(ZClient *caller);
+	void bridgeStart();
+	void bridgeStop();
+
+	void applyModifiers(ZClient *client, const char *dmodifiers);
+	ZResult beginDial(const PBEntry &pbe, const char *dmodifiers, bool stream, bool save);
+	ZResult pollDial();
 
 	ZResult execCommand();
+	ZResult execQueuedCommand();
+	ZResult execCommandFrom(ZResult rc);
+	ZResult beginOperation(ZOperation op);
+	ZResult pollOperation();
+	void abortOperation();
+	void tickOperation();
+	void queueCommand();
+	void freeOperationIPs();
 	ZResult execInfo(int vval, uint8_t *vbuf, int vlen, bool isNumber);
+	ZResult execBenchmark();
 	ZResult execTime(int vval, uint8_t *vbuf, int vlen, bool isNumber);
 	ZResult execWiFi(int vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers);
 	ZResult execBaud(int vval, uint8_t *vbuf, int vlen);
 	ZResult execDial(unsigned long vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers);
 	ZResult execConnect(int vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers);
 	ZResult execHangup(int vval, uint8_t *vbuf, int vlen, bool isNumber);
+	ZResult execListen(int vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers);
+	ZResult execAnswer(int vval, uint8_t *vbuf, int vlen, bool isNumber);
 	ZResult execPhonebook(unsigned long vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers);
 	ZResult execSRegister(uint8_t *vbuf, int vlen);
 
+	// AT command handlers, see COMMANDS
+	ZResult atIgnore(const ZCommand &c, ZResult rc);
+	ZResult atAnswer(const ZCommand &c, ZResult rc);
+	ZResult atBaud(const ZCommand &c, ZResult rc);
+	ZResult atConnect(const ZCommand &c, ZResult rc);
+	ZResult atDial(const ZCommand &c, ZResult rc);
+	ZResult atEcho(const ZCommand &c, ZResult rc);
+	ZResult atHangup(const ZCommand &c, ZResult rc);
+	ZResult atInfo(const ZCommand &c, ZResult rc);
+	ZResult atVolume(const ZCommand &c, ZResult rc);
+	ZResult atSpeaker(const ZCommand &c, ZResult rc);
+	ZResult atListen(const ZCommand &c, ZResult rc);
+	ZResult atOnline(const ZCommand &c, ZResult rc);
+	ZResult atPhonebook(const ZCommand &c, ZResult rc);
+	ZResult atQuiet(const ZCommand &c, ZResult rc);
+	ZResult atRegister(const ZCommand &c, ZResult rc);
+	ZResult atVerbose(const ZCommand &c, ZResult rc);
+	ZResult atWiFi(const ZCommand &c, ZResult rc);
+	ZResult atLongSpace(const ZCommand &c, ZResult rc);
+	ZResult atReset(const ZCommand &c, ZResult rc);
+	ZResult atFlowControl(const ZCommand &c, ZResult rc);
+	ZResult atConfiguration(const ZCommand &c, ZResult rc);
+	ZResult atWriteProfile(const ZCommand &c, ZResult rc);
+	ZResult atFactory(const ZCommand &c, ZResult rc);
+	ZResult atActiveProfile(const ZCommand &c, ZResult rc);
+	ZResult atTime(const ZCommand &c, ZResult rc);
+	ZResult atCompression(const ZCommand &c, ZResult rc);
+	ZResult atConsole(const ZCommand &c, ZResult rc);
+	ZResult atShell(const ZCommand &c, ZResult rc);
+	ZResult atRestart(const ZCommand &c, ZResult rc);
+	ZResult atBench(const ZCommand &c, ZResult rc);
+	ZResult atMux(const ZCommand &c, ZResult rc);
+	ZResult atSlip(const ZCommand &c, ZResult rc);
+	ZResult atPpp(const ZCommand &c, ZResult rc);
+	ZResult atSSID(const ZCommand &c, ZResult rc);
+	ZResult atPassword(const ZCommand &c, ZResult rc);
+	ZResult atHostname(const ZCommand &c, ZResult rc);
+	ZResult atSerialBaud(const ZCommand &c, ZResult rc);
+	ZResult atXmodem(const ZCommand &c, ZResult rc);
+	ZResult atDma(const ZCommand &c, ZResult rc);
+
 	void switchTo(ZMode newMode, ZResult rc = ZIGNORE);
+	ZResult goOnline(ZResult rc);
 
 	static IPAddress *parseIP(const char *str);
 
@@ -106,10 +298,29 @@ public:
 		static unsigned long counterTx = 0;
 		static unsigned long counterRx = 0;
 
+		// an XON the TX FIFO had no room for; the DTE task does this in data mode
+		if (mode != ZSTREAM_MODE)
+		{
+			Serial2.pollHold();
+		}
+
 		switch (mode)
 		{
 		case ZCOMMAND_MODE:
-			if (Serial2.available() > 0 && readSerialStream())
+			if (operation != ZOP_NONE)
+			{
+				tickOperation();
+			}
+			else if (queueCount > 0)
+			{
+				// a type-ahead line, one being typed stays in buffer
+				ZResult rc = execQueuedCommand();
+				if (SREG.resultCodeEnabled())
+				{
+					sendResponse(rc);
+				}
+			}
+			else if (Serial2.available() > 0 && readSerialStream())
 			{
 				ZResult rc = execCommand();
 				if (SREG.resultCodeEnabled())
@@ -134,56 +345,13 @@ public:
 			}
 			break;
 		case ZSTREAM_MODE:
-			if (socket != nullptr && socket->connected())
+			if (escapeDetected)
 			{
-				// bridge data from DTE to network
-				while (Serial2.available() > 0)
-				{
-					// Tx stats
-					totalBytesTx++;
-					// read a char at time and process
-					char c = Serial2.read();
-					if (c != SREG[2] || (millis() - esc.gt1) < SREG.guardTime() || esc.len >= sizeof(esc.buf))
-					{
-						if (esc.len)
-						{
-							socketWrite(esc.buf, esc.len);
-							esc.len = 0;
-							esc.gt2 = 0;
-						}
-						socketWrite(c);
-						esc.gt1 = millis();
-					}
-					else
-					{
-						esc.buf[esc.len++] = c;
-						if (esc.len >= 3)
-						{
-							esc.gt2 = millis();
-						}
-					}
-				}
-				// check escape sequence
-				if (esc.gt2 && (millis() - esc.gt2) > SREG.guardTime())
-				{
-					esc.gt2 = 0;
-					esc.len = 0;
-					switchTo(ZCOMMAND_MODE, ZOK);
-				}
-				// bridge data from network to DTE
-				while (socket->available() > 0 && Serial2.availableForWrite() > 0)
-				{
-					// RX stats
-					totalBytesRx++;
-					// read char and process
-					char c = socket->read();
-					if ((!socket->telnetMode() || processIAC(&c)) && (!socket->petsciiMode() || asc2pet(&c)))
-						Serial2.write(c);
-					// if incoming data from serial interrupt for process them
-					if (Serial2.available() > 0)
-						break;
-				}
-				// update trasnfer rates
+				switchTo(ZCOMMAND_MODE, ZOK);
+			}
+			else if (socket != nullptr && (socket->connected() || socket->backlogLength() > 0 || !downlink.empty()))
+			{
+				// data is moved by the bridge tasks, update trasnfer rates
 				if ((millis() - rateTimer) > 1000)
 				{
 					unsigned long rate;
@@ -201,6 +369,7 @@ public:
 			else
 			{
 				// clean up resources
+				bridgeStop();
 				for (int i = 0; i < clients.size(); i++)
 				{
 					if (clients.get(i) == socket)
@@ -215,7 +384,11 @@ public:
 				switchTo(ZCOMMAND_MODE, ZNOCARRIER);
 			}
 			break;
-		case ZPRINT_MODE:
+		case ZGATEWAY_MODE:
+			tickGateway();
+			break;
+		case ZMUX_MODE:
+			tickMux();
 			break;
 		case ZSHELL_MODE:
 			if (Serial2.available() > 0 && readSerialStream())
@@ -233,6 +406,11 @@ public:
 			break;
 		}
 
+		pollListener();
+		if (mode != ZMUX_MODE)
+		{
+			drainBackground();
+		}
 		httpServer.handleClient();
 	}
 
@@ -0,0 +1,77 @@
+#ifndef ZMUX_H
+#define ZMUX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include "z/options.h"
+
+// Packet mode framing, all integers little endian:
+//   SOF | channel:2 | type:1 | length:2 | payload | crc16:2
+// The CRC (CCITT, init 0xFFFF) covers channel through payload.  Channel
+// numbers are connection ids, channel 0 carries control traffic.
+#define ZMUX_SOF            0xF9
+#define ZMUX_HEADER_SIZE    6
+#define ZMUX_TRAILER_SIZE   2
+
+#define ZMUX_DATA           0x00
+#define ZMUX_CREDIT         0x01    // payload: bytes:2 the sender may now receive
+#define ZMUX_OPEN           0x02    // DTE: "host:port" on channel 0, modem: reply on the new channel
+#define ZMUX_CLOSE          0x03
+#define ZMUX_EXIT           0x04    // back to command mode
+#define ZMUX_ERROR          0x05    // payload: what failed
+
+struct ZMuxFrame
+{
+    uint16_t channel;
+    uint8_t type;
+    uint16_t length;
+    uint8_t payload[ZMUX_MAX_PAYLOAD];
+};
+
+struct ZMuxStats
+{
+    unsigned long framesIn;
+    unsigned long framesOut;
+    unsigned long crcErrors;
+    unsigned long oversize;
+};
+
+class ZMux
+{
+private:
+    enum ParseState
+    {
+        HUNT,
+        HEADER,
+        PAYLOAD,
+        TRAILER
+    };
+
+    ParseState state = HUNT;
+    uint8_t header[ZMUX_HEADER_SIZE - 1];
+    uint8_t trailer[ZMUX_TRAILER_SIZE];
+    size_t pos = 0;
+    ZMuxFrame frame;
+    ZMuxStats stats = {};
+
+public:
+    // fills in what goes before and after the payload on the wire
+    static void wrap(uint8_t *head, uint8_t *tail, uint16_t channel, uint8_t type, const uint8_t *data, size_t len);
+
+    void reset();
+    size_t needed();
+    bool receive(const uint8_t *data, size_t len, size_t *used);
+#ifdef ARDUINO
+    bool receive(Stream &in);
+    size_t send(Print &out, uint16_t channel, uint8_t type, const uint8_t *data, size_t len);
+    size_t sendCredit(Print &out, uint16_t channel, uint16_t bytes);
+#endif
+
+    inline const ZMuxFrame &current() { return frame; }
+    inline const ZMuxStats &statistics() { return stats; }
+};
+
+#endif
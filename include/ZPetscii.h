@@ -0,0 +1,13 @@
+#ifndef ZPETSCII_H
+#define ZPETSCII_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ZPetscii
+{
+	void ascToPet(uint8_t *buf, size_t len);
+	void petToAsc(uint8_t *buf, size_t len);
+}
+
+#endif
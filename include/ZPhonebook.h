@@ -3,17 +3,39 @@
 
 #include <LinkedList.h>
 #include <stdint.h>
+#include <stddef.h>
 
 #define ZPHONEBOOK_PREFIX "/phonebook"
 
+#define ZPHONEBOOK_ENDPOINTS 4
+#define ZPHONEBOOK_SEPARATOR '|'
+#define ZPHONEBOOK_LATENCY_FAILED 0xFFFF
+
 struct PBEntry
 {
     unsigned long number;
     char address[50];
     char modifiers[15];
     char notes[128];
+    // entries saved before mirrors were supported end here
+    char alternates[ZPHONEBOOK_ENDPOINTS - 1][50];
+    uint16_t latency[ZPHONEBOOK_ENDPOINTS]; // last connect time in ms, 0 if never measured
+
+    inline char *endpoint(int index)
+    {
+        return index == 0 ? address : alternates[index - 1];
+    }
+
+    inline const char *endpoint(int index) const
+    {
+        return index == 0 ? address : alternates[index - 1];
+    }
+
+    int endpoints() const;
 };
 
+#define ZPHONEBOOK_LEGACY_SIZE offsetof(PBEntry, alternates)
+
 class ZPhonebook
 {
 private:
@@ -3,24 +3,53 @@
 
 #include <Arduino.h>
 #include "z/types.h"
+#include "z/options.h"
+#include "ZRegisters.h"
+#include "ZProfileStore.h"
 
 class ZProfile
 {
 private:
-    uint8_t regs[112];
+    uint8_t regs[ZREGISTER_SPACE];
+
+    // PROFILE_FILE as last read or written, AT&V and ATZ skip SPIFFS
+    static ZProfileImage image;
+    static bool imageLoaded;
+    // PROFILE_FILE is missing or bad and PROFILE_TEMP_FILE is the last good copy
+    static bool tempOnly;
+
+    static void loadImage();
+    static bool readImage(const char *path);
+    static bool writeImage();
+    static void migrateJson();
+    void loadRegister(int index, int value);
 
 public:
     char hostname[64];
     char wifiSSID[32];
     char wifiPSWD[64];
     int baudRate;
+    int listenPort;
 
     ZProfile();
     ~ZProfile();
 
+    void loadDefaults();
     void loadProfile(int num);
     void saveProfile(int num);
 
+    static int activeProfile();
+    static void setActiveProfile(int num);
+
+    // ATSn=v, false for unknown or read-only registers and invalid values
+    bool setRegister(int index, int value);
+
+    static inline const ZRegister *registerInfo(int index)
+    {
+        int slot = zregisterSlot(index);
+        return slot < 0 ? nullptr : &ZREGISTERS[slot];
+    }
+
     uint8_t &operator[](int index)
     {
         return regs[index];
@@ -116,6 +145,115 @@ public:
         regs[39] |= mode;
     }
 
+    inline bool uartEventsEnabled()
+    {
+        return (regs[50] & 0x01);
+    }
+
+    inline void setUartEventsEnabled(bool enabled)
+    {
+        if (enabled)
+            regs[50] |= 0x01;
+        else
+            regs[50] &= ~0x01;
+    }
+
+    inline bool hwEscapeEnabled()
+    {
+        return (regs[50] & 0x02);
+    }
+
+    inline void setHwEscapeEnabled(bool enabled)
+    {
+        if (enabled)
+            regs[50] |= 0x02;
+        else
+            regs[50] &= ~0x02;
+    }
+
+    inline bool mccpEnabled()
+    {
+        return (regs[50] & 0x04);
+    }
+
+    inline void setMccpEnabled(bool enabled)
+    {
+        if (enabled)
+            regs[50] |= 0x04;
+        else
+            regs[50] &= ~0x04;
+    }
+
+    inline bool uartDmaEnabled()
+    {
+        return (regs[50] & 0x08);
+    }
+
+    inline void setUartDmaEnabled(bool enabled)
+    {
+        if (enabled)
+            regs[50] |= 0x08;
+        else
+            regs[50] &= ~0x08;
+    }
+
+    inline bool compressionEnabled()
+    {
+        return (regs[50] & 0x10);
+    }
+
+    inline void setCompressionEnabled(bool enabled)
+    {
+        if (enabled)
+            regs[50] |= 0x10;
+        else
+            regs[50] &= ~0x10;
+    }
+
+    inline bool xmodemSpoofing()
+    {
+        return (regs[50] & 0x20);
+    }
+
+    inline void setXmodemSpoofing(bool enabled)
+    {
+        if (enabled)
+            regs[50] |= 0x20;
+        else
+            regs[50] &= ~0x20;
+    }
+
+    // X.3 style packet forwarding: size threshold, idle timer, forwarding char
+    inline bool forwardingEnabled()
+    {
+        return regs[51] || regs[52] || regs[53];
+    }
+
+    inline size_t forwardSize()
+    {
+        return regs[51] * 16;   // in 16-byte units
+    }
+
+    inline unsigned long forwardIdle()
+    {
+        return (regs[52] ? regs[52] : 1) * 50;   // in twentieths of a second
+    }
+
+    inline char forwardChar()
+    {
+        return char(regs[53]);
+    }
+
+    inline uint8_t autoAnswerRings()
+    {
+        return regs[0];
+    }
+
+    inline uint8_t backlogPolicy()
+    {
+        return regs[54];
+    }
+
     inline int speakerVolume()
     {
         return regs[22] & 0x03;
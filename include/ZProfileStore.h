@@ -0,0 +1,57 @@
+#ifndef ZPROFILESTORE_H
+#define ZPROFILESTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "z/options.h"
+#include "ZRegisters.h"
+
+// All user profiles and the active index in one fixed-layout blob.  Boot
+// reads it with a single open; AT&W and AT&Y write it to PROFILE_TEMP_FILE
+// and rename it over PROFILE_FILE.  Anything with the wrong magic, version,
+// size or CRC32 is ignored.
+#define PROFILE_FILE        "/profiles.bin"
+#define PROFILE_TEMP_FILE   "/profiles.tmp"
+#define PROFILE_MAGIC       0x4650525A  // "ZRPF"
+#define PROFILE_VERSION     1
+
+struct ZProfileRecord
+{
+    uint8_t used;
+    uint8_t reserved[3];
+    int32_t baudRate;
+    int32_t listenPort;
+    char hostname[64];
+    char wifiSSID[32];
+    char wifiPSWD[64];
+    uint8_t regs[ZREGISTER_SPACE];
+};
+
+struct ZProfileImage
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    int8_t active;
+    uint8_t count;
+    uint8_t reserved[2];
+    ZProfileRecord profiles[MAX_USER_PROFILES];
+    uint32_t crc;           // CRC-32 of everything above
+};
+
+class ZProfileStore
+{
+public:
+    static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+    static void clear(ZProfileImage &image);
+    static void seal(ZProfileImage &image);
+    static bool valid(const ZProfileImage &image);
+
+    // One /profile/<n> JSON file from before the image, registers either as
+    // the dense "regs" array or the sparse "sregs" object.  rec is left
+    // alone when the text does not parse.
+    static bool fromJson(ZProfileRecord &rec, const char *json, size_t len);
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef ZREGISTERS_H
+#define ZREGISTERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "z/types.h"
+
+#define ZREGISTER_SPACE 112
+
+#define ZREG_PERSIST    0x01    // saved with AT&W when it differs from the default
+#define ZREG_LISTED     0x02    // shown as Snn:vvv by AT&V
+#define ZREG_READONLY   0x04    // status kept by the modem, ATSn= is refused
+
+struct ZRegister
+{
+    uint8_t index;
+    uint8_t defaultValue;
+    uint8_t minValue;
+    uint8_t maxValue;
+    uint8_t mask;               // bits ATSn= may set, 0xFF for plain values
+    uint8_t flags;
+};
+
+// Every S-register the firmware knows, in index order.  Defaults, ATSn=
+// validation, the AT&V listing and what AT&W stores all come from here;
+// registers missing from the table do not exist.
+constexpr ZRegister ZREGISTERS[] = {
+    {0, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},           // rings to auto-answer
+    {1, 0, 0, 255, 0xFF, ZREG_READONLY | ZREG_LISTED},          // ring count
+    {2, '+', 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},         // escape character
+    {3, '\r', 0, 127, 0xFF, ZREG_PERSIST | ZREG_LISTED},        // carriage return
+    {4, '\n', 0, 127, 0xFF, ZREG_PERSIST | ZREG_LISTED},        // line feed
+    {5, '\b', 0, 127, 0xFF, ZREG_PERSIST | ZREG_LISTED},        // backspace
+    {6, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},           // dial tone wait
+    {7, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},           // carrier wait
+    {8, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},           // comma pause
+    {9, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},           // carrier detect time
+    {10, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // carrier loss time
+    {11, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // DTMF duration
+    {12, 50, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},         // escape guard time, 1/50 s
+    {14, 0x0A, 0, 255, 0x0E, ZREG_PERSIST},                     // E Q V, see AT&V flags
+    {18, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // test timer
+    {22, 0, 0, 255, 0x0F, ZREG_PERSIST},                        // L M, see AT&V flags
+    {25, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // DTR delay
+    {26, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // RTS to CTS delay
+    {32, ASCII_XON, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},  // XON character
+    {33, ASCII_XOFF, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED}, // XOFF character
+    {36, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},
+    {37, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},
+    {38, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},
+    {39, 0, 0, FCM_INVALID - 1, 0x07, ZREG_PERSIST},           // &K flow control
+    {40, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},
+    {41, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},
+    {46, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},
+    {48, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},
+    {50, 0, 0, 255, 0x3F, ZREG_PERSIST | ZREG_LISTED},          // feature bits, see ZProfile
+    {51, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // forward after n*16 bytes
+    {52, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // forward after n/20 s idle
+    {53, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // forward on character
+    {54, 0, 0, 2, 0xFF, ZREG_PERSIST | ZREG_LISTED},            // socket backlog policy
+    {95, 0, 0, 255, 0xFF, ZREG_PERSIST | ZREG_LISTED},          // extended result codes
+};
+
+constexpr size_t ZREGISTER_COUNT = sizeof(ZREGISTERS) / sizeof(ZREGISTERS[0]);
+
+constexpr bool zregistersValid(size_t k = 0)
+{
+    return k >= ZREGISTER_COUNT ||
+           ((k == 0 || ZREGISTERS[k - 1].index < ZREGISTERS[k].index) &&
+            ZREGISTERS[k].index < ZREGISTER_SPACE &&
+            ZREGISTERS[k].minValue <= ZREGISTERS[k].defaultValue &&
+            ZREGISTERS[k].defaultValue <= ZREGISTERS[k].maxValue &&
+            (ZREGISTERS[k].defaultValue & ~ZREGISTERS[k].mask) == 0 &&
+            zregistersValid(k + 1));
+}
+
+static_assert(zregistersValid(), "ZREGISTERS must be in index order with defaults inside range and mask");
+
+// position of register index in ZREGISTERS, or -1
+constexpr int zregisterSlot(int index, size_t k = 0)
+{
+    return k >= ZREGISTER_COUNT ? -1 : ZREGISTERS[k].index == index ? (int)k : zregisterSlot(index, k + 1);
+}
+
+#endif
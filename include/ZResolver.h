@@ -0,0 +1,65 @@
+#ifndef ZRESOLVER_H
+#define ZRESOLVER_H
+
+#include <IPAddress.h>
+#include <lwip/ip_addr.h>
+#include "z/options.h"
+
+#define ZRESOLVER_EMPTY     0
+#define ZRESOLVER_PENDING   1
+#define ZRESOLVER_RESOLVED  2
+#define ZRESOLVER_FAILED    3
+
+struct ZResolverEntry
+{
+    char host[DNS_CACHE_HOST_SIZE];
+    uint32_t addr;
+    volatile uint8_t state;
+    unsigned long stamp;    // when the answer arrived
+    unsigned long used;     // last lookup, for eviction
+    unsigned long requested;
+    bool waiting;           // a lookup missed and is waiting for this answer
+    unsigned long hits;
+};
+
+// Hostname cache in front of lwIP's resolver.  Queries are started in the
+// tcpip thread and complete through dns_gethostbyname callbacks, so names
+// can be prefetched without blocking the caller.
+class ZResolver
+{
+private:
+    ZResolverEntry entries[DNS_CACHE_SIZE];
+    unsigned long m_hits;
+    unsigned long m_misses;
+    unsigned long m_failures;
+    unsigned long m_waitTime;
+
+    static void callbackStart(void *arg);
+    static void callbackFound(const char *name, const ip_addr_t *ipaddr, void *arg);
+
+    ZResolverEntry *find(const char *host);
+    ZResolverEntry *allocate(const char *host);
+    bool start(ZResolverEntry *e);
+    bool expired(ZResolverEntry *e);
+
+public:
+    ZResolver();
+
+    int query(const char *host, IPAddress &addr);
+    bool resolve(const char *host, IPAddress &addr, unsigned long timeout = DNS_RESOLVE_TIMEOUT);
+    void prefetch(const char *host);
+    void prefetchPhonebook();
+    void flush();
+
+    inline int size() { return DNS_CACHE_SIZE; }
+    inline ZResolverEntry &entry(int index) { return entries[index]; }
+    unsigned long timeToLive(ZResolverEntry &e);
+    inline unsigned long hits() { return m_hits; }
+    inline unsigned long misses() { return m_misses; }
+    inline unsigned long failures() { return m_failures; }
+    inline unsigned long waitTime() { return m_waitTime; }
+};
+
+extern ZResolver Resolver;
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef ZRINGBUFFER_H
+#define ZRINGBUFFER_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Lock-free single-producer/single-consumer byte ring.
+// Exactly one task may call write() and exactly one task may call read();
+// clear() is only safe while both sides are parked.
+template <size_t N>
+class ZRingBuffer
+{
+    static_assert((N & (N - 1)) == 0, "ring size must be a power of two");
+
+private:
+    uint8_t buf[N];
+    std::atomic<size_t> head; // advanced by the producer
+    std::atomic<size_t> tail; // advanced by the consumer
+    size_t highWater;
+
+public:
+    ZRingBuffer() : head(0), tail(0), highWater(0) {}
+
+    inline size_t capacity() const { return N; }
+    inline size_t used() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    inline size_t space() const { return N - used(); }
+    inline bool empty() const { return used() == 0; }
+    inline size_t highWaterMark() const { return highWater; }
+    inline void resetHighWaterMark() { highWater = used(); }
+
+    size_t write(const uint8_t *data, size_t len)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+        size_t n = N - (h - t);
+        if (len < n)
+            n = len;
+        size_t off = h & (N - 1);
+        size_t first = (N - off) < n ? (N - off) : n;
+        memcpy(buf + off, data, first);
+        memcpy(buf, data + first, n - first);
+        head.store(h + n, std::memory_order_release);
+        if ((h + n - t) > highWater)
+            highWater = h + n - t;
+        return n;
+    }
+
+    // copies without consuming, skip() then drops what was actually used
+    size_t peek(uint8_t *data, size_t len) const
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        size_t n = h - t;
+        if (len < n)
+            n = len;
+        size_t off = t & (N - 1);
+        size_t first = (N - off) < n ? (N - off) : n;
+        memcpy(data, buf + off, first);
+        memcpy(data + first, buf, n - first);
+        return n;
+    }
+
+    void skip(size_t len)
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + len, std::memory_order_release);
+    }
+
+    size_t read(uint8_t *data, size_t len)
+    {
+        size_t n = peek(data, len);
+        skip(n);
+        return n;
+    }
+
+    void clear()
+    {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+        highWater = 0;
+    }
+};
+
+#endif
@@ -3,24 +3,108 @@
 
 #include <HardwareSerial.h>
 #include <Arduino.h>
+#include "driver/uart.h"
 #include "z/types.h"
+#include "z/options.h"
+#include "ZUartDma.h"
+
+struct ZSerialStats
+{
+    unsigned long fifoOverflows;
+    unsigned long bufferFull;
+    unsigned long breaks;
+    unsigned long frameErrors;
+    unsigned long parityErrors;
+    unsigned long patterns;
+};
+
+struct ZSerialBench
+{
+    unsigned long baud;
+    size_t sent;
+    size_t received;
+    size_t gaps;        // places where the sequence skipped
+    unsigned long micros;
+};
 
 class ZSerial : public HardwareSerial
 {
 private:
     unsigned long lastActivity;
+    bool dataLed = false;
+    bool eventMode = false;
+    QueueHandle_t eventQueue = nullptr;
+    size_t rxBufferSize = ZSERIAL_RX_BUFFER_SIZE;
+    size_t txBufferSize = 0;
+    ZSerialStats stats = {};
+    unsigned long patternIdle = 0;
+    bool patternFull = false;
+    FlowControlMode flowMode = FCM_DISABLED;
+    uint8_t flowThreshold = FLOW_CTRL_RX_THRESH;
+    bool rxHeld = false;        // what the DTE was last told
+    bool rxHoldWanted = false;
+    ZUartDma dma;
+    bool dmaMode = false;
+
+    static void IRAM_ATTR callbackDmaData(void *arg)
+    {
+        reinterpret_cast<ZSerial *>(arg)->wakeFromISR();
+    }
+
+    bool installDriver();
+    void countEvent(const uart_event_t &event);
+    void sizeBuffers(unsigned long baud);
+    bool resizeDriver(unsigned long baud);
+    inline void setDataLed(bool on)
+    {
+        if (on != dataLed)
+        {
+            dataLed = on;
+            digitalWrite(PIN_LED_DATA, on ? HIGH : LOW);
+        }
+    }
 
 public:
     using HardwareSerial::HardwareSerial;   // Inheriting constructors
 
     void begin(unsigned long baud, uint32_t config=SERIAL_8N1, int8_t rxPin=-1, int8_t txPin=-1, bool invert=false, unsigned long timeout_ms = 20000UL);
+    using HardwareSerial::read;
     int available();
+    int read();
+    size_t read(uint8_t *buffer, size_t size);
+    int peek();
     size_t write(uint8_t c);
     size_t write(const uint8_t *buffer, size_t size);
 
     void setFlowControl(FlowControlMode mode);
+    void holdReceive(bool hold);
+    void pollHold();
+    inline bool receiveHeld() { return rxHeld; }
+    inline size_t rxBufferCapacity() { return rxBufferSize; }
+    inline size_t txBufferCapacity() { return txBufferSize; }
+    inline uint8_t flowControlThreshold() { return flowThreshold; }
+
+    bool setEventMode(bool enabled);
+    bool waitForEvent(TickType_t timeout);
+    void pollEvents();
+    void wake();
+    void IRAM_ATTR wakeFromISR();
+
+    bool setDmaMode(bool enabled);
+    inline bool dmaEnabled() { return dma.running(); }
+    inline const ZUartDmaStats &dmaStatistics() { return dma.statistics(); }
+    ZSerialBench loopbackTest(unsigned long baud, size_t total);
+    inline bool eventsEnabled() { return eventMode && eventQueue != nullptr; }
+
+    bool enablePatternDetect(char c, unsigned long guardTime);
+    void disablePatternDetect();
+    inline int patternPosition() { return uart_pattern_get_pos(UART_NUM_2); }
+    inline void popPattern() { uart_pattern_pop_pos(UART_NUM_2); }
+    inline unsigned long patternIdleTime() { return patternIdle; }
+    inline bool patternCoversGuard() { return patternFull; }
+    inline const ZSerialStats &statistics() { return stats; }
 };
 
 extern ZSerial Serial2;
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,109 @@
+#ifndef ZTELNET_H
+#define ZTELNET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELNET_BINARY 0
+#define TELNET_ECHO 1
+#define TELNET_LOGOUT 18
+#define TELNET_SUPRESS_GO_AHEAD 3
+#define TELNET_TERMTYPE 24
+#define TELNET_NAWS 31
+#define TELNET_TOGGLE_FLOW_CONTROL 33
+#define TELNET_LINEMODE 34
+#define TELNET_MSDP 69
+#define TELNET_MSSP 70
+#define TELNET_COMPRESS 85
+#define TELNET_COMPRESS2 86
+#define TELNET_MSP 90
+#define TELNET_MXP 91
+#define TELNET_AARD 102
+#define TELNET_ATCP 200
+#define TELNET_GMCP 201
+#define TELNET_SE 240
+#define TELNET_AYT 246
+#define TELNET_EC 247
+#define TELNET_GA 249
+#define TELNET_SB 250
+#define TELNET_WILL 251
+#define TELNET_WONT 252
+#define TELNET_DO 253
+#define TELNET_DONT 254
+#define TELNET_NOP 241
+#define TELNET_IAC 255
+
+#define TELNET_TTYPE_IS 0
+#define TELNET_TTYPE_SEND 1
+
+#define ZTELNET_REPLY_SIZE 64
+#define ZTELNET_SB_SIZE 16
+#define ZTELNET_TX_SCRATCH 128
+#define ZTELNET_TX_DIRECT 32
+
+// Writes to the connection and returns how much of data it took
+typedef size_t (*ZTelnetOutput)(void *arg, const uint8_t *data, size_t len);
+
+// Resumable telnet receiver: consumes arbitrary slices of the incoming
+// stream, strips the commands in place and queues the option replies.
+// send() escapes outgoing data through the output callback.
+class ZTelnet
+{
+private:
+    enum State
+    {
+        TS_DATA,
+        TS_IAC,
+        TS_OPTION,
+        TS_SB,
+        TS_SB_DATA,
+        TS_SB_IAC
+    } state;
+    uint8_t verb;
+    uint8_t sbOption;
+    uint8_t sbBuf[ZTELNET_SB_SIZE];
+    size_t sbLen;
+    uint8_t reply[ZTELNET_REPLY_SIZE];
+    size_t replyLen;
+    const char *termType;
+    bool compress;
+    bool compressStart;
+    uint8_t scratch[ZTELNET_TX_SCRATCH];
+    size_t scratchLen;
+    ZTelnetOutput output;
+    void *outputArg;
+
+    static size_t cleanSpan(const uint8_t *buf, size_t len);
+    void queue(const uint8_t *data, size_t len);
+    void negotiate(uint8_t option);
+    void subnegotiate();
+
+public:
+    ZTelnet();
+
+    void reset();
+    size_t receive(uint8_t *buf, size_t len, size_t *used = nullptr);
+    size_t send(const uint8_t *buf, size_t len);
+    bool flush();
+
+    inline void setOutput(ZTelnetOutput out, void *arg)
+    {
+        output = out;
+        outputArg = arg;
+    }
+    inline size_t pending() { return scratchLen; }
+
+    inline void setTermType(const char *name) { termType = name; }
+    inline void setCompression(bool enabled) { compress = enabled; }
+    inline bool compressionStarted()
+    {
+        bool started = compressStart;
+        compressStart = false;
+        return started;
+    }
+    inline const uint8_t *replyData() { return reply; }
+    inline size_t replyLength() { return replyLen; }
+    inline void clearReply() { replyLen = 0; }
+};
+
+#endif
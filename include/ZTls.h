@@ -0,0 +1,105 @@
+#ifndef ZTLS_H
+#define ZTLS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <mbedtls/ssl.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include "z/options.h"
+
+#define ZTLS_PENDING    0
+#define ZTLS_DONE       1
+#define ZTLS_FAILED     -1
+
+struct ZTlsSession
+{
+    char host[DNS_CACHE_HOST_SIZE];
+    uint16_t port;
+    bool valid;
+    unsigned long used;
+    mbedtls_ssl_session session;
+};
+
+// Sessions from finished handshakes, offered again on the next connect to
+// the same host:port so the server can resume them (session ID or ticket).
+class ZTlsSessionCache
+{
+private:
+    ZTlsSession entries[TLS_SESSION_CACHE_SIZE];
+    unsigned long m_handshakes;
+    unsigned long m_resumed;
+
+public:
+    ZTlsSessionCache();
+
+    const mbedtls_ssl_session *find(const char *host, uint16_t port);
+    void store(const char *host, uint16_t port, const mbedtls_ssl_context *ssl, bool resumed);
+    void flush();
+
+    inline unsigned long handshakes() { return m_handshakes; }
+    inline unsigned long resumed() { return m_resumed; }
+};
+
+extern ZTlsSessionCache TlsSessions;
+
+// Client side TLS on a socket that is already connected.  The socket is
+// switched to non-blocking and the handshake is stepped from poll(), so
+// it can run as the tail end of a resumable dial.
+class ZTls
+{
+private:
+    enum State
+    {
+        HANDSHAKE,
+        OPEN,
+        CLOSED
+    };
+
+    static mbedtls_ssl_config conf;
+    static mbedtls_entropy_context entropy;
+    static mbedtls_ctr_drbg_context drbg;
+    static bool configured;
+
+    static bool configure();
+    static int callbackSend(void *ctx, const unsigned char *buf, size_t len);
+    static int callbackRecv(void *ctx, unsigned char *buf, size_t len);
+
+    mbedtls_ssl_context ssl;
+    std::atomic<State> state{CLOSED};
+    int m_fd = -1;
+    char m_host[DNS_CACHE_HOST_SIZE];
+    uint16_t m_port = 0;
+    int m_peek = -1;
+    bool m_resumed = false;
+    unsigned long m_started = 0;
+    unsigned long m_handshakeTime = 0;
+    size_t m_unsent = 0;                // record mbedtls wants offered again
+    std::atomic<int> m_buffered{0};     // decrypted bytes left after the last read
+
+    int send(const unsigned char *buf, size_t len);
+    int recv(unsigned char *buf, size_t len);
+    void fail(int ret);
+    void updateBuffered();
+
+public:
+    ZTls();
+    ~ZTls();
+
+    bool begin(int fd, const char *host, uint16_t port);
+    int poll();
+    int available();
+    int read(uint8_t *buf, size_t size);
+    int peek();
+    size_t write(const uint8_t *buf, size_t size);
+    void close();
+
+    // safe from any task, unlike everything that touches the SSL context
+    inline bool open() { return state == OPEN; }
+    inline int buffered() { return m_buffered; }
+    inline bool resumed() { return m_resumed; }
+    inline unsigned long handshakeTime() { return m_handshakeTime; }
+    inline const char *cipher() { return mbedtls_ssl_get_ciphersuite(&ssl); }
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef ZUARTDMA_H
+#define ZUARTDMA_H
+
+#include <Arduino.h>
+#include <esp32/rom/lldesc.h>
+#include <esp_intr_alloc.h>
+#include "z/options.h"
+
+struct ZUartDmaStats
+{
+    unsigned long bytes;
+    unsigned long blocks;       // descriptors handed back to the DMA
+    unsigned long overruns;     // DMA ran into a descriptor we still held
+};
+
+// UHCI0 receive path for UART2.  The DMA engine fills a ring of
+// descriptors straight from the UART FIFO and closes a block whenever the
+// line goes idle, so there is one interrupt per burst instead of one per
+// FIFO threshold.  Transmit stays on the regular driver.
+class ZUartDma
+{
+private:
+    lldesc_t *descs = nullptr;
+    uint8_t *blocks = nullptr;
+    intr_handle_t intr = nullptr;
+    bool enabled = false;       // UHCI0 clocked and owning the UART FIFO
+    int readDesc = 0;
+    size_t readOffset = 0;
+    volatile bool overrun = false;
+    void (*notify)(void *) = nullptr;
+    void *notifyArg = nullptr;
+    ZUartDmaStats stats = {};
+
+    static void IRAM_ATTR isr(void *arg);
+    void recycle(lldesc_t *d);
+
+public:
+    ~ZUartDma();
+
+    bool begin(void (*onData)(void *) = nullptr, void *arg = nullptr);
+    void end();
+    inline bool running() { return descs != nullptr; }
+
+    size_t available();
+    size_t read(uint8_t *buf, size_t len);
+    int read();
+    int peek();
+
+    inline const ZUartDmaStats &statistics() { return stats; }
+};
+
+#endif
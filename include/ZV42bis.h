@@ -0,0 +1,98 @@
+#ifndef ZV42BIS_H
+#define ZV42BIS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "z/options.h"
+
+// V.42bis (BTLZ) compressed-mode codewords: 0-2 are control codes, 3-258
+// the single characters and the rest dictionary strings.  Codewords are
+// packed least significant bit first and grow from 9 bits by STEPUP.
+#define V42BIS_ETM          0
+#define V42BIS_FLUSH        1
+#define V42BIS_STEPUP       2
+#define V42BIS_N6           3
+#define V42BIS_N5           (V42BIS_N6 + 256)
+
+// Worst case output of encode() for len input bytes, including a flush
+#define V42BIS_MAX_OUTPUT(len) ((len) + (len) / 2 + 8)
+
+// Dictionary shared by both directions.  Leaves are recycled in codeword
+// order once it is full, as in V.42bis 6.5, so encoder and decoder stay
+// in step without exchanging anything but codewords.
+class ZV42bisDictionary
+{
+protected:
+    struct Tables
+    {
+        uint16_t parent[V42BIS_DICT_SIZE];
+        uint16_t child[V42BIS_DICT_SIZE];
+        uint16_t sibling[V42BIS_DICT_SIZE];
+        uint8_t symbol[V42BIS_DICT_SIZE];
+    };
+
+    Tables *t = nullptr;
+    uint16_t next;
+    bool full;
+    uint8_t bits;
+    uint16_t threshold;
+
+    void clear();
+    uint16_t find(uint16_t node, uint8_t c);
+    uint16_t slot(uint16_t parent);
+    void add(uint16_t parent, uint8_t c);
+
+public:
+    ~ZV42bisDictionary();
+
+    bool begin();
+    void end();
+};
+
+class ZV42bisEncoder : public ZV42bisDictionary
+{
+private:
+    uint16_t code;
+    uint8_t length;
+    uint32_t acc;
+    uint8_t accBits;
+    uint8_t *out;
+
+    void put(uint16_t value, uint8_t n);
+    void emit(uint16_t value);
+
+public:
+    bool begin();
+    void reset();
+    size_t encode(const uint8_t *data, size_t len, uint8_t *output);
+    size_t flush(uint8_t *output);
+    size_t finish(uint8_t *output);
+
+    inline bool pending() { return code != 0 || accBits > 0; }
+};
+
+class ZV42bisDecoder : public ZV42bisDictionary
+{
+private:
+    uint16_t prev;
+    uint8_t prevLength;
+    uint8_t prevFirst;
+    uint32_t acc;
+    uint8_t accBits;
+    bool failed;
+    bool ended;
+
+    size_t expand(uint16_t node, uint8_t *output);
+
+public:
+    bool begin();
+    void reset();
+    // output needs room for V42BIS_MAX_STRING bytes per input byte; used
+    // tells how much input was taken, which is less after an ETM
+    size_t decode(const uint8_t *data, size_t len, uint8_t *output, size_t *used = nullptr);
+
+    inline bool error() { return failed; }
+    inline bool transparent() { return ended; }
+};
+
+#endif
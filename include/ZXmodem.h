@@ -0,0 +1,96 @@
+#ifndef ZXMODEM_H
+#define ZXMODEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "z/options.h"
+
+#define XMODEM_SOH  0x01
+#define XMODEM_STX  0x02
+#define XMODEM_EOT  0x04
+#define XMODEM_ACK  0x06
+#define XMODEM_NAK  0x15
+#define XMODEM_CAN  0x18
+#define XMODEM_CRC  'C'
+
+#define XMODEM_MAX_BLOCK (3 + 1024 + 2)
+
+typedef void (*ZXmodemOutput)(void *arg, const uint8_t *data, size_t len);
+
+struct ZXmodemStats
+{
+    unsigned long transfers;
+    unsigned long blocks;       // ACKed to the DTE ahead of the remote end
+    unsigned long localNaks;    // bad blocks refused without a round trip
+    unsigned long resent;       // blocks sent again after a NAK or timeout
+    unsigned long cancels;
+};
+
+// Accelerates XMODEM/YMODEM uploads through the bridge.  Once the remote
+// receiver has asked for block 1 (NAK or 'C') and the DTE sent it intact,
+// blocks are checked here, ACKed to the DTE straight away and streamed to
+// the remote end with up to XMODEM_WINDOW of them unacknowledged.  Remote
+// NAKs and timeouts resend everything outstanding (go-back-N), EOT is held
+// back until the window has drained and CAN from either side ends it.
+// YMODEM header blocks (block 0) pass through untouched.
+//
+// Both directions are fed from the NET task; output goes through the two
+// callbacks, toRemote for the socket and toDte for the downlink.
+class ZXmodem
+{
+private:
+    enum State
+    {
+        IDLE,       // plain bridge, watching for a transfer to start
+        ACTIVE,     // spoofing ACKs
+        DRAINING    // DTE sent EOT, waiting for the window to empty
+    };
+
+    State state = IDLE;
+    ZXmodemOutput toRemote = nullptr;
+    ZXmodemOutput toDte = nullptr;
+    void *arg = nullptr;
+    uint8_t *window = nullptr;          // XMODEM_WINDOW blocks of XMODEM_MAX_BLOCK
+    size_t sizes[XMODEM_WINDOW];
+    int head = 0;
+    int count = 0;
+    uint8_t block[XMODEM_MAX_BLOCK];    // block being received from the DTE
+    size_t blockLen = 0;
+    size_t blockSize = 0;
+    bool crc = false;
+    uint8_t lastBlock = 0;
+    uint8_t lastRemote = 0;
+    bool remoteAcked = false;           // NAKs before the first ACK are start retries
+    bool ackOwed = false;
+    int retries = 0;
+    unsigned long lastDteByte = 0;
+    unsigned long lastRemoteReply = 0;
+    ZXmodemStats stats = {};
+
+    bool verify(const uint8_t *data, size_t len);
+    void blockReceived();
+    void queue();
+    void resend();
+    void acknowledged();
+    void cancel();
+    void finish();
+    void passBlock();
+    void reply(uint8_t c);
+    void dte(uint8_t c);
+
+public:
+    ~ZXmodem();
+
+    bool begin(ZXmodemOutput toRemote, ZXmodemOutput toDte, void *arg);
+    void end();
+    void reset();
+    size_t fromDte(const uint8_t *data, size_t len);
+    size_t fromRemote(uint8_t *data, size_t len);
+    void poll();
+
+    inline bool enabled() { return window != nullptr; }
+    inline bool active() { return state != IDLE || blockLen > 0; }
+    inline const ZXmodemStats &statistics() { return stats; }
+};
+
+#endif
@@ -12,16 +12,76 @@
 #define PIN_DSR GPIO_NUM_12
 #define PIN_DTR GPIO_NUM_27
 #define PIN_BUZZER GPIO_NUM_21
+#define PIN_TXD GPIO_NUM_17
 
 #define DEFAULT_BAUD_RATE 1200
 #define DEFAULT_HS_RATE 38400
 #define DEFAULT_SERIAL_CONFIG SERIAL_8N1
 #define DEFAULT_TERMTYPE "ZTerm"
-#define FLOW_CTRL_RX_THRESH 122
-#define FLOW_CTRL_RX_THRESH_XON 50
-#define FLOW_CTRL_RX_THRESH_XOFF 200
+#define FLOW_CTRL_RX_THRESH 122     // FIFO level, lowered at high rates
+#define FLOW_CTRL_RX_THRESH_MIN 64
+#define FLOW_CTRL_REACTION_US 500   // time for the DTE to stop after RTS/XOFF
+#define FLOW_HOLD_PERCENT 75        // uplink occupancy that holds the DTE
+#define FLOW_RELEASE_PERCENT 25
+#define FLOW_STALL_MS 20            // socket writes slower than this are stalls
 #define ESCAPE_BUF_LEN 10
+#define BRIDGE_CHUNK_SIZE 512
+#define BRIDGE_RING_SIZE 4096
+#define BRIDGE_TASK_STACK 4096
+#define BRIDGE_TASK_PRIORITY 2
+#define BRIDGE_DTE_CORE 1
+#define BRIDGE_NET_CORE 0
+#define BRIDGE_IDLE_WAIT_MS 10
+#define BRIDGE_STOP_WAIT_MS 1000   // longest bridgeStop() waits for the tasks to park
+#define ZSERIAL_RX_BUFFER_SIZE 256   // smallest driver buffer
+#define ZSERIAL_MAX_BUFFER_SIZE 8192
+#define ZSERIAL_BUFFER_MS 100        // driver buffers hold this much traffic
+#define ZSERIAL_DMA_BLOCKS 8
+#define ZSERIAL_DMA_BLOCK_SIZE 2048  // lldesc size field is 12 bits
+#define ZSERIAL_BENCH_BYTES 65536
+#define ZSERIAL_EVENT_QUEUE_LEN 20
+#define ZSERIAL_PATTERN_QUEUE_LEN 8
+#define ZCLIENT_BACKLOG_SIZE 4096
+#define ZCLIENT_BACKLOG_PSRAM_SIZE 65536
 #define BUZZER_CHANNEL 0
 #define MAX_USER_PROFILES 3
+#define MAX_PENDING_CALLERS 4
+#define LISTEN_BACKLOG 4
+#define LISTEN_BUSY_BANNER "BUSY\r\n"
+#define RING_INTERVAL 6000
+#define RING_PULSE 2000
+#define RI_ACTIVE LOW
+#define DNS_CACHE_SIZE 16
+#define DNS_CACHE_HOST_SIZE 64
+#define DNS_CACHE_TTL 300   // seconds
+#define DNS_NEGATIVE_TTL 10  // seconds
+#define DNS_RESOLVE_TIMEOUT 5000
+#define DIAL_STAGGER 250
+#define DIAL_TIMEOUT 10000
+#define WIFI_CONNECT_TIMEOUT 15000
+#define BAUD_SETTLE_TIME 500
+#define MAX_QUEUED_COMMANDS 4
+#define ECHO_CHUNK_SIZE 64
+#define REPORT_BUFFER_SIZE 2048
+#define ZMUX_MAX_PAYLOAD 1024
+#define ZMUX_WINDOW 4096        // initial credit per channel, each direction
+#define ZMUX_MAX_OPENS 4
+#define ZMUX_FRAMES_PER_TICK 8
+#define TLS_SESSION_CACHE_SIZE 4
+#define TLS_HANDSHAKE_TIMEOUT 10000
+#define V42BIS_DICT_SIZE 2048    // codewords, 11 bits max, 14k of tables
+#define V42BIS_MAX_STRING 32
+#define V42BIS_FLUSH_MS 20       // idle time before a partial string is sent
+#define XMODEM_WINDOW 8          // blocks ACKed ahead of the remote end
+#define XMODEM_TIMEOUT 10000
+#define XMODEM_RETRIES 10
+#define XMODEM_HOLD_TIME 1000    // a lone SOH/STX is let through after this
+#define XMODEM_ABANDON_TIME 60000
+#define XMODEM_WRITE_WAIT 2000  // short socket writes are retried this long
+#define GATEWAY_LOCAL_IP 192, 168, 240, 1
+#define GATEWAY_PEER_IP 192, 168, 240, 2
+#define GATEWAY_NETMASK 255, 255, 255, 252
+#define GATEWAY_MTU 1006        // SLIP default, PPP negotiates its own
+#define GATEWAY_TX_QUEUE_LEN 16 // packets waiting for the UART, more are dropped
 
 #endif
\ No newline at end of file
@@ -35,7 +35,8 @@ enum ZResult
 	ZBUSY,
 	ZNOANSWER,
 	ZIGNORE,
-	ZIGNORE_SPECIAL
+	ZIGNORE_SPECIAL,
+	ZPENDING	// long command still running, see ZOperation
 };
 
 enum ZMode
@@ -43,8 +44,19 @@ enum ZMode
 	ZCOMMAND_MODE,
 	ZCONSOLE_MODE,
 	ZSTREAM_MODE,
-	ZPRINT_MODE,
-	ZSHELL_MODE
+	ZGATEWAY_MODE,
+	ZSHELL_MODE,
+	ZMUX_MODE
+};
+
+enum ZOperation
+{
+	ZOP_NONE,
+	ZOP_SCAN,	// ATW network scan
+	ZOP_WIFI,	// ATW join
+	ZOP_DIAL,	// ATD / ATC
+	ZOP_BAUD,	// ATB settle delay
+	ZOP_REPORT	// ATI / AT&V output draining
 };
 
 struct ZEscape {
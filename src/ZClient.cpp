@@ -1,16 +1,293 @@
 #include "ZClient.h"
+#include "ZResolver.h"
 
 int ZClient::nextClientId = 1;
 
 ZClient::ZClient() : WiFiClient()
 {
     m_id = nextClientId++;
+    m_host[0] = '\0';
     m_answered = false;
+    m_inbound = false;
     flags = 0;
+    m_inflate = nullptr;
+    m_tls = nullptr;
+    m_compressedBytes = 0;
+    m_decompressedBytes = 0;
+    m_backlog = nullptr;
+    m_backlogSize = 0;
+    m_backlogHead = 0;
+    m_backlogLen = 0;
+    m_backlogDropped = 0;
+    m_muxCredit = 0;
+    m_muxHold = nullptr;
+    m_muxHoldLen = 0;
+    m_telnet.setOutput(telnetOutput, this);
+}
+
+ZClient::ZClient(const WiFiClient &client) : ZClient()
+{
+    Base::operator=(client);
+    m_inbound = true;
+    strncpy(m_host, remoteIP().toString().c_str(), sizeof(m_host));
+}
+
+ZClient::~ZClient()
+{
+    delete m_inflate;
+    delete m_tls;
+    free(m_backlog);
+    free(m_muxHold);
+}
+
+size_t ZClient::telnetOutput(void *arg, const uint8_t *data, size_t len)
+{
+    return ((ZClient *)arg)->write(data, len);
 }
 
 int ZClient::connect(const char *host, uint16_t port)
 {
     strncpy(m_host, host, sizeof(m_host));
-    return Base::connect(host, port);
-}
\ No newline at end of file
+    IPAddress addr;
+    if (!Resolver.resolve(host, addr))
+    {
+        return 0;
+    }
+    return Base::connect(addr, port);
+}
+
+void ZClient::adopt(int fd, const char *host)
+{
+    // take over a socket connected elsewhere, e.g. by ZDialer
+    Base::operator=(WiFiClient(fd));
+    strncpy(m_host, host, sizeof(m_host));
+    m_host[sizeof(m_host) - 1] = '\0';
+}
+
+int ZClient::receive(uint8_t *buf, size_t size)
+{
+    int avail = available();
+    if (m_inflate == nullptr)
+    {
+        if (avail <= 0)
+            return 0;
+        return read(buf, avail < (int)size ? avail : size);
+    }
+    if (avail > 0 && !m_inflate->finished())
+    {
+        m_compressedBytes += m_inflate->fill(*this, avail);
+    }
+    size_t n = m_inflate->read(buf, size);
+    m_decompressedBytes += n;
+    if (m_inflate->failed())
+    {
+        // a corrupt MCCP stream cannot be resynchronized
+        delete m_inflate;
+        m_inflate = nullptr;
+        stop();
+    }
+    else if (m_inflate->finished() && m_inflate->pendingOutput() == 0 && m_inflate->pendingInput() == 0)
+    {
+        delete m_inflate;
+        m_inflate = nullptr;
+    }
+    return n;
+}
+
+bool ZClient::startCompression(const uint8_t *data, size_t len)
+{
+    delete m_inflate;
+    m_inflate = new ZInflate();
+    if (!m_inflate->begin())
+    {
+        delete m_inflate;
+        m_inflate = nullptr;
+        stop();
+        return false;
+    }
+    m_compressedBytes += m_inflate->feed(data, len);
+    return true;
+}
+
+bool ZClient::startTls()
+{
+    delete m_tls;
+    m_tls = new ZTls();
+    if (!m_tls->begin(fd(), m_host, remotePort()))
+    {
+        delete m_tls;
+        m_tls = nullptr;
+        return false;
+    }
+    return true;
+}
+
+int ZClient::pollTls()
+{
+    return m_tls != nullptr ? m_tls->poll() : ZTLS_FAILED;
+}
+
+size_t ZClient::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t ZClient::write(const uint8_t *buf, size_t size)
+{
+    if (m_tls != nullptr)
+    {
+        return m_tls->write(buf, size);
+    }
+    return Base::write(buf, size);
+}
+
+int ZClient::available()
+{
+    if (m_tls != nullptr)
+    {
+        return m_tls->available();
+    }
+    return Base::available();
+}
+
+int ZClient::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int ZClient::read(uint8_t *buf, size_t size)
+{
+    if (m_tls != nullptr)
+    {
+        return m_tls->read(buf, size);
+    }
+    return Base::read(buf, size);
+}
+
+int ZClient::peek()
+{
+    if (m_tls != nullptr)
+    {
+        return m_tls->peek();
+    }
+    return Base::peek();
+}
+
+uint8_t ZClient::connected()
+{
+    if (m_tls != nullptr)
+    {
+        // buffered plaintext is still readable after the peer has gone; the
+        // SSL context belongs to whichever task reads, so only look at what
+        // that task left behind
+        return m_tls->buffered() > 0 || (m_tls->open() && Base::connected());
+    }
+    return Base::connected();
+}
+
+void ZClient::stop()
+{
+    if (m_tls != nullptr)
+    {
+        m_tls->close();
+    }
+    Base::stop();
+}
+
+size_t ZClient::pushBacklog(const uint8_t *data, size_t len, uint8_t policy)
+{
+    if (m_backlog == nullptr)
+    {
+        // idle connections may hold a lot more when PSRAM is fitted
+        if (psramFound())
+        {
+            m_backlog = (uint8_t *)ps_malloc(ZCLIENT_BACKLOG_PSRAM_SIZE);
+            m_backlogSize = ZCLIENT_BACKLOG_PSRAM_SIZE;
+        }
+        if (m_backlog == nullptr)
+        {
+            m_backlog = (uint8_t *)malloc(ZCLIENT_BACKLOG_SIZE);
+            m_backlogSize = ZCLIENT_BACKLOG_SIZE;
+        }
+        if (m_backlog == nullptr)
+        {
+            m_backlogSize = 0;
+            m_backlogDropped += len;
+            return 0;
+        }
+    }
+    if (len > m_backlogSize)
+    {
+        m_backlogDropped += len - m_backlogSize;
+        data += len - m_backlogSize;
+        len = m_backlogSize;
+    }
+    size_t space = m_backlogSize - m_backlogLen;
+    if (len > space)
+    {
+        if (policy == ZBACKLOG_DROP_OLDEST)
+        {
+            size_t drop = len - space;
+            m_backlogHead = (m_backlogHead + drop) % m_backlogSize;
+            m_backlogLen -= drop;
+            m_backlogDropped += drop;
+        }
+        else
+        {
+            m_backlogDropped += len - space;
+            len = space;
+        }
+    }
+    size_t tail = (m_backlogHead + m_backlogLen) % m_backlogSize;
+    size_t first = m_backlogSize - tail < len ? m_backlogSize - tail : len;
+    memcpy(m_backlog + tail, data, first);
+    memcpy(m_backlog, data + first, len - first);
+    m_backlogLen += len;
+    return len;
+}
+
+size_t ZClient::popBacklog(uint8_t *buf, size_t size)
+{
+    size_t len = m_backlogLen < size ? m_backlogLen : size;
+    if (len == 0)
+        return 0;
+    size_t first = m_backlogSize - m_backlogHead < len ? m_backlogSize - m_backlogHead : len;
+    memcpy(buf, m_backlog + m_backlogHead, first);
+    memcpy(buf + first, m_backlog, len - first);
+    m_backlogLen -= len;
+    m_backlogHead = m_backlogLen ? (m_backlogHead + len) % m_backlogSize : 0;
+    return len;
+}
+
+size_t ZClient::holdMux(const uint8_t *data, size_t len)
+{
+    // mux data the socket did not take yet, never more than one window
+    // since the DTE waits for credit before sending more
+    if (m_muxHold == nullptr)
+    {
+        m_muxHold = (uint8_t *)malloc(ZMUX_WINDOW);
+        if (m_muxHold == nullptr)
+        {
+            return 0;
+        }
+    }
+    if (len > ZMUX_WINDOW - m_muxHoldLen)
+    {
+        len = ZMUX_WINDOW - m_muxHoldLen;
+    }
+    memcpy(m_muxHold + m_muxHoldLen, data, len);
+    m_muxHoldLen += len;
+    return len;
+}
+
+void ZClient::releaseMux(size_t len)
+{
+    if (len >= m_muxHoldLen)
+    {
+        m_muxHoldLen = 0;
+        return;
+    }
+    memmove(m_muxHold, m_muxHold + len, m_muxHoldLen - len);
+    m_muxHoldLen -= len;
+}
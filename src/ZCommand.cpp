@@ -0,0 +1,272 @@
+#include "ZCommand.h"
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const DMODIFIERS = ",exprts+";
+static const char *const DCOMMANDS = "dcpatwn";
+
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+static inline bool isNumeric(char c)
+{
+    return (c == '-') || ((c >= '0') && (c <= '9'));
+}
+
+// digits only, as the number would read with the '-' dropped
+static long digitValue(const uint8_t *v, int vlen)
+{
+    unsigned long n = 0;
+    for (int k = 0; k < vlen; k++)
+    {
+        if ((v[k] >= '0') && (v[k] <= '9'))
+        {
+            n = n * 10 + (v[k] - '0');
+            if (n > LONG_MAX)
+            {
+                return LONG_MAX;
+            }
+        }
+    }
+    return (long)n;
+}
+
+static char *trim(char *s, char **end)
+{
+    while (*s != '\0' && isspace((unsigned char)*s))
+    {
+        s++;
+    }
+    char *e = s + strlen(s);
+    while (e > s && isspace((unsigned char)e[-1]))
+    {
+        e--;
+    }
+    *e = '\0';
+    *end = e;
+    return s;
+}
+
+char ZCommandParser::lc(char c)
+{
+    // char is signed here, shifted PETSCII letters only compare as unsigned
+    unsigned char u = c;
+    if ((u >= 65) && (u <= 90))
+    {
+        return u + 32;
+    }
+    if ((u >= 193) && (u <= 218))
+    {
+        return u - 96;
+    }
+    return c;
+}
+
+ZCommandParser::ZCommandParser()
+{
+    line[0] = '\0';
+    last[0] = '\0';
+    arg[0] = '\0';
+    modifiers[0] = '\0';
+}
+
+bool ZCommandParser::begin(const char *input, size_t size)
+{
+    const char *s = input;
+    const char *e = input + strnlen(input, size < MAX_COMMAND_SIZE ? size : MAX_COMMAND_SIZE);
+    while (s < e && isspace((unsigned char)*s))
+    {
+        s++;
+    }
+    while (e > s && isspace((unsigned char)e[-1]))
+    {
+        e--;
+    }
+    len = e - s;
+    memmove(line, s, len);
+    line[len] = '\0';
+    pos = len;
+
+    if (len == 2 && lc(line[0]) == 'a' && lc(line[1]) == '/')
+    {
+        len = strlen(last);
+        memcpy(line, last, len + 1);
+    }
+
+    int i = 0;
+    while (i < len - 1 && (lc(line[i]) != 'a' || lc(line[i + 1]) != 't'))
+    {
+        i++;
+    }
+    if (i >= len - 1)
+    {
+        return false;
+    }
+    memcpy(last, line, len + 1);
+    pos = i + 2;
+    return true;
+}
+
+bool ZCommandParser::next(ZCommand &c)
+{
+    int i = pos;
+    if (i >= len)
+    {
+        return false;
+    }
+    while (i < len && isBlank(line[i]))
+    {
+        i++;
+    }
+    // past the end this reads the terminator, which no command matches
+    c.cmd = lc(line[i++]);
+    c.sec = ' ';
+    int vstart = i;
+    int vlen = 0;
+    int mlen = 0;
+    bool isNumber = true;
+    if (i < len)
+    {
+        if (c.cmd == '+' || c.cmd == '$')
+        {
+            vlen += len - i;
+            i = len;
+        }
+        else if (c.cmd == '&' || c.cmd == '%')
+        {
+            i++;
+            c.sec = lc(line[vstart]);
+            vstart++;
+        }
+    }
+    while (i < len && isBlank(line[i]))
+    {
+        vstart++;
+        i++;
+    }
+    if (i < len)
+    {
+        if (line[i] == '\"')
+        {
+            isNumber = false;
+            vstart++;
+            while (++i < len && (line[i] != '\"' || line[i - 1] == '\\'))
+            {
+                vlen++;
+            }
+            if (i < len)
+            {
+                i++;
+            }
+        }
+        else if (strchr(DCOMMANDS, c.cmd) != NULL)
+        {
+            while (i < len && (strchr(DMODIFIERS, lc(line[i])) != NULL))
+            {
+                modifiers[mlen++] = lc(line[i++]);
+            }
+            while (i < len && isBlank(line[i]))
+            {
+                i++;
+            }
+            vstart = i;
+            if (line[i] == '\"')
+            {
+                vstart++;
+                while (++i < len && (line[i] != '\"' || line[i - 1] == '\\'))
+                {
+                    vlen++;
+                }
+                if (i < len)
+                {
+                    i++;
+                }
+            }
+            else
+            {
+                vlen += len - i;
+                i = len;
+            }
+            for (int k = vstart; k < vstart + vlen; k++)
+            {
+                isNumber = isNumeric(line[k]) && isNumber;
+            }
+        }
+        else
+        {
+            while ((i < len) && (!((lc(line[i]) >= 'a') && (lc(line[i]) <= 'z'))) && (line[i] != '&') && (line[i] != '%') && (line[i] != ' '))
+            {
+                isNumber = isNumeric(line[i]) && isNumber;
+                vlen++;
+                i++;
+            }
+        }
+    }
+    pos = i;
+    modifiers[mlen] = '\0';
+    memcpy(arg, line + vstart, vlen);
+    arg[vlen] = '\0';
+
+    c.vbuf = arg;
+    c.vlen = vlen;
+    c.vval = (vlen > 0 && isNumber) ? digitValue(arg, vlen) : 0;
+    c.isNumber = isNumber;
+    c.dmodifiers = modifiers;
+
+    c.name[0] = c.cmd;
+    c.name[1] = '\0';
+    if (c.cmd == '&' || c.cmd == '%')
+    {
+        c.name[1] = c.sec;
+        c.name[2] = '\0';
+    }
+    else if (c.cmd == '+')
+    {
+        for (int k = 0; k < vlen; k++)
+        {
+            arg[k] = lc(arg[k]);
+        }
+        if (vlen + 1 < MAX_COMMAND_KEY)
+        {
+            memcpy(c.name + 1, arg, vlen + 1);
+        }
+        else
+        {
+            c.name[0] = '\0';
+        }
+    }
+    else if (c.cmd == '$')
+    {
+        // $name=value, the name is case insensitive, both sides trimmed
+        char *eq = strchr((char *)arg, '=');
+        c.name[0] = '\0';
+        if (eq != NULL && eq != (char *)arg)
+        {
+            *eq = '\0';
+            char *end;
+            char *var = trim((char *)arg, &end);
+            if (end - var + 1 < MAX_COMMAND_KEY)
+            {
+                c.name[0] = '$';
+                for (int k = 0; var + k <= end; k++)
+                {
+                    c.name[k + 1] = lc(var[k]);
+                }
+            }
+            char *val = trim(eq + 1, &end);
+            c.vbuf = (uint8_t *)val;
+            c.vlen = end - val;
+            c.vval = atol(val);
+            c.isNumber = true;
+            for (char *v = val; v < end; v++)
+            {
+                c.isNumber = isNumeric(*v) && c.isNumber;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,276 @@
+#include "ZDialer.h"
+#include "ZResolver.h"
+#include "ZDebug.h"
+#include <lwip/sockets.h>
+#include <errno.h>
+
+ZDialer::ZDialer()
+{
+    memset(&m_entry, 0, sizeof(m_entry));
+    m_count = 0;
+    m_next = 0;
+    m_active = 0;
+    m_winner = ZDIALER_FAILED;
+    m_winnerFd = -1;
+    m_races = 0;
+    m_lastTime = 0;
+    m_reordered = false;
+    for (int i = 0; i < ZPHONEBOOK_ENDPOINTS; i++)
+    {
+        attempts[i].state = IDLE;
+        attempts[i].fd = -1;
+    }
+}
+
+void ZDialer::order()
+{
+    // measured mirrors by latency, then the unmeasured ones as listed
+    for (int i = 0; i < m_count; i++)
+    {
+        m_order[i] = i;
+    }
+    for (int i = 1; i < m_count; i++)
+    {
+        int idx = m_order[i];
+        uint16_t key = m_entry.latency[idx] ? m_entry.latency[idx] : ZPHONEBOOK_LATENCY_FAILED - 1;
+        int j = i - 1;
+        while (j >= 0)
+        {
+            uint16_t other = m_entry.latency[m_order[j]] ? m_entry.latency[m_order[j]] : ZPHONEBOOK_LATENCY_FAILED - 1;
+            if (other <= key)
+                break;
+            m_order[j + 1] = m_order[j];
+            j--;
+        }
+        m_order[j + 1] = idx;
+    }
+}
+
+uint16_t ZDialer::split(const char *address, char *host, size_t size)
+{
+    strncpy(host, address, size);
+    host[size - 1] = '\0';
+    char *colon = strchr(host, ':');
+    if (colon == NULL)
+    {
+        return 23;
+    }
+    *colon = '\0';
+    return atoi(colon + 1);
+}
+
+int ZDialer::open(IPAddress ip, uint16_t port)
+{
+    int fd = lwip_socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = (uint32_t)ip;
+    addr.sin_port = htons(port);
+    if (lwip_connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS)
+    {
+        lwip_close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void ZDialer::fail(int index)
+{
+    if (attempts[index].fd >= 0)
+    {
+        lwip_close(attempts[index].fd);
+        attempts[index].fd = -1;
+    }
+    if (attempts[index].state != IDLE && attempts[index].state != FAILED)
+    {
+        m_active--;
+    }
+    attempts[index].state = FAILED;
+    m_entry.latency[index] = ZPHONEBOOK_LATENCY_FAILED;
+}
+
+void ZDialer::finish(bool measured)
+{
+    unsigned long now = millis();
+    // every mirror that did not complete is slower than the winner, or than
+    // the whole race when nobody won; failures already carry their penalty
+    unsigned long least = m_winner >= 0 ? m_entry.latency[m_winner] + 1 : now - m_begin;
+    for (int i = 0; i < m_count; i++)
+    {
+        if (i == m_winner || attempts[i].state == FAILED)
+            continue;
+        // one still resolving or connecting is at least as slow as the time it had
+        unsigned long elapsed = attempts[i].state == IDLE ? 0 : now - attempts[i].started;
+        if (elapsed < least)
+            elapsed = least;
+        if (measured && (m_entry.latency[i] == 0 || m_entry.latency[i] < elapsed))
+            m_entry.latency[i] = elapsed < ZPHONEBOOK_LATENCY_FAILED ? elapsed : ZPHONEBOOK_LATENCY_FAILED - 1;
+        if (attempts[i].fd >= 0)
+        {
+            lwip_close(attempts[i].fd);
+            attempts[i].fd = -1;
+        }
+    }
+    m_active = 0;
+    m_lastTime = millis() - m_begin;
+    // the next dial goes in this order, tell the caller if that changed
+    int before[ZPHONEBOOK_ENDPOINTS];
+    memcpy(before, m_order, sizeof(before));
+    order();
+    m_reordered = memcmp(before, m_order, m_count * sizeof(int)) != 0;
+}
+
+void ZDialer::begin(const PBEntry &pbe, unsigned long timeout)
+{
+    abort();
+    memcpy(&m_entry, &pbe, sizeof(m_entry));
+    m_count = m_entry.endpoints();
+    m_next = 0;
+    m_active = 0;
+    m_winner = m_count > 0 ? ZDIALER_PENDING : ZDIALER_FAILED;
+    m_begin = millis();
+    m_lastStart = m_begin;
+    m_timeout = timeout;
+    m_races++;
+    m_reordered = false;
+    order();
+    for (int i = 0; i < m_count; i++)
+    {
+        char host[sizeof(PBEntry::address)];
+        split(m_entry.endpoint(i), host, sizeof(host));
+        Resolver.prefetch(host);
+        attempts[i].state = IDLE;
+        attempts[i].fd = -1;
+    }
+}
+
+int ZDialer::poll()
+{
+    if (m_winner != ZDIALER_PENDING)
+    {
+        return m_winner;
+    }
+    unsigned long now = millis();
+    if ((now - m_begin) >= m_timeout)
+    {
+        DPRINTLN("Dial timed out");
+        m_winner = ZDIALER_FAILED;
+        finish();
+        return m_winner;
+    }
+    if (m_next < m_count && (m_active == 0 || (now - m_lastStart) >= DIAL_STAGGER))
+    {
+        int idx = m_order[m_next++];
+        attempts[idx].state = RESOLVING;
+        attempts[idx].started = m_lastStart = now;
+        m_active++;
+    }
+
+    fd_set wfds;
+    FD_ZERO(&wfds);
+    int maxfd = -1;
+    for (int i = 0; i < m_count; i++)
+    {
+        if (attempts[i].state == RESOLVING)
+        {
+            char host[sizeof(PBEntry::address)];
+            uint16_t port = split(m_entry.endpoint(i), host, sizeof(host));
+            IPAddress ip;
+            int state = Resolver.query(host, ip);
+            if (state == ZRESOLVER_FAILED)
+            {
+                fail(i);
+            }
+            else if (state == ZRESOLVER_RESOLVED)
+            {
+                attempts[i].fd = open(ip, port);
+                if (attempts[i].fd < 0)
+                {
+                    fail(i);
+                    continue;
+                }
+                DPRINTF("Racing %s\n", m_entry.endpoint(i));
+                attempts[i].state = CONNECTING;
+                attempts[i].started = millis();
+            }
+        }
+        if (attempts[i].state == CONNECTING)
+        {
+            FD_SET(attempts[i].fd, &wfds);
+            if (attempts[i].fd > maxfd)
+                maxfd = attempts[i].fd;
+        }
+    }
+
+    struct timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = 0;
+    if (maxfd >= 0 && lwip_select(maxfd + 1, NULL, &wfds, NULL, &tv) > 0)
+    {
+        for (int i = 0; i < m_count && m_winner == ZDIALER_PENDING; i++)
+        {
+            if (attempts[i].state != CONNECTING || !FD_ISSET(attempts[i].fd, &wfds))
+                continue;
+            int err = 0;
+            socklen_t len = sizeof(err);
+            lwip_getsockopt(attempts[i].fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err != 0)
+            {
+                DPRINTF("Mirror %s failed (%d)\n", m_entry.endpoint(i), err);
+                fail(i);
+                continue;
+            }
+            unsigned long elapsed = millis() - attempts[i].started;
+            m_entry.latency[i] = elapsed < ZPHONEBOOK_LATENCY_FAILED ? (elapsed ? elapsed : 1) : ZPHONEBOOK_LATENCY_FAILED - 1;
+            m_winner = i;
+            m_winnerFd = attempts[i].fd;
+            attempts[i].fd = -1;
+            DPRINTF("Mirror %s won in %u ms\n", m_entry.endpoint(i), m_entry.latency[i]);
+        }
+    }
+
+    if (m_winner == ZDIALER_PENDING && m_next >= m_count && m_active == 0)
+    {
+        m_winner = ZDIALER_FAILED;
+    }
+    if (m_winner != ZDIALER_PENDING)
+    {
+        finish();
+    }
+    return m_winner;
+}
+
+void ZDialer::abort()
+{
+    if (m_winner == ZDIALER_PENDING)
+    {
+        // cut short by the caller, that says nothing about the mirrors
+        m_winner = ZDIALER_FAILED;
+        finish(false);
+    }
+    if (m_winnerFd >= 0)
+    {
+        lwip_close(m_winnerFd);
+        m_winnerFd = -1;
+    }
+}
+
+bool ZDialer::take(ZClient &client)
+{
+    if (m_winnerFd < 0)
+    {
+        return false;
+    }
+    lwip_fcntl(m_winnerFd, F_SETFL, lwip_fcntl(m_winnerFd, F_GETFL, 0) & ~O_NONBLOCK);
+    char host[sizeof(PBEntry::address)];
+    split(m_entry.endpoint(m_winner), host, sizeof(host));
+    client.adopt(m_winnerFd, host);
+    m_winnerFd = -1;
+    return true;
+}
@@ -0,0 +1,68 @@
+#include "ZFlowControl.h"
+#include "ZSerial.h"
+
+void ZFlowControl::begin(FlowControlMode mode)
+{
+    release();
+    this->mode = mode;
+    stalled = false;
+}
+
+void ZFlowControl::update(size_t used, size_t capacity)
+{
+    // a stall is over once everything queued has gone out
+    bool blocked = stalled && used > 0;
+    if (!held)
+    {
+        if (blocked || used >= capacity * FLOW_HOLD_PERCENT / 100)
+        {
+            hold();
+        }
+    }
+    else if (!blocked && used <= capacity * FLOW_RELEASE_PERCENT / 100)
+    {
+        release();
+    }
+}
+
+void ZFlowControl::hold()
+{
+    held = true;
+    heldAt = millis();
+    stats.holds++;
+    if (mode == FCM_HARDWARE || mode == FCM_SOFTWARE || mode == FCM_BOTH)
+    {
+        Serial2.holdReceive(true);
+    }
+    else
+    {
+        // nothing to tell the DTE with, bytes past the buffers are lost
+        stats.unprotected++;
+    }
+}
+
+void ZFlowControl::release()
+{
+    if (!held)
+    {
+        return;
+    }
+    unsigned long elapsed = millis() - heldAt;
+    stats.heldTime += elapsed;
+    if (elapsed > stats.longestHold)
+    {
+        stats.longestHold = elapsed;
+    }
+    held = false;
+    Serial2.holdReceive(false);
+}
+
+void ZFlowControl::socketWrite(size_t requested, size_t written, unsigned long elapsed)
+{
+    bool stall = written < requested || elapsed >= FLOW_STALL_MS;
+    if (stall && !stalled)
+    {
+        stats.socketStalls++;
+    }
+    stalled = stall;
+}
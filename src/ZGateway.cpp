@@ -0,0 +1,373 @@
+#include "ZGateway.h"
+#include "ZSerial.h"
+#include "ZDebug.h"
+#include <lwip/netifapi.h>
+#include <lwip/tcpip.h>
+#if PPP_SUPPORT
+#include <netif/ppp/pppapi.h>
+#include <netif/ppp/pppos.h>
+#endif
+#if IP_NAPT
+#include <lwip/lwip_napt.h>
+#endif
+
+#define SLIP_END        0xC0
+#define SLIP_ESC        0xDB
+#define SLIP_ESC_END    0xDC
+#define SLIP_ESC_ESC    0xDD
+
+bool ZGateway::supported(ZGatewayProtocol protocol)
+{
+#if PPP_SUPPORT && PPP_SERVER
+    if (protocol == ZGATEWAY_PPP)
+    {
+        return true;
+    }
+#endif
+    return protocol == ZGATEWAY_SLIP;
+}
+
+bool ZGateway::begin(ZGatewayProtocol protocol, IPAddress dns)
+{
+    end();
+    if (!supported(protocol))
+    {
+        return false;
+    }
+    m_local.addr = static_cast<uint32_t>(IPAddress(GATEWAY_LOCAL_IP));
+    m_peer.addr = static_cast<uint32_t>(IPAddress(GATEWAY_PEER_IP));
+    m_up = false;
+    m_lost = false;
+    m_frameLen = 0;
+    m_escaped = false;
+    m_discard = false;
+    stats = {};
+    m_txLen = 0;
+    m_txPos = 0;
+    if (m_txQueue == nullptr)
+    {
+        m_txQueue = xQueueCreate(GATEWAY_TX_QUEUE_LEN, sizeof(struct pbuf *));
+        if (m_txQueue == nullptr)
+        {
+            return false;
+        }
+    }
+    m_protocol = protocol;
+    bool ok = protocol == ZGATEWAY_SLIP ? beginSlip() : beginPpp(dns);
+    if (!ok)
+    {
+        m_protocol = ZGATEWAY_NONE;
+    }
+    return ok;
+}
+
+void ZGateway::end()
+{
+    if (m_protocol == ZGATEWAY_NONE)
+    {
+        return;
+    }
+    setNapt(false);
+    if (m_protocol == ZGATEWAY_SLIP)
+    {
+        netifapi_netif_remove(&m_netif);
+    }
+#if PPP_SUPPORT
+    else if (m_ppp != nullptr)
+    {
+        // no LCP terminate exchange, the DTE asked to hang up
+        pppapi_close(m_ppp, 1);
+        pppapi_free(m_ppp);
+        m_ppp = nullptr;
+    }
+#endif
+    if (m_frame != nullptr)
+    {
+        pbuf_free(m_frame);
+        m_frame = nullptr;
+    }
+    // the netif is gone, nothing queues behind our back any more
+    struct pbuf *p;
+    while (xQueueReceive(m_txQueue, &p, 0) == pdTRUE)
+    {
+        pbuf_free(p);
+    }
+    m_txLen = 0;
+    m_txPos = 0;
+    m_protocol = ZGATEWAY_NONE;
+    m_up = false;
+}
+
+void ZGateway::input(const uint8_t *data, size_t len)
+{
+    stats.bytesIn += len;
+    if (m_protocol == ZGATEWAY_SLIP)
+    {
+        slipInput(data, len);
+    }
+#if PPP_SUPPORT
+    else if (m_protocol == ZGATEWAY_PPP)
+    {
+        // pppos reassembles HDLC frames in the tcpip thread
+        pppos_input_tcpip(m_ppp, (u8_t *)data, len);
+    }
+#endif
+}
+
+void ZGateway::setNapt(bool state)
+{
+    if (m_napt != state)
+    {
+        m_napt = state;
+        tcpip_callback(&ZGateway::callbackNapt, this);
+    }
+}
+
+void ZGateway::callbackNapt(void *arg)
+{
+    reinterpret_cast<ZGateway *>(arg)->napt();
+}
+
+void ZGateway::napt()
+{
+#if IP_NAPT
+    ip_napt_enable(m_local.addr, m_napt ? 1 : 0);
+#endif
+}
+
+bool ZGateway::beginSlip()
+{
+    ip4_addr_t netmask;
+    netmask.addr = static_cast<uint32_t>(IPAddress(GATEWAY_NETMASK));
+    if (netifapi_netif_add(&m_netif, &m_local, &netmask, &m_peer, this, &ZGateway::callbackSlipInit, tcpip_input) != ERR_OK)
+    {
+        return false;
+    }
+    netifapi_netif_set_up(&m_netif);
+    netifapi_netif_set_link_up(&m_netif);
+    m_up = true;
+    setNapt(true);
+    DPRINTF("SLIP %s <-> %s\n", localIP().toString().c_str(), peerIP().toString().c_str());
+    return true;
+}
+
+err_t ZGateway::callbackSlipInit(struct netif *netif)
+{
+    netif->name[0] = 's';
+    netif->name[1] = 'l';
+    netif->output = &ZGateway::callbackSlipOutput;
+    netif->mtu = GATEWAY_MTU;
+    return ERR_OK;
+}
+
+err_t ZGateway::callbackSlipOutput(struct netif *netif, struct pbuf *p, const ip4_addr_t *addr)
+{
+    pbuf_ref(p);
+    return reinterpret_cast<ZGateway *>(netif->state)->queueOutput(p);
+}
+
+err_t ZGateway::queueOutput(struct pbuf *p)
+{
+    // runs in the tcpip thread, a full queue drops the packet rather than
+    // stalling the whole stack behind the serial line
+    if (xQueueSend(m_txQueue, &p, 0) != pdTRUE)
+    {
+        pbuf_free(p);
+        stats.errors++;
+        return ERR_MEM;
+    }
+    return ERR_OK;
+}
+
+size_t ZGateway::slipEncode(struct pbuf *p, uint8_t *out)
+{
+    size_t n = 0;
+    out[n++] = SLIP_END;
+    for (struct pbuf *q = p; q != nullptr; q = q->next)
+    {
+        const uint8_t *data = (const uint8_t *)q->payload;
+        for (size_t i = 0; i < q->len; i++)
+        {
+            if (data[i] == SLIP_END || data[i] == SLIP_ESC)
+            {
+                out[n++] = SLIP_ESC;
+                out[n++] = data[i] == SLIP_END ? SLIP_ESC_END : SLIP_ESC_ESC;
+            }
+            else
+            {
+                out[n++] = data[i];
+            }
+        }
+    }
+    out[n++] = SLIP_END;
+    return n;
+}
+
+bool ZGateway::output()
+{
+    bool busy = false;
+    for (;;)
+    {
+        if (m_txPos < m_txLen)
+        {
+            int room = Serial2.availableForWrite();
+            if (room <= 0)
+            {
+                return busy;
+            }
+            size_t n = Serial2.write(m_txBuf + m_txPos, min((size_t)room, m_txLen - m_txPos));
+            m_txPos += n;
+            busy = busy || n > 0;
+            if (m_txPos < m_txLen)
+            {
+                return busy;
+            }
+        }
+        struct pbuf *p;
+        if (m_txQueue == nullptr || xQueueReceive(m_txQueue, &p, 0) != pdTRUE)
+        {
+            return busy;
+        }
+        if (m_protocol == ZGATEWAY_SLIP && p->tot_len <= GATEWAY_MTU)
+        {
+            m_txLen = slipEncode(p, m_txBuf);
+            stats.framesOut++;
+            stats.bytesOut += p->tot_len;
+        }
+        else if (m_protocol == ZGATEWAY_PPP && p->tot_len <= sizeof(m_txBuf))
+        {
+            // pppos already did the HDLC framing
+            m_txLen = pbuf_copy_partial(p, m_txBuf, p->tot_len, 0);
+            stats.bytesOut += m_txLen;
+        }
+        else
+        {
+            m_txLen = 0;
+            stats.errors++;
+        }
+        m_txPos = 0;
+        pbuf_free(p);
+    }
+}
+
+void ZGateway::slipInput(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t c = data[i];
+        if (c == SLIP_END)
+        {
+            if (m_frameLen > 0 && !m_discard)
+            {
+                // the pbuf itself goes to lwIP, a fresh one is taken for the next frame
+                pbuf_realloc(m_frame, m_frameLen);
+                if (m_netif.input(m_frame, &m_netif) == ERR_OK)
+                {
+                    stats.framesIn++;
+                }
+                else
+                {
+                    pbuf_free(m_frame);
+                    stats.errors++;
+                }
+                m_frame = nullptr;
+            }
+            m_frameLen = 0;
+            m_escaped = false;
+            m_discard = false;
+            continue;
+        }
+        if (m_discard)
+        {
+            continue;
+        }
+        if (c == SLIP_ESC)
+        {
+            m_escaped = true;
+            continue;
+        }
+        if (m_escaped)
+        {
+            m_escaped = false;
+            c = c == SLIP_ESC_END ? SLIP_END : c == SLIP_ESC_ESC ? SLIP_ESC : c;
+        }
+        if (m_frame == nullptr)
+        {
+            m_frame = pbuf_alloc(PBUF_RAW, GATEWAY_MTU, PBUF_RAM);
+        }
+        if (m_frame == nullptr || m_frameLen >= GATEWAY_MTU)
+        {
+            stats.errors++;
+            m_discard = true;
+            continue;
+        }
+        ((uint8_t *)m_frame->payload)[m_frameLen++] = c;
+    }
+}
+
+#if PPP_SUPPORT
+bool ZGateway::beginPpp(IPAddress dns)
+{
+#if PPP_SERVER
+    m_ppp = pppapi_pppos_create(&m_netif, &ZGateway::callbackPppOutput, &ZGateway::callbackPppStatus, this);
+    if (m_ppp == nullptr)
+    {
+        return false;
+    }
+    ppp_set_ipcp_ouraddr(m_ppp, &m_local);
+    ppp_set_ipcp_hisaddr(m_ppp, &m_peer);
+#if LWIP_DNS
+    ip4_addr_t server;
+    server.addr = static_cast<uint32_t>(dns);
+    ppp_set_ipcp_dnsaddr(m_ppp, 0, &server);
+#endif
+    // no authentication and no default route, WiFi stays the way out
+    pppapi_listen(m_ppp);
+    return true;
+#else
+    return false;
+#endif
+}
+
+u32_t ZGateway::callbackPppOutput(ppp_pcb *pcb, u8_t *data, u32_t len, void *ctx)
+{
+    // the buffer is only lent to us, the queue gets a copy
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+    if (p == nullptr)
+    {
+        reinterpret_cast<ZGateway *>(ctx)->stats.errors++;
+        return 0;
+    }
+    pbuf_take(p, data, len);
+    return reinterpret_cast<ZGateway *>(ctx)->queueOutput(p) == ERR_OK ? len : 0;
+}
+
+void ZGateway::callbackPppStatus(ppp_pcb *pcb, int code, void *ctx)
+{
+    reinterpret_cast<ZGateway *>(ctx)->pppStatus(code);
+}
+
+void ZGateway::pppStatus(int code)
+{
+    // called in the tcpip thread
+    if (code == PPPERR_NONE)
+    {
+        DPRINTF("PPP up %s <-> %s\n", localIP().toString().c_str(), peerIP().toString().c_str());
+        m_up = true;
+        m_napt = true;
+        napt();
+        return;
+    }
+    DPRINTF("PPP down: %d\n", code);
+    m_up = false;
+    if (code != PPPERR_USER)
+    {
+        m_lost = true;
+    }
+}
+#else
+bool ZGateway::beginPpp(IPAddress dns)
+{
+    return false;
+}
+#endif
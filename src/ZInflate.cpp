@@ -0,0 +1,126 @@
+#include "ZInflate.h"
+#include <stdlib.h>
+#include <string.h>
+
+ZInflate::ZInflate()
+{
+    decomp = nullptr;
+    dict = nullptr;
+    dictOfs = 0;
+    outPos = 0;
+    outLen = 0;
+    inPos = 0;
+    inLen = 0;
+    status = TINFL_STATUS_NEEDS_MORE_INPUT;
+}
+
+ZInflate::~ZInflate()
+{
+    end();
+}
+
+bool ZInflate::begin()
+{
+    end();
+    decomp = (tinfl_decompressor *)malloc(sizeof(tinfl_decompressor));
+    dict = (uint8_t *)malloc(TINFL_LZ_DICT_SIZE);
+    if (decomp == nullptr || dict == nullptr)
+    {
+        end();
+        status = TINFL_STATUS_FAILED;
+        return false;
+    }
+    tinfl_init(decomp);
+    status = TINFL_STATUS_NEEDS_MORE_INPUT;
+    return true;
+}
+
+void ZInflate::end()
+{
+    free(decomp);
+    free(dict);
+    decomp = nullptr;
+    dict = nullptr;
+    dictOfs = 0;
+    outPos = 0;
+    outLen = 0;
+}
+
+void ZInflate::compact()
+{
+    if (inPos > 0)
+    {
+        memmove(in, in + inPos, inLen - inPos);
+        inLen -= inPos;
+        inPos = 0;
+    }
+}
+
+size_t ZInflate::feed(const uint8_t *data, size_t len)
+{
+    compact();
+    if (len > sizeof(in) - inLen)
+        len = sizeof(in) - inLen;
+    memcpy(in + inLen, data, len);
+    inLen += len;
+    return len;
+}
+
+size_t ZInflate::fill(Client &src, size_t avail)
+{
+    compact();
+    size_t room = sizeof(in) - inLen;
+    if (avail > room)
+        avail = room;
+    if (avail == 0)
+        return 0;
+    int n = src.read(in + inLen, avail);
+    if (n <= 0)
+        return 0;
+    inLen += n;
+    return n;
+}
+
+size_t ZInflate::read(uint8_t *out, size_t size)
+{
+    size_t n = 0;
+
+    while (n < size)
+    {
+        if (outLen > 0)
+        {
+            size_t m = outLen < (size - n) ? outLen : (size - n);
+            memcpy(out + n, dict + outPos, m);
+            outPos += m;
+            outLen -= m;
+            n += m;
+            continue;
+        }
+        if (finished())
+        {
+            // whatever follows the zlib stream is plain telnet again
+            size_t m = (inLen - inPos) < (size - n) ? (inLen - inPos) : (size - n);
+            memcpy(out + n, in + inPos, m);
+            inPos += m;
+            n += m;
+            break;
+        }
+        if (failed() || dict == nullptr)
+        {
+            break;
+        }
+        size_t inBytes = inLen - inPos;
+        size_t outBytes = TINFL_LZ_DICT_SIZE - dictOfs;
+        status = tinfl_decompress(decomp, in + inPos, &inBytes, dict, dict + dictOfs, &outBytes,
+                                  TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+        inPos += inBytes;
+        outPos = dictOfs;
+        outLen = outBytes;
+        dictOfs = (dictOfs + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+        if (inBytes == 0 && outBytes == 0)
+        {
+            break;
+        }
+    }
+    return n;
+}
@@ -1,38 +1,11 @@
 #include "ZModem.h"
 #include "ZPhonebook.h"
+#include "ZPetscii.h"
+#include "ZResolver.h"
 #include "z/version.h"
 #include <SPIFFS.h>
 #include <WiFi.h>
 
-#define TELNET_BINARY 0
-#define TELNET_ECHO 1
-#define TELNET_LOGOUT 18
-#define TELNET_SUPRESS_GO_AHEAD 3
-#define TELNET_TERMTYPE 24
-#define TELNET_NAWS 31
-#define TELNET_TOGGLE_FLOW_CONTROL 33
-#define TELNET_LINEMODE 34
-#define TELNET_MSDP 69
-#define TELNET_MSSP 70
-#define TELNET_COMPRESS 85
-#define TELNET_COMPRESS2 86
-#define TELNET_MSP 90
-#define TELNET_MXP 91
-#define TELNET_AARD 102
-#define TELNET_ATCP 200
-#define TELNET_GMCP 201
-#define TELNET_SE 240
-#define TELNET_AYT 246
-#define TELNET_EC 247
-#define TELNET_GA 249
-#define TELNET_SB 250
-#define TELNET_WILL 251
-#define TELNET_WONT 252
-#define TELNET_DO 253
-#define TELNET_DONT 254
-#define TELNET_NOP 241
-#define TELNET_IAC 255
-
 const char *const ZModem::RESULT_CODES_V0[] = {
 	"0", "1", "2", "3", "4", "6", "7", "8"};
 
@@ -46,49 +19,12 @@ const char *const ZModem::RESULT_CODES_V1[] = {
 	"BUSY",
 	"NO ANSWER"};
 
-const unsigned char ZModem::PET2ASC_TABLE[256] PROGMEM = {
-	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x14, 0x09, 0x0d, 0x11, 0x93, 0x0a, 0x0e, 0x0f,
-	0x10, 0x0b, 0x12, 0x13, 0x08, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
-	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
-	0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
-	0x40, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
-	0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
-	0x60, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f,
-	0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f,
-	0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
-	0x90, 0x91, 0x92, 0x0c, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f,
-	0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf,
-	0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf,
-	0x60, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f,
-	0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf,
-	0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf,
-	0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf};
-
-const unsigned char ZModem::ASC2PET_TABLE[256] PROGMEM = {
-	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x14, 0x20, 0x0a, 0x11, 0x93, 0x0d, 0x0e, 0x0f,
-	0x10, 0x0b, 0x12, 0x13, 0x08, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
-	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
-	0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
-	0x40, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf,
-	0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
-	0xc0, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f,
-	0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0xdb, 0xdc, 0xdd, 0xde, 0xdf,
-	0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
-	0x90, 0x91, 0x92, 0x0c, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f,
-	0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf,
-	0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf,
-	0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf,
-	0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf,
-	0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef,
-	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
-
-ZModem::ZModem()
+ZModem::ZModem() : report(reportBuf, sizeof(reportBuf))
 {
 	mode = ZCOMMAND_MODE;
 	buffer[0] = '\0';
 	buflen = 0;
 	termType = DEFAULT_TERMTYPE;
-	lastCommand = emptyString;
 	memset(&esc, 0, sizeof(esc));
 }
 
@@ -98,89 +34,7 @@ ZModem::~ZModem()
 
 char ZModem::lc(char c)
 {
-	if ((c >= 65) && (c <= 90))
-	{
-		return c + 32;
-	}
-	if ((c >= 193) && (c <= 218))
-	{
-		return c - 96;
-	}
-	return c;
-}
-
-bool ZModem::asc2pet(char *c)
-{
-	return true;
-}
-
-bool ZModem::processIAC(char *c)
-{
-	if (*c == 0xFF)
-	{
-		*c = socketRead(250);
-		if (*c == TELNET_IAC)
-		{
-			*c = 0xFF;
-			return true;
-		}
-		if (*c == TELNET_WILL)
-		{
-			char what = socketRead(250);
-			uint8_t iacDont[] = {TELNET_IAC, TELNET_DONT, what};
-			if (what == TELNET_TERMTYPE)
-				iacDont[1] = TELNET_DO;
-			socket->write(iacDont, 3);
-			return false;
-		}
-		if (*c == TELNET_DONT)
-		{
-			char what = socketRead(250);
-			uint8_t iacWont[] = {TELNET_IAC, TELNET_WONT, what};
-			socket->write(iacWont, 3);
-			return false;
-		}
-		if (*c == TELNET_WONT)
-		{
-			socketRead(250); // skip
-			return false;
-		}
-		if (*c == TELNET_DO)
-		{
-			char what = socketRead(250);
-			uint8_t iacWont[] = {TELNET_IAC, TELNET_WONT, what};
-			if (what == TELNET_TERMTYPE)
-				iacWont[1] = TELNET_WILL;
-			socket->write(iacWont, 3);
-			return false;
-		}
-		if (*c == TELNET_SB)
-		{
-			char what = socketRead(250);
-			char lastC = *c;
-			while (((lastC != TELNET_IAC) || (*c != TELNET_SE)) && (*c >= 0))
-			{
-				lastC = *c;
-				*c = socketRead(250);
-			}
-			if (what == TELNET_TERMTYPE)
-			{
-				int len = termType.length() + 6;
-				uint8_t buf[len];
-				buf[0] = TELNET_IAC;
-				buf[1] = TELNET_SB;
-				buf[2] = TELNET_TERMTYPE;
-				buf[3] = (uint8_t)0;
-				sprintf((char *)buf + 4, termType.c_str());
-				buf[len - 2] = TELNET_IAC;
-				buf[len - 1] = TELNET_SE;
-				socket->write(buf, len);
-				return false;
-			}
-		}
-		return false;
-	}
-	return true;
+	return ZCommandParser::lc(c);
 }
 
 int ZModem::modifierCompare(const char *m1, const char *m2)
@@ -228,7 +82,7 @@ void ZModem::setStaticIPs(IPAddress *ip, IPAddress *dns, IPAddress *gateway, IPA
 	staticSN = subnet;
 }
 
-bool ZModem::connectWiFi(const char *ssid, const char *pswd, IPAddress *ip, IPAddress *dns, IPAddress *gateway, IPAddress *subnet)
+bool ZModem::beginWiFi(const char *ssid, const char *pswd, IPAddress *ip, IPAddress *dns, IPAddress *gateway, IPAddress *subnet)
 {
 	if (WiFi.status() == WL_CONNECTED)
 	{
@@ -251,62 +105,85 @@ bool ZModem::connectWiFi(const char *ssid, const char *pswd, IPAddress *ip, IPAd
 	}
 	DPRINTF("Connecting to %s ", ssid);
 	WiFi.begin(ssid, pswd);
-	int attemps = 0;
-	while (attemps < 30)
+	wifiStarted = millis();
+	return true;
+}
+
+ZResult ZModem::pollWiFi()
+{
+	unsigned long elapsed = millis() - wifiStarted;
+	if (WiFi.status() == WL_CONNECTED && strcmp(WiFi.localIP().toString().c_str(), "0.0.0.0") != 0)
 	{
-		if (WiFi.status() == WL_CONNECTED && strcmp(WiFi.localIP().toString().c_str(), "0.0.0.0") != 0)
+		DPRINTLN("OK");
+		httpServer.begin(80);
+		if (strlen(SREG.hostname) > 0)
 		{
-			DPRINTLN("OK");
-			httpServer.begin(80);
-			if (strlen(SREG.hostname) > 0)
+			WiFi.hostname(String(SREG.hostname));
+			if (MDNS.begin(SREG.hostname))
 			{
-				WiFi.hostname(String(SREG.hostname));
-				if (MDNS.begin(SREG.hostname))
-				{
-					DPRINTLN("mDNS responder started");
-					MDNS.addService("http", "tcp", 80);
-					DPRINTF("HTTPUpdateServer available at http://%s.local/update in your browser\n", SREG.hostname);
-				}
+				DPRINTLN("mDNS responder started");
+				MDNS.addService("http", "tcp", 80);
+				DPRINTF("HTTPUpdateServer available at http://%s.local/update in your browser\n", SREG.hostname);
 			}
-			digitalWrite(PIN_LED_WIFI, HIGH);
-			return true;
-		}
-		else
-		{
-			digitalWrite(PIN_LED_WIFI, attemps % 2);
-			DPRINT(".");
-			delay(500);
 		}
-		attemps++;
+		// answers from the previous network may not hold on this one
+		Resolver.flush();
+		Resolver.prefetchPhonebook();
+		digitalWrite(PIN_LED_WIFI, HIGH);
+		return ZOK;
 	}
-	digitalWrite(PIN_LED_WIFI, LOW);
-	DPRINTLN("failed");
-	WiFi.disconnect();
-	return false;
+	if (elapsed >= WIFI_CONNECT_TIMEOUT)
+	{
+		digitalWrite(PIN_LED_WIFI, LOW);
+		DPRINTLN("failed");
+		WiFi.disconnect();
+		return ZERROR;
+	}
+	digitalWrite(PIN_LED_WIFI, (elapsed / 500) % 2);
+	return ZPENDING;
+}
+
+bool ZModem::connectWiFi(const char *ssid, const char *pswd, IPAddress *ip, IPAddress *dns, IPAddress *gateway, IPAddress *subnet)
+{
+	if (!beginWiFi(ssid, pswd, ip, dns, gateway, subnet))
+	{
+		return false;
+	}
+	ZResult rc;
+	while ((rc = pollWiFi()) == ZPENDING)
+	{
+		delay(100);
+	}
+	return rc == ZOK;
 }
 
 bool ZModem::readSerialStream()
 {
+	// echo goes out in one write per call rather than per keystroke
+	uint8_t echo[ECHO_CHUNK_SIZE];
+	size_t echoed = 0;
+	bool echoEnabled = SREG.echoEnabled();
 	bool crReceived = false;
 	while (Serial2.available() > 0 && !crReceived)
 	{
 		uint8_t c = Serial2.read();
-		if (c == '\n' || c == '\r')
+		if (c > 0 && echoEnabled)
 		{
-			if (SREG.echoEnabled())
+			if (echoed == sizeof(echo))
 			{
-				Serial2.write(c);
+				Serial2.write(echo, echoed);
+				echoed = 0;
 			}
+			echo[echoed++] = c;
+		}
+		if (c == '\n' || c == '\r')
+		{
 			crReceived = true;
 			break;
 		}
 
 		if (c > 0)
 		{
-			if (SREG.echoEnabled())
-			{
-				Serial2.write(c);
-			}
 			if ((c == SREG[5]) || ((SREG[5] == 8) && ((c == ASCII_DC4) || (c == ASCII_DELETE))))
 			{
 				if (buflen > 0)
@@ -320,278 +197,133 @@ bool ZModem::readSerialStream()
 			crReceived = (buflen >= MAX_COMMAND_SIZE) || (buflen == 2 && buffer[1] == '/' && lc(buffer[0]) == 'a');
 		}
 	}
+	if (echoed > 0)
+	{
+		Serial2.write(echo, echoed);
+	}
 	return crReceived && buflen > 0;
 }
 
-void ZModem::sendNewline()
+void ZModem::sendNewline(Print &out)
 {
-	Serial2.print(SREG.carriageReturn());
+	out.print(SREG.carriageReturn());
 	if (SREG.resultCodeVerbose())
 	{
-		Serial2.print(SREG.lineFeed());
+		out.print(SREG.lineFeed());
+	}
+}
+
+ZResult ZModem::sendReport(ZResult rc)
+{
+	if (report.length() == 0)
+	{
+		return rc;
+	}
+	if (rc != ZOK)
+	{
+		flushReport();
+		return rc;
+	}
+	// drained from tick(), the rest of the line and the result code follow
+	reportSent = 0;
+	return beginOperation(ZOP_REPORT);
+}
+
+void ZModem::flushReport()
+{
+	Serial2.write((const uint8_t *)report.c_str(), report.length());
+	report.begin();
+}
+
+ZResult ZModem::pollReport()
+{
+	size_t left = report.length() - reportSent;
+	int room = Serial2.availableForWrite();
+	if (left > 0 && room > 0)
+	{
+		size_t n = min(left, (size_t)room);
+		Serial2.write((const uint8_t *)report.c_str() + reportSent, n);
+		reportSent += n;
+		left -= n;
 	}
+	if (left > 0)
+	{
+		return ZPENDING;
+	}
+	report.begin();
+	return ZOK;
 }
 
 void ZModem::sendAnnouncement()
 {
-	sendNewline();
-	Serial2.printf("%s Firmware v%s (%s)", ZMODEM_APPNAME, ZMODEM_VERSION, ZMODEM_CODENAME);
-	sendNewline();
-	Serial2.printf("sdk=%s chipid=%d cpu@%d", ESP.getSdkVersion(), ESP.getChipRevision(), ESP.getCpuFreqMHz());
-	sendNewline();
-	Serial2.printf("flash=%dk heap=%dk spiffs=%dk speed=%dm", (ESP.getFlashChipSize() / 1024), (ESP.getFreeHeap() / 1024), SPIFFS.totalBytes() / 1024, (ESP.getFlashChipSpeed() / 1000000));
-	sendNewline();
+	sendNewline(report);
+	report.format("%s Firmware v%s (%s)", ZMODEM_APPNAME, ZMODEM_VERSION, ZMODEM_CODENAME);
+	sendNewline(report);
+	report.format("sdk=%s chipid=%d cpu@%d", ESP.getSdkVersion(), ESP.getChipRevision(), ESP.getCpuFreqMHz());
+	sendNewline(report);
+	report.format("flash=%dk heap=%dk spiffs=%dk speed=%dm", (ESP.getFlashChipSize() / 1024), (ESP.getFreeHeap() / 1024), SPIFFS.totalBytes() / 1024, (ESP.getFlashChipSpeed() / 1000000));
+	sendNewline(report);
 
 	if (strlen(SREG.wifiSSID) > 0)
 	{
 		if (WiFi.status() == WL_CONNECTED)
 		{
-			Serial2.printf("CONNECTED TO %s (%s)", SREG.wifiSSID, WiFi.localIP().toString().c_str());
+			report.format("CONNECTED TO %s (%s)", SREG.wifiSSID, WiFi.localIP().toString().c_str());
 		}
 		else
 		{
-			Serial2.printf("ERROR ON %s", SREG.wifiSSID);
+			report.format("ERROR ON %s", SREG.wifiSSID);
 		}
 	}
 	else
 	{
-		Serial2.print("INITIALIZED");
+		report.print("INITIALIZED");
 	}
-	sendNewline();
-	Serial2.print("READY.");
-	sendNewline();
-	Serial2.flush();
+	sendNewline(report);
+	report.print("READY.");
+	sendNewline(report);
 }
 
 void ZModem::sendConfiguration()
 {
 	ZProfile sp;
 
-	sendNewline();
-	Serial2.printf("ACTIVE PROFILE: %d %s", SREG.baudRate, SREG.wifiSSID);
-	sendNewline();
-	Serial2.printf("%s%d", "B", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "E", SREG.echoEnabled() ? 1 : 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "L", SREG.speakerVolume());
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "M", SREG.speakerControl());
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "N", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "Q", SREG.resultCodeEnabled() ? 1 : 0);
-	Serial2.print(' ');
-	Serial2.print('T');
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "V", SREG.resultCodeNumeric() ? 1 : 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "W", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "X", SREG.resultCodeExtended() ? 1 : 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "Y", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&C", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&D", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&G", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&J", 0);
-	Serial2.print(' ');
-	switch (SREG.flowControlMode())
-	{
-	case FCM_DISABLED:
-		Serial2.printf("%s%d", "&K", 0);
-		break;
-	case FCM_UNUSED1:
-		Serial2.printf("%s%d", "&K", 1);
-		break;
-	case FCM_UNUSED2:
-		Serial2.printf("%s%d", "&K", 2);
-		break;
-	case FCM_HARDWARE:
-		Serial2.printf("%s%d", "&K", 3);
-		break;
-	case FCM_SOFTWARE:
-		Serial2.printf("%s%d", "&K", 4);
-		break;
-	case FCM_TRANSPARENT:
-		Serial2.printf("%s%d", "&K", 5);
-		break;
-	case FCM_BOTH:
-		Serial2.printf("%s%d", "&K", 6);
-		break;
-	case FCM_INVALID:
-		break;
-	}
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&Q", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&R", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&S", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&T", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&X", 0);
-	Serial2.print(' ');
-	Serial2.printf("%s%d", "&Y", 0);
-	sendNewline();
-	Serial2.printf("S%02d:%03d", 0, SREG[0]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 1, SREG[1]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 2, SREG[2]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 3, SREG[3]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 4, SREG[4]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 5, SREG[5]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 6, SREG[6]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 7, SREG[7]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 8, SREG[8]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 9, SREG[9]);
-	Serial2.print(' ');
-	sendNewline();
-	Serial2.printf("S%02d:%03d", 10, SREG[10]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 11, SREG[11]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 12, SREG[12]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 18, SREG[18]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 25, SREG[25]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 26, SREG[26]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 36, SREG[36]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 37, SREG[37]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 38, SREG[38]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 46, SREG[46]);
-	sendNewline();
-	Serial2.printf("S%02d:%03d", 48, SREG[48]);
-	Serial2.print(' ');
-	Serial2.printf("S%02d:%03d", 95, SREG[95]);
-	sendNewline();
+	sendNewline(report);
+	report.format("ACTIVE PROFILE: %d %s", SREG.baudRate, SREG.wifiSSID);
+	reportProfile(SREG, ZREG_LISTED);
 
 	for (int num = 0; num < MAX_USER_PROFILES; num++)
 	{
 		sp.loadProfile(num);
-		sendNewline();
-		Serial2.printf("STORED PROFILE %d: %d %s", num, sp.baudRate, sp.wifiSSID);
-		sendNewline();
-		Serial2.printf("%s%d", "B", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "E", sp.echoEnabled() ? 1 : 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "L", sp.speakerVolume());
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "M", sp.speakerControl());
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "N", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "Q", sp.resultCodeEnabled() ? 1 : 0);
-		Serial2.print(' ');
-		Serial2.print('T');
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "V", sp.resultCodeNumeric() ? 1 : 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "W", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "X", sp.resultCodeExtended() ? 1 : 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "Y", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&C", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&D", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&G", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&J", 0);
-		Serial2.print(' ');
-		switch (sp.flowControlMode())
-		{
-		case FCM_DISABLED:
-			Serial2.printf("%s%d", "&K", 0);
-			break;
-		case FCM_UNUSED1:
-			Serial2.printf("%s%d", "&K", 1);
-			break;
-		case FCM_UNUSED2:
-			Serial2.printf("%s%d", "&K", 2);
-			break;
-		case FCM_HARDWARE:
-			Serial2.printf("%s%d", "&K", 3);
-			break;
-		case FCM_SOFTWARE:
-			Serial2.printf("%s%d", "&K", 4);
-			break;
-		case FCM_TRANSPARENT:
-			Serial2.printf("%s%d", "&K", 5);
-			break;
-		case FCM_BOTH:
-			Serial2.printf("%s%d", "&K", 6);
-			break;
-		case FCM_INVALID:
-			break;
+		sendNewline(report);
+		report.format("STORED PROFILE %d: %d %s", num, sp.baudRate, sp.wifiSSID);
+		reportProfile(sp, ZREG_LISTED | ZREG_PERSIST);
+	}
+}
+
+void ZModem::reportProfile(ZProfile &p, uint8_t flags)
+{
+	sendNewline(report);
+	report.format("B0 E%d L%d M%d N0 Q%d T V%d W0 X%d Y0 &C0 &D0 &G0 &J0 &K%d &Q0 &R0 &S0 &T0 &X0 &Y0",
+				  p.echoEnabled() ? 1 : 0, p.speakerVolume(), p.speakerControl(), p.resultCodeEnabled() ? 1 : 0,
+				  p.resultCodeNumeric() ? 1 : 0, p.resultCodeExtended() ? 1 : 0, p.flowControlMode());
+	sendNewline(report);
+	int n = 0;
+	for (const ZRegister &r : ZREGISTERS)
+	{
+		if ((r.flags & flags) != flags)
+		{
+			continue;
 		}
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&Q", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&R", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&S", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&T", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&X", 0);
-		Serial2.print(' ');
-		Serial2.printf("%s%d", "&Y", 0);
-		sendNewline();
-		Serial2.printf("S%02d:%03d", 0, SREG[0]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 2, SREG[2]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 6, SREG[6]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 7, SREG[7]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 8, SREG[8]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 9, SREG[9]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 10, SREG[10]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 11, SREG[11]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 12, SREG[12]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 18, SREG[18]);
-		sendNewline();
-		Serial2.printf("S%02d:%03d", 36, SREG[36]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 37, SREG[37]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 40, SREG[40]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 41, SREG[41]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 46, SREG[46]);
-		Serial2.print(' ');
-		Serial2.printf("S%02d:%03d", 95, SREG[95]);
-		sendNewline();
+		report.format(n % 10 ? " S%02d:%03d" : "S%02d:%03d", r.index, p[r.index]);
+		if (++n % 10 == 0)
+		{
+			sendNewline(report);
+		}
+	}
+	if (n % 10 != 0)
+	{
+		sendNewline(report);
 	}
 }
 
@@ -668,493 +400,1414 @@ void ZModem::sendConnectionNotice(int id)
 	sendNewline();
 }
 
-int ZModem::activeProfile()
+size_t ZModem::socketWrite(uint8_t c)
 {
-	int result = -1;
+	size_t totalBytesSent = 0;
 
-	File file = SPIFFS.open("/profile/active", "r");
-	if (file)
+	if (c == 0xFF && socket->telnetMode())
 	{
-		String line = file.readString();
-		if (!line.isEmpty())
-		{
-			result = line.toInt();
-			DPRINTF("Active profile: %d\n", result);
-		}			
-		file.close();
+		totalBytesSent += socket->write(c);
 	}
+	totalBytesSent += socket->write(c);
+
+	return totalBytesSent;
+}
 
-	return result;
+size_t ZModem::socketWrite(const uint8_t *buf, size_t size)
+{
+	return clientWrite(socket, buf, size);
 }
 
-void ZModem::setActiveProfile(int num)
+size_t ZModem::clientWrite(ZClient *client, const uint8_t *buf, size_t size)
 {
-	File file = SPIFFS.open("/profile/active", "w");
-	if (file)
+	if (client->telnetMode())
 	{
-		file.print(num);
-		file.close();
-		DPRINTF("Set active profile: %d\n", num);
+		return client->telnet().send(buf, size);
 	}
+	return client->write(buf, size);
 }
 
-size_t ZModem::socketWrite(uint8_t c)
+bool ZModem::pumpSerialRx()
 {
-	size_t totalBytesSent = 0;
-
-	if (c == 0xFF && socket->telnetMode())
+	// stop draining the UART once "+++" was accepted, what follows are commands
+	if (escapeDetected)
 	{
-		totalBytesSent += socket->write(c);
+		return false;
 	}
-	totalBytesSent += socket->write(c);
-
-	return totalBytesSent;
+	if (hwEscape)
+	{
+		return pumpSerialRxPattern();
+	}
+	int avail = Serial2.available();
+	size_t room = uplink.space();
+	if (avail <= 0 || room <= sizeof(esc.buf))
+	{
+		return false;
+	}
+	size_t len = Serial2.read(txChunk, min(min((size_t)avail, room - sizeof(esc.buf)), sizeof(txChunk)));
+	if (len == 0)
+	{
+		return false;
+	}
+	// Tx stats
+	totalBytesTx += len;
+	// stamp before publishing so the NET task never forwards on a stale time
+	markUplink(txChunk, len);
+	// the whole chunk arrived within the same tick
+	unsigned long now = millis();
+	size_t span = 0;
+	for (size_t i = 0; i < len; i++)
+	{
+		uint8_t c = txChunk[i];
+		if (c != SREG[2] || (now - esc.gt1) < SREG.guardTime() || esc.len >= sizeof(esc.buf))
+		{
+			if (esc.len)
+			{
+				uplink.write(esc.buf, esc.len);
+				esc.len = 0;
+				esc.gt2 = 0;
+			}
+			esc.gt1 = now;
+		}
+		else
+		{
+			// queue pending data before holding back the escape char
+			if (i > span)
+			{
+				uplink.write(txChunk + span, i - span);
+			}
+			span = i + 1;
+			esc.buf[esc.len++] = c;
+			if (esc.len >= 3)
+			{
+				esc.gt2 = now;
+			}
+		}
+	}
+	if (len > span)
+	{
+		uplink.write(txChunk + span, len - span);
+	}
+	return true;
 }
 
-size_t ZModem::socketWrite(const uint8_t *buf, size_t size)
+bool ZModem::pumpSerialRxPattern()
 {
-	if (socket->telnetMode())
+	int avail = Serial2.available();
+	size_t room = uplink.space();
+	if (avail <= 0 || room <= sizeof(esc.buf))
+	{
+		return false;
+	}
+	int64_t now = esp_timer_get_time();
+	int pos = Serial2.patternPosition();
+	if (pos == 0)
 	{
-		uint8_t escbuf[size * 2];
-		int k = 0;
-		for (int i = 0; i < size; i++)
+		// the UART matched "+++" with idle time around it
+		if (avail < 3)
 		{
-			escbuf[k++] = buf[i];
-			if (buf[i] == 0xFF)
+			return false;
+		}
+		if (esc.len)
+		{
+			esp_timer_stop(escTimer);
+			uplink.write(esc.buf, esc.len);
+		}
+		Serial2.popPattern();
+		size_t len = Serial2.read(esc.buf, 3);
+		totalBytesTx += len;
+		esc.len = len;
+		// the interrupt only fires after the trailing idle, the leading
+		// guard ends where the first "+" started
+		int64_t first = now - Serial2.patternIdleTime() - 3 * 10000000LL / Serial2.baudRate();
+		if (Serial2.patternCoversGuard() || (first - lastDataAt) >= (int64_t)SREG.guardTime() * 1000)
+		{
+			// the hardware already waited part of the trailing guard
+			escWait = (int64_t)SREG.guardTime() * 1000 - Serial2.patternIdleTime();
+			escArmedAt = now;
+			escTimerFired = false;
+			if (escWait > 0)
+			{
+				esp_timer_start_once(escTimer, escWait);
+			}
+			else
 			{
-				escbuf[k++] = buf[i];
+				escTimerFired = true;
 			}
 		}
-		return socket->write(escbuf, k);
+		else
+		{
+			uplink.write(esc.buf, esc.len);
+			esc.len = 0;
+			lastDataAt = now;
+		}
+		return true;
+	}
+	// anything else is data, the bytes are never inspected
+	size_t limit = min(room - sizeof(esc.buf), sizeof(txChunk));
+	if (pos > 0 && (size_t)pos < limit)
+	{
+		limit = pos;
+	}
+	size_t len = Serial2.read(txChunk, min((size_t)avail, limit));
+	if (len == 0)
+	{
+		return false;
 	}
-	return socket->write(buf, size);
+	totalBytesTx += len;
+	markUplink(txChunk, len);
+	if (esc.len)
+	{
+		esp_timer_stop(escTimer);
+		uplink.write(esc.buf, esc.len);
+		esc.len = 0;
+	}
+	uplink.write(txChunk, len);
+	lastDataAt = now;
+	return true;
 }
 
-uint8_t ZModem::socketRead(unsigned long tmout)
+void ZModem::checkEscapeTimer()
 {
-	if (!socket->available())
+	if (escTimerFired && esc.len && (esp_timer_get_time() - escArmedAt) >= escWait)
 	{
-		unsigned long start = millis();
-		while (socket->available() == 0 && (millis() - start) < tmout)
-			delay(1);
+		escTimerFired = false;
+		esc.len = 0;
+		escapeDetected = true;
 	}
-	return socket->read();
 }
 
-ZResult ZModem::execCommand()
+bool ZModem::pumpSerialTx()
 {
-	String sbuf = (char *)buffer;
-	int len = buflen;
-	buffer[0] = '\0';
-	buflen = 0;
-
-	sbuf.trim();
-
-	if (sbuf.length() == 2 && lc(sbuf[0]) == 'a' && lc(sbuf[1]) == '/')
+	int room = Serial2.availableForWrite();
+	if (room <= 0)
 	{
-		sbuf = lastCommand;
-		len = lastCommand.length();
+		return false;
+	}
+	if (v42Active)
+	{
+		return pumpSerialTxPacked(room);
+	}
+	if (downlink.empty())
+	{
+		return false;
 	}
+	size_t len = downlink.read(dteChunk, min((size_t)room, sizeof(dteChunk)));
+	Serial2.write(dteChunk, len);
+	return true;
+}
 
-	int i = 0;
+bool ZModem::pumpSerialTxPacked(size_t room)
+{
+	// the encoder may expand, take no more input than fits in room at worst
+	if (room < V42BIS_MAX_OUTPUT(2))
+	{
+		return false;
+	}
+	size_t most = (room - V42BIS_MAX_OUTPUT(0)) * 2 / 3;
+	size_t len = 0;
+	int64_t start = esp_timer_get_time();
+	if (!downlink.empty())
+	{
+		size_t in = downlink.read(dteChunk, min(most, sizeof(dteChunk)));
+		len = v42.encode(dteChunk, in, packedChunk);
+		v42BytesIn += in;
+		v42Stamp = millis();
+	}
+	else if (v42.pending() && (millis() - v42Stamp) >= V42BIS_FLUSH_MS)
+	{
+		// the network went quiet, do not sit on a partial string
+		len = v42.flush(packedChunk);
+	}
+	else
+	{
+		return false;
+	}
+	v42Time += esp_timer_get_time() - start;
+	v42BytesOut += len;
+	Serial2.write(packedChunk, len);
+	return true;
+}
 
-	while (i < len - 1 && (lc(sbuf[i]) != 'a' || lc(sbuf[i + 1]) != 't'))
+void ZModem::markUplink(const uint8_t *data, size_t len)
+{
+	uplinkStamp = millis();
+	if (SREG.forwardChar() && memchr(data, SREG.forwardChar(), len) != NULL)
 	{
-		i++;
+		forwardMark = true;
 	}
+}
 
-	if (i < len - 1 && lc(sbuf[i]) == 'a' && lc(sbuf[i + 1]) == 't')
+bool ZModem::forwardReady()
+{
+	size_t pending = uplink.used();
+	if (pending == 0)
+	{
+		return false;
+	}
+	if (!SREG.forwardingEnabled() || !bridgeRunning)
+	{
+		return true;
+	}
+	if (forwardMark.exchange(false))
+	{
+		return true;
+	}
+	if ((SREG.forwardSize() && pending >= SREG.forwardSize()) || pending >= uplink.capacity() / 2)
 	{
-		i += 2;
-		char cmd = ' ';
-		char sec = ' ';
-		int vstart = 0;
-		int vlen = 0;
-		String dmodifiers = "";
-		ZResult rc = ZOK;
+		return true;
+	}
+	return (millis() - uplinkStamp) >= SREG.forwardIdle();
+}
 
-		while (i < len)
+bool ZModem::pumpSocketTx()
+{
+	// escaped telnet data left over from a short write goes first
+	if (socket->telnetMode() && socket->telnet().pending() > 0 && !socket->telnet().flush())
+	{
+		return false;
+	}
+	if (!forwardReady())
+	{
+		return false;
+	}
+	// forward everything queued so far, not just the first chunk
+	size_t pending = uplink.used();
+	while (pending > 0)
+	{
+		size_t len = uplink.peek(netChunk, min(pending, sizeof(netChunk)));
+		if (len == 0)
 		{
-			while (i < len && (sbuf[i] == ' ' || sbuf[i] == '\t'))
-			{
-				i++;
-			}
-			cmd = lc(sbuf[i++]);
-			vstart = i;
-			vlen = 0;
-			bool isNumber = true;
-			if (i < len)
-			{
-				if (cmd == '+' || cmd == '$')
-				{
-					vlen += len - i;
-					i = len;
-				}
-				else if (cmd == '&' || cmd == '%')
-				{
-					i++;
-					sec = lc(sbuf[vstart]);
-					vstart++;
-				}
-			}
-			while (i < len && (sbuf[i] == ' ' || sbuf[i] == '\t'))
+			break;
+		}
+		netWrites++;
+		unsigned long started = millis();
+		if (xmodem.enabled())
+		{
+			// blocks are checked and ACKed locally, the rest comes back through xmodemRemote()
+			uplink.skip(len);
+			pending -= len;
+			xmodem.fromDte(netChunk, len);
+			flow.socketWrite(len, len, millis() - started);
+			continue;
+		}
+		if (socket->petsciiMode())
+		{
+			ZPetscii::petToAsc(netChunk, len);
+		}
+		// what the socket did not take stays queued and is offered again next time
+		size_t written = socketWrite(netChunk, len);
+		uplink.skip(written);
+		pending -= written;
+		flow.socketWrite(len, written, millis() - started);
+		if (written < len)
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+void ZModem::xmodemRemote(const uint8_t *data, size_t len)
+{
+	if (!socket->petsciiMode() || xmodem.active())
+	{
+		xmodemWrite(data, len);
+		return;
+	}
+	while (len > 0)
+	{
+		size_t n = min(len, sizeof(xmodemChunk));
+		memcpy(xmodemChunk, data, n);
+		ZPetscii::petToAsc(xmodemChunk, n);
+		if (xmodemWrite(xmodemChunk, n) < n)
+		{
+			break;
+		}
+		data += n;
+		len -= n;
+	}
+}
+
+size_t ZModem::xmodemWrite(const uint8_t *data, size_t len)
+{
+	// the uplink already let go of this and blocks were ACKed to the DTE,
+	// so a short write is retried here rather than left queued
+	size_t sent = 0;
+	unsigned long started = millis();
+	for (;;)
+	{
+		sent += socketWrite(data + sent, len - sent);
+		if (sent == len || !socket->connected() || millis() - started >= XMODEM_WRITE_WAIT)
+		{
+			break;
+		}
+		vTaskDelay(1);
+	}
+	if (sent < len)
+	{
+		DPRINTF("XMODEM write dropped %u bytes\n", (unsigned)(len - sent));
+	}
+	return sent;
+}
+
+void ZModem::xmodemDte(const uint8_t *data, size_t len)
+{
+	// called from the NET task, the producer side of the downlink
+	bool wasEmpty = downlink.empty();
+	downlink.write(data, len);
+	if (wasEmpty)
+	{
+		Serial2.wake();
+	}
+}
+
+int ZModem::receiveClean(ZClient *client, uint8_t *buf, size_t size)
+{
+	// inflates transparently once MCCP2 is active
+	int len = client->receive(buf, size);
+	if (len > 0 && client->telnetMode())
+	{
+		// strip commands in place, the parser keeps its state across chunks
+		size_t used = len;
+		size_t raw = len;
+		len = client->telnet().receive(buf, raw, &used);
+		if (client->telnet().replyLength() > 0)
+		{
+			client->write(client->telnet().replyData(), client->telnet().replyLength());
+			client->telnet().clearReply();
+		}
+		if (client->telnet().compressionStarted())
+		{
+			client->startCompression(buf + used, raw - used);
+		}
+	}
+	return len;
+}
+
+bool ZModem::pumpSocketRx()
+{
+	size_t room = downlink.space();
+	if (room == 0)
+	{
+		return false;
+	}
+	int len;
+	if (socket->backlogLength() > 0)
+	{
+		// replay what was buffered while this connection was in background
+		len = socket->popBacklog(rxChunk, min(room, sizeof(rxChunk)));
+	}
+	else
+	{
+		len = receiveClean(socket, rxChunk, min(room, sizeof(rxChunk)));
+	}
+	if (len <= 0)
+	{
+		return false;
+	}
+	// RX stats
+	totalBytesRx += len;
+	if (xmodem.enabled())
+	{
+		// ACKs for blocks already ACKed to the DTE are swallowed here
+		len = xmodem.fromRemote(rxChunk, len);
+		if (len == 0)
+		{
+			return true;
+		}
+	}
+	if (socket->petsciiMode())
+	{
+		ZPetscii::ascToPet(rxChunk, len);
+	}
+	// wake the DTE task if it is sleeping on the UART event queue
+	bool wasEmpty = downlink.empty();
+	downlink.write(rxChunk, len);
+	if (wasEmpty)
+	{
+		Serial2.wake();
+	}
+	return true;
+}
+
+void ZModem::drainBackground()
+{
+	for (int i = 0; i < clients.size(); i++)
+	{
+		ZClient *c = clients.get(i);
+		if (c == socket || c->ringing() || !c->connected())
+		{
+			continue;
+		}
+		size_t room = c->backlogSpace();
+		if (room == 0 && SREG.backlogPolicy() == ZBACKLOG_HOLD)
+		{
+			continue;
+		}
+		int len = receiveClean(c, idleChunk, room > 0 ? min(room, sizeof(idleChunk)) : sizeof(idleChunk));
+		if (len > 0)
+		{
+			c->pushBacklog(idleChunk, len, SREG.backlogPolicy());
+		}
+	}
+}
+
+ZResult ZModem::execGateway(ZGatewayProtocol protocol)
+{
+	if (WiFi.status() != WL_CONNECTED)
+	{
+		return ZNOCARRIER;
+	}
+	if (!gateway.begin(protocol, WiFi.dnsIP()))
+	{
+		return ZERROR;
+	}
+	esc.gt1 = millis();
+	switchTo(ZGATEWAY_MODE);
+	return ZCONNECT;
+}
+
+void ZModem::tickGateway()
+{
+	unsigned long now = millis();
+	int avail = Serial2.available();
+	if (avail > 0)
+	{
+		size_t len = Serial2.read(txChunk, min((size_t)avail, sizeof(txChunk)));
+		// "+++" alone between two guard times hangs up, anything else is link traffic
+		bool escape = len > 0 && esc.len + len <= 3 && (esc.len > 0 || (now - esc.gt1) >= SREG.guardTime());
+		for (size_t i = 0; escape && i < len; i++)
+		{
+			escape = txChunk[i] == SREG[2];
+		}
+		if (escape)
+		{
+			memcpy(esc.buf + esc.len, txChunk, len);
+			esc.len += len;
+			esc.gt2 = esc.len == 3 ? now : 0;
+		}
+		else
+		{
+			if (esc.len)
 			{
-				vstart++;
-				i++;
+				gateway.input(esc.buf, esc.len);
+				esc.len = 0;
+				esc.gt2 = 0;
 			}
-			if (i < len)
+			gateway.input(txChunk, len);
+			totalBytesTx += len;
+		}
+		esc.gt1 = now;
+	}
+	else if (esc.gt2 && (now - esc.gt2) > SREG.guardTime())
+	{
+		switchTo(ZCOMMAND_MODE, ZOK);
+		return;
+	}
+	gateway.output();
+	if (gateway.linkLost())
+	{
+		switchTo(ZCOMMAND_MODE, ZNOCARRIER);
+	}
+}
+
+void ZModem::tickMux()
+{
+	if (!muxStarted)
+	{
+		// existing connections become channels numbered by connection id
+		for (int i = 0; i < clients.size(); i++)
+		{
+			ZClient *c = clients.get(i);
+			if (!c->ringing() && c->connected())
 			{
-				if (sbuf[i] == '\"')
-				{
-					isNumber = false;
-					vstart++;
-					while (++i < len && (sbuf[i] != '\"' || sbuf[i - 1] == '\\'))
-					{
-						vlen++;
-					}
-					if (i < len)
-					{
-						i++;
-					}
-				}
-				else if (strchr("dcpatw", cmd) != NULL)
-				{
-					const char *DMODIFIERS = ",exprts+";
-					while (i < len && (strchr(DMODIFIERS, lc(sbuf[i])) != NULL))
-					{
-						dmodifiers += lc((char)sbuf[i++]);
-					}
-					while (i < len && (sbuf[i] == ' ' || sbuf[i] == '\t'))
-					{
-						i++;
-					}
-					vstart = i;
-					if (sbuf[i] == '\"')
-					{
-						vstart++;
-						while (++i < len && (sbuf[i] != '\"' || sbuf[i - 1] == '\\'))
-						{
-							vlen++;
-						}
-						if (i < len)
-						{
-							i++;
-						}
-					}
-					else
-					{
-						vlen += len - i;
-						i = len;
-					}
-					for (int k = vstart; k < vstart + vlen; k++)
-					{
-						char c = sbuf[k];
-						isNumber = ((c == '-') || ((c >= '0') && (c <= '9'))) && isNumber;
-					}
-				}
-				else
-				{
-					while ((i < len) && (!((lc(sbuf[i]) >= 'a') && (lc(sbuf[i]) <= 'z'))) && (sbuf[i] != '&') && (sbuf[i] != '%') && (sbuf[i] != ' '))
-					{
-						char c = sbuf[i];
-						isNumber = ((c == '-') || ((c >= '0') && (c <= '9'))) && isNumber;
-						vlen++;
-						i++;
-					}
-				}
+				openMuxChannel(c);
 			}
-			long vval = 0;
-			uint8_t vbuf[vlen + 1];
-			memset(vbuf, 0, vlen + 1);
-			if (vlen > 0)
+		}
+		muxStarted = true;
+	}
+
+	// a bounded number of frames per tick keeps the sockets serviced
+	for (int n = 0; n < ZMUX_FRAMES_PER_TICK && mux.receive(Serial2); n++)
+	{
+		handleMuxFrame(mux.current());
+		if (mode != ZMUX_MODE)
+		{
+			return;
+		}
+	}
+	pollMuxDial();
+
+	for (int i = 0; i < clients.size(); i++)
+	{
+		ZClient *c = clients.get(i);
+		if (c->ringing())
+		{
+			// callers are answered straight away and announced like dialed channels
+			if (c->connected())
 			{
-				memcpy(vbuf, sbuf.c_str() + vstart, vlen);
-				if (vlen > 0 && isNumber)
-				{
-					String num = "";
-					for (uint8_t *v = vbuf; v < (vbuf + vlen); v++)
-					{
-						if ((*v >= '0') && (*v <= '9'))
-						{
-							num += (char)*v;
-						}
-					}
-					vval = atol(num.c_str());
-				}
+				c->answer();
+				openMuxChannel(c);
 			}
-			DPRINTF("Command: %s\n", sbuf.c_str());
-			if (vlen > 0)
+			continue;
+		}
+		if (c->muxHeldLength() > 0)
+		{
+			size_t n = clientWrite(c, c->muxHeld(), c->muxHeldLength());
+			if (n > 0)
 			{
-				DPRINTF("Proc: %c %lu '%s'\n", cmd, vval, vbuf);
+				c->releaseMux(n);
+				mux.sendCredit(Serial2, c->id(), n);
 			}
-			else
+		}
+		size_t room = min(c->muxCredit(), sizeof(rxChunk));
+		if (room == 0)
+		{
+			continue;
+		}
+		int len;
+		if (c->backlogLength() > 0)
+		{
+			len = c->popBacklog(rxChunk, room);
+		}
+		else
+		{
+			len = receiveClean(c, rxChunk, room);
+		}
+		if (len > 0)
+		{
+			totalBytesRx += len;
+			if (c->petsciiMode())
 			{
-				DPRINTF("Proc: %c %lu ''\n", cmd, vval);
+				ZPetscii::ascToPet(rxChunk, len);
 			}
-			switch (cmd)
+			mux.send(Serial2, c->id(), ZMUX_DATA, rxChunk, len);
+			c->spendMux(len);
+		}
+		else if (!c->connected())
+		{
+			mux.send(Serial2, c->id(), ZMUX_CLOSE, nullptr, 0);
+			closeMuxChannel(i--);
+		}
+	}
+}
+
+void ZModem::handleMuxFrame(const ZMuxFrame &frame)
+{
+	ZClient *c = nullptr;
+	int index = -1;
+	for (int i = 0; i < clients.size(); i++)
+	{
+		if (clients.get(i)->id() == frame.channel && !clients.get(i)->ringing())
+		{
+			c = clients.get(i);
+			index = i;
+			break;
+		}
+	}
+
+	switch (frame.type)
+	{
+	case ZMUX_DATA:
+		if (c == nullptr)
+		{
+			mux.send(Serial2, frame.channel, ZMUX_CLOSE, nullptr, 0);
+			break;
+		}
+	{
+		// only what the socket took is credited, the rest waits in the
+		// channel's hold buffer and is credited as tickMux() sends it
+		size_t sent = 0;
+		for (size_t done = 0; done < frame.length;)
+		{
+			size_t len = min((size_t)(frame.length - done), sizeof(netChunk));
+			memcpy(netChunk, frame.payload + done, len);
+			if (c->petsciiMode())
 			{
-			case 'z':
-				if (!isNumber || vval < 0 || vval > 2)
-				{
-					rc = ZERROR;
-				}
-				else
-				{
-					DPRINTLN("Reset and Restore Profile");
-					for (int i = 0; i < clients.size(); i++)
-					{
-						ZClient *c = clients.get(i);
-						c->stop();
-						delay(50);
-						delete c;
-					}
-					clients.clear();
-					socket = nullptr;
-					SREG.loadProfile(int(vval));
-				}
-				break;
-			case 'n':
-				DPRINTLN("listen");
-				break;
-			case 'a':
-				DPRINTLN("answer");
-				break;
-			case 'e':
-				if (!isNumber)
-					rc = ZERROR;
-				else
-					SREG.setEchoEnabled(vval > 0);
-				break;
-			case 'f':
-				DPRINTLN("f");
-				break;
-			case 'x':
-				DPRINTLN("x");
-				break;
-			case 'r':
-				DPRINTLN("r");
-				break;
-			case 'b':
-				rc = execBaud(vval, vbuf, vlen);
-				break;
-			case 't':
-				DPRINTLN("t");
-				break;
-			case 'h':
-				rc = execHangup(vval, vbuf, vlen, isNumber);
-				break;
-			case 'd':
-				rc = execDial(vval, vbuf, vlen, isNumber, dmodifiers.c_str());
-				break;
-			case 'p':
-				rc = execPhonebook(vval, vbuf, vlen, isNumber, dmodifiers.c_str());
-				break;
-			case 'o':
-				if (vlen == 0 || vval == 0)
-				{
-					if (socket == nullptr || !socket->connected())
-					{
-						rc = ZERROR;
-					}
-					else
-					{
-						switchTo(ZSTREAM_MODE);
-						rc = ZOK;
-					}
-				}
-				else
-				{
-					rc = isNumber ? execDial(vval, vbuf, vlen, isNumber, "") : ZERROR;
-				}
-				break;
-			case 'c':
-				rc = execConnect(vval, vbuf, vlen, isNumber, dmodifiers.c_str());
-				break;
-			case 'i':
-				rc = execInfo(vval, vbuf, vlen, isNumber);
-				break;
-			case 'l':
-				if (isNumber && vval >= 0 && vval <= 3)
-					SREG.setSpeakerVolume(vval);
-				else
-					rc = ZERROR;
-				break;
-			case 'm':
-				if (isNumber && vval >= 0 && vval <= 3)
-					SREG.setSpeakerControl(vval);
-				else
-					rc = ZERROR;
-				break;
-			case 'y':
-				rc = isNumber ? ZOK : ZERROR;
-				break;
-			case 'w':
-				rc = execWiFi(vval, vbuf, vlen, isNumber, dmodifiers.c_str());
-				break;
-			case 'v':
-				if (!isNumber)
-					rc = ZERROR;
-				else
-					SREG.setResultCodeNumeric(vval == 0);
-				break;
-			case 'q':
-				if (!isNumber)
-					rc = ZERROR;
-				else
-					SREG.setResultCodeEnabled(vval == 0);
-				break;
-			case 's':
-				rc = execSRegister(vbuf, vlen);
-				break;
-			case '+':
-				for (int i = 0; vbuf[i] != 0; i++)
-					vbuf[i] = lc(vbuf[i]);
-				if (strcmp((const char *)vbuf, "console") == 0)
-					switchTo(ZCONSOLE_MODE);
-				else if (strcmp((const char *)vbuf, "shell") == 0)
-					switchTo(ZSHELL_MODE);
-				else if (strcmp((const char *)vbuf, "rst") == 0)
-					ESP.restart();
-				else
-					rc = ZERROR;
-				break;
-			case '$':
+				ZPetscii::petToAsc(netChunk, len);
+			}
+			size_t n = c->muxHeldLength() == 0 ? clientWrite(c, netChunk, len) : 0;
+			sent += n;
+			if (n < len)
 			{
-				int eqMark = 0;
-				for (int i = 0; vbuf[i] != '\0'; i++)
-				{
-					if (vbuf[i] == '=')
-					{
-						eqMark = i;
-						break;
-					}
-					else
-					{
-						vbuf[i] = lc(vbuf[i]);
-					}
-				}
-				if (!eqMark)
-				{
-					rc = ZERROR;
-				}
-				else
-				{
-					vbuf[eqMark] = '\0';
-					String var = (char *)vbuf;
-					var.trim();
-					String val = (char *)(vbuf + eqMark + 1);
-					val.trim();
-					rc = (val.length() == 0 && strcmp(var.c_str(), "pass") != 0) ? ZERROR : ZOK;
-					if (rc == ZOK)
-					{
-						DPRINTLN(var);
-						DPRINTLN(val);
-						if (strcmp(var.c_str(), "ssid") == 0)
-						{
-							strcpy(SREG.wifiSSID, var.c_str());
-						}
-						else if (strcmp(var.c_str(), "pass") == 0)
-						{
-							strcpy(SREG.wifiPSWD, val.c_str());
-						}
-						else if (strcmp(var.c_str(), "mdns") == 0)
-						{
-							strcpy(SREG.hostname, val.c_str());
-						}
-						else if (strcmp(var.c_str(), "sb") == 0)
-						{
-							rc = execBaud(atoi(val.c_str()), (uint8_t *)val.c_str(), val.length());
-						}
-						else
-						{
-							rc = ZERROR;
-						}
-					}
-				}
-				break;
+				size_t held = c->holdMux(netChunk + n, len - n);
+				// beyond the window the DTE broke the protocol, drop it but keep the window whole
+				sent += len - n - held;
 			}
-
-			case '%':
-				rc = ZERROR;
-				break;
-			case '&':
-				switch (sec)
-				{
-				case 'k':
-					if (!isNumber || vval >= FCM_INVALID)
-						rc = ZERROR;
-					else
-					{
-						SREG.setFlowControlMode((FlowControlMode)vval);
-						Serial2.setFlowControl(SREG.flowControlMode());
-					}
-					break;
-				case 'l':
-					DPRINTLN("l");
-					break;
-				case 'v':
-					sendConfiguration();
-					break;
-				case 'w':
-					if (isNumber && vval >= 0 && vval < MAX_USER_PROFILES)
-						SREG.saveProfile(int(vval));
-					else
-						rc = ZERROR;
-					break;
-				case 'f':
-					if (isNumber && vval >= 0 && vval < MAX_USER_PROFILES)
-						SREG.loadProfile(-1);
-					else
-						rc = ZERROR;
-					break;
-				case 'y':
-					if (isNumber && vval >= 0 && vval < MAX_USER_PROFILES)
-						setActiveProfile(vval);
-					else
-						rc = ZERROR;
-					break;
-				case 'm':
-					DPRINTLN("m");
-					break;
-				case 'd':
-					DPRINTLN("d");
-					break;
-				case 'o':
-					DPRINTLN("o");
-					break;
-				case 'h':
-					DPRINTLN("h");
-					break;
-				case 'g':
-					DPRINTLN("g");
-					break;
-				case 's':
-					DPRINTLN("s");
-					break;
-				case 'p':
-					DPRINTLN("p");
-					break;
-				case 'n':
-					DPRINTLN("n");
-					break;
-				case 't':
-					rc = execTime(vval, vbuf, vlen, isNumber);
-					break;
-				case 'u':
-					DPRINTLN("u");
-					break;
-				default:
-					rc = ZERROR;
-				}
-				break;
-			default:
-				rc = ZERROR;
+			done += len;
+		}
+		totalBytesTx += frame.length;
+		if (sent > 0)
+		{
+			mux.sendCredit(Serial2, frame.channel, sent);
+		}
+		break;
+	}
+	case ZMUX_CREDIT:
+		if (c != nullptr && frame.length >= 2)
+		{
+			c->grantMux(frame.payload[0] | (frame.payload[1] << 8));
+		}
+		break;
+	case ZMUX_OPEN:
+	{
+		if (frame.channel != 0 || frame.length == 0 || frame.length >= sizeof(PBEntry::address) || muxOpens.size() >= ZMUX_MAX_OPENS)
+		{
+			mux.send(Serial2, 0, ZMUX_ERROR, frame.payload, frame.length);
+			break;
+		}
+		char address[sizeof(PBEntry::address)];
+		memcpy(address, frame.payload, frame.length);
+		address[frame.length] = '\0';
+		muxOpens.add(address);
+		break;
+	}
+	case ZMUX_CLOSE:
+		if (c != nullptr)
+		{
+			c->stop();
+			closeMuxChannel(index);
+		}
+		mux.send(Serial2, frame.channel, ZMUX_CLOSE, nullptr, 0);
+		break;
+	case ZMUX_EXIT:
+		switchTo(ZCOMMAND_MODE, ZOK);
+		break;
+	default:
+		mux.send(Serial2, frame.channel, ZMUX_ERROR, &frame.type, 1);
+		break;
+	}
+}
+
+void ZModem::pollMuxDial()
+{
+	if (!muxDialing)
+	{
+		if (muxOpens.size() == 0)
+		{
+			return;
+		}
+		// one dial at a time, the dialer already races the mirrors
+		PBEntry pbe;
+		memset(&pbe, 0, sizeof(pbe));
+		strncpy(pbe.address, muxOpens.shift().c_str(), sizeof(pbe.address) - 1);
+		DPRINTF("Mux dialing %s\n", pbe.address);
+		dialer.begin(pbe);
+		muxDialing = true;
+		return;
+	}
+	int winner = dialer.poll();
+	if (winner == ZDIALER_PENDING)
+	{
+		return;
+	}
+	muxDialing = false;
+	ZClient *client = new ZClient();
+	if (winner < 0 || !dialer.take(*client))
+	{
+		delete client;
+		mux.send(Serial2, 0, ZMUX_ERROR, (const uint8_t *)dialer.entry().address, strlen(dialer.entry().address));
+		return;
+	}
+	client->setNoDelay(true);
+	clients.add(client);
+	openMuxChannel(client);
+}
+
+void ZModem::openMuxChannel(ZClient *client)
+{
+	DPRINTF("Mux channel %d to %s\n", client->id(), client->host());
+	client->setMuxCredit(ZMUX_WINDOW);
+	mux.send(Serial2, client->id(), ZMUX_OPEN, (const uint8_t *)client->host(), strlen(client->host()));
+}
+
+void ZModem::closeMuxChannel(int index)
+{
+	ZClient *c = clients.get(index);
+	DPRINTF("Mux channel %d closed\n", c->id());
+	clients.remove(index);
+	if (c == socket)
+	{
+		socket = nullptr;
+	}
+	delete c;
+}
+
+void ZModem::dteTask()
+{
+	for (;;)
+	{
+		if (!bridgeRunning)
+		{
+			xEventGroupSetBits(bridgeEvents, BRIDGE_DTE_PARKED);
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			continue;
+		}
+		int64_t start = esp_timer_get_time();
+		Serial2.pollEvents();
+		// check escape sequence before reading on, data that arrived after
+		// the guard time ran out belongs to command mode
+		if (hwEscape)
+		{
+			checkEscapeTimer();
+		}
+		else if (esc.gt2 && (millis() - esc.gt2) > SREG.guardTime())
+		{
+			esc.gt2 = 0;
+			esc.len = 0;
+			escapeDetected = true;
+		}
+		bool busy = pumpSerialRx();
+		flow.update(uplink.used() + Serial2.available(), uplink.capacity() + Serial2.rxBufferCapacity());
+		busy = pumpSerialTx() || busy;
+		if (busy)
+		{
+			dteBusyTime += esp_timer_get_time() - start;
+		}
+		else if (Serial2.eventsEnabled())
+		{
+			// sleep until the UART or the network side has something for us
+			Serial2.waitForEvent(downlink.empty() ? pdMS_TO_TICKS(BRIDGE_IDLE_WAIT_MS) : 1);
+		}
+		else
+		{
+			vTaskDelay(1);
+		}
+	}
+}
+
+void ZModem::netTask()
+{
+	for (;;)
+	{
+		if (!bridgeRunning)
+		{
+			// one last try at what the DTE already sent; a closed or stalled
+			// socket must not keep bridgeStop() waiting, so the rest is dropped
+			if (!uplink.empty() && socket != nullptr && socket->connected())
+			{
+				pumpSocketTx();
+			}
+			uplink.skip(uplink.used());
+			xEventGroupSetBits(bridgeEvents, BRIDGE_NET_PARKED);
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			continue;
+		}
+		int64_t start = esp_timer_get_time();
+		bool busy = pumpSocketTx();
+		if (bridgeRunning)
+		{
+			busy = pumpSocketRx() || busy;
+			if (xmodem.enabled())
+			{
+				xmodem.poll();
 			}
 		}
-		lastCommand = sbuf;
+		if (busy)
+		{
+			netBusyTime += esp_timer_get_time() - start;
+		}
+		else
+		{
+			vTaskDelay(1);
+		}
+	}
+}
+
+void ZModem::bridgeStart()
+{
+	if (bridgeRunning || socket == nullptr)
+	{
+		return;
+	}
+	// data left over from another connection must not leak into this one
+	if (socket->id() != bridgeSocketId)
+	{
+		// clear() needs both tasks parked, which a timed out bridgeStop() did not wait for
+		xEventGroupWaitBits(bridgeEvents, BRIDGE_DTE_PARKED | BRIDGE_NET_PARKED, pdFALSE, pdTRUE,
+							pdMS_TO_TICKS(BRIDGE_STOP_WAIT_MS));
+		uplink.clear();
+		downlink.clear();
+		bridgeSocketId = socket->id();
+	}
+	if (bridgeUpTime == 0)
+	{
+		bridgeUpTime = esp_timer_get_time();
+	}
+	Serial2.setEventMode(SREG.uartEventsEnabled());
+	Serial2.setDmaMode(SREG.uartDmaEnabled());
+	hwEscape = SREG.hwEscapeEnabled() && Serial2.eventsEnabled() && Serial2.enablePatternDetect(SREG.escape(), SREG.guardTime());
+	lastDataAt = esp_timer_get_time();
+	escapeDetected = false;
+	flow.begin(SREG.flowControlMode());
+	// a fresh dictionary every time data mode is entered, the host resets on CONNECT
+	v42Active = SREG.compressionEnabled() && v42.begin();
+	if (SREG.xmodemSpoofing())
+	{
+		xmodem.begin(&ZModem::callbackXmodemRemote, &ZModem::callbackXmodemDte, this);
+	}
+	else
+	{
+		xmodem.end();
+	}
+	xEventGroupClearBits(bridgeEvents, BRIDGE_DTE_PARKED | BRIDGE_NET_PARKED);
+	bridgeRunning = true;
+	xTaskNotifyGive(dteTaskHandle);
+	xTaskNotifyGive(netTaskHandle);
+}
+
+void ZModem::bridgeStop()
+{
+	bridgeRunning = false;
+	Serial2.wake();
+	EventBits_t parked = xEventGroupWaitBits(bridgeEvents, BRIDGE_DTE_PARKED | BRIDGE_NET_PARKED, pdFALSE, pdTRUE,
+											 pdMS_TO_TICKS(BRIDGE_STOP_WAIT_MS));
+	if ((parked & BRIDGE_NET_PARKED) == 0)
+	{
+		// still inside a socket write; it drops the uplink and parks as soon
+		// as the write returns, clear() is not safe from here until then
+		DPRINTLN("NET task still writing, uplink will be dropped");
+	}
+	if (hwEscape)
+	{
+		esp_timer_stop(escTimer);
+		Serial2.disablePatternDetect();
+		hwEscape = false;
+	}
+	if (v42Active)
+	{
+		// ETM tells the host that what follows, the result code, is plain again
+		size_t len = v42.finish(packedChunk);
+		v42BytesOut += len;
+		Serial2.write(packedChunk, len);
+	}
+	v42Active = false;
+	// commands must get through regardless of the network
+	flow.release();
+	escapeDetected = false;
+}
+
+constexpr ZCommandEntry<ZModem> ZModem::COMMANDS[] = {
+	{"$dma", &ZModem::atDma},
+	{"$mdns", &ZModem::atHostname},
+	{"$pass", &ZModem::atPassword},
+	{"$sb", &ZModem::atSerialBaud},
+	{"$ssid", &ZModem::atSSID},
+	{"$xmodem", &ZModem::atXmodem},
+	{"%c", &ZModem::atCompression},
+	{"&d", &ZModem::atIgnore},
+	{"&f", &ZModem::atFactory},
+	{"&g", &ZModem::atIgnore},
+	{"&h", &ZModem::atIgnore},
+	{"&k", &ZModem::atFlowControl},
+	{"&l", &ZModem::atIgnore},
+	{"&m", &ZModem::atIgnore},
+	{"&n", &ZModem::atIgnore},
+	{"&o", &ZModem::atIgnore},
+	{"&p", &ZModem::atIgnore},
+	{"&s", &ZModem::atIgnore},
+	{"&t", &ZModem::atTime},
+	{"&u", &ZModem::atIgnore},
+	{"&v", &ZModem::atConfiguration},
+	{"&w", &ZModem::atWriteProfile},
+	{"&y", &ZModem::atActiveProfile},
+	{"+bench", &ZModem::atBench},
+	{"+console", &ZModem::atConsole},
+	{"+mux", &ZModem::atMux},
+	{"+ppp", &ZModem::atPpp},
+	{"+rst", &ZModem::atRestart},
+	{"+shell", &ZModem::atShell},
+	{"+slip", &ZModem::atSlip},
+	{"a", &ZModem::atAnswer},
+	{"b", &ZModem::atBaud},
+	{"c", &ZModem::atConnect},
+	{"d", &ZModem::atDial},
+	{"e", &ZModem::atEcho},
+	{"f", &ZModem::atIgnore},
+	{"h", &ZModem::atHangup},
+	{"i", &ZModem::atInfo},
+	{"l", &ZModem::atVolume},
+	{"m", &ZModem::atSpeaker},
+	{"n", &ZModem::atListen},
+	{"o", &ZModem::atOnline},
+	{"p", &ZModem::atPhonebook},
+	{"q", &ZModem::atQuiet},
+	{"r", &ZModem::atIgnore},
+	{"s", &ZModem::atRegister},
+	{"t", &ZModem::atIgnore},
+	{"v", &ZModem::atVerbose},
+	{"w", &ZModem::atWiFi},
+	{"x", &ZModem::atIgnore},
+	{"y", &ZModem::atLongSpace},
+	{"z", &ZModem::atReset}};
+
+constexpr size_t ZModem::COMMAND_COUNT = sizeof(ZModem::COMMANDS) / sizeof(ZModem::COMMANDS[0]);
+
+ZResult ZModem::execCommand()
+{
+	bool found = parser.begin((const char *)buffer, buflen);
+	buffer[0] = '\0';
+	buflen = 0;
+	return found ? execCommandFrom(ZOK) : ZERROR;
+}
+
+ZResult ZModem::execQueuedCommand()
+{
+	bool found = parser.begin(cmdQueue[queueHead], MAX_COMMAND_SIZE);
+	queueHead = (queueHead + 1) % MAX_QUEUED_COMMANDS;
+	queueCount--;
+	return found ? execCommandFrom(ZOK) : ZERROR;
+}
+
+ZResult ZModem::execCommandFrom(ZResult rc)
+{
+	static_assert(commandTableSorted(COMMANDS, COMMAND_COUNT), "COMMANDS must be sorted by key");
+	ZCommand c;
+
+	while (parser.next(c))
+	{
+		DPRINTF("Command: %s\n", parser.current());
+		DPRINTF("Proc: %s %lu '%s'\n", c.name, c.vval, c.vbuf);
+		const ZCommandEntry<ZModem> *entry = commandLookup(COMMANDS, COMMAND_COUNT, c.name);
+		rc = entry != nullptr ? (this->*entry->handler)(c, rc) : ZERROR;
+		if (rc == ZPENDING)
+		{
+			// the rest of the line runs once the operation completes
+			return rc;
+		}
+	}
+	return rc;
+}
+
+ZResult ZModem::atIgnore(const ZCommand &c, ZResult rc)
+{
+	DPRINTLN(c.name);
+	return rc;
+}
+
+ZResult ZModem::atAnswer(const ZCommand &c, ZResult rc)
+{
+	return execAnswer(c.vval, c.vbuf, c.vlen, c.isNumber);
+}
+
+ZResult ZModem::atBaud(const ZCommand &c, ZResult rc)
+{
+	return execBaud(c.vval, c.vbuf, c.vlen);
+}
+
+ZResult ZModem::atConnect(const ZCommand &c, ZResult rc)
+{
+	return execConnect(c.vval, c.vbuf, c.vlen, c.isNumber, c.dmodifiers);
+}
+
+ZResult ZModem::atDial(const ZCommand &c, ZResult rc)
+{
+	return execDial(c.vval, c.vbuf, c.vlen, c.isNumber, c.dmodifiers);
+}
+
+ZResult ZModem::atEcho(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber)
+		return ZERROR;
+	SREG.setEchoEnabled(c.vval > 0);
+	return rc;
+}
+
+ZResult ZModem::atHangup(const ZCommand &c, ZResult rc)
+{
+	return execHangup(c.vval, c.vbuf, c.vlen, c.isNumber);
+}
+
+ZResult ZModem::atInfo(const ZCommand &c, ZResult rc)
+{
+	return execInfo(c.vval, c.vbuf, c.vlen, c.isNumber);
+}
+
+ZResult ZModem::atVolume(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber || c.vval < 0 || c.vval > 3)
+		return ZERROR;
+	SREG.setSpeakerVolume(c.vval);
+	return rc;
+}
+
+ZResult ZModem::atSpeaker(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber || c.vval < 0 || c.vval > 3)
+		return ZERROR;
+	SREG.setSpeakerControl(c.vval);
+	return rc;
+}
+
+ZResult ZModem::atListen(const ZCommand &c, ZResult rc)
+{
+	return execListen(c.vval, c.vbuf, c.vlen, c.isNumber, c.dmodifiers);
+}
+
+ZResult ZModem::atOnline(const ZCommand &c, ZResult rc)
+{
+	if (c.vlen > 0 && c.vval != 0)
+	{
+		return c.isNumber ? execDial(c.vval, c.vbuf, c.vlen, c.isNumber, "") : ZERROR;
+	}
+	if (socket == nullptr || !socket->connected())
+	{
+		return ZERROR;
+	}
+	return goOnline(ZOK);
+}
+
+ZResult ZModem::atPhonebook(const ZCommand &c, ZResult rc)
+{
+	return execPhonebook(c.vval, c.vbuf, c.vlen, c.isNumber, c.dmodifiers);
+}
+
+ZResult ZModem::atQuiet(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber)
+		return ZERROR;
+	SREG.setResultCodeEnabled(c.vval == 0);
+	return rc;
+}
+
+ZResult ZModem::atRegister(const ZCommand &c, ZResult rc)
+{
+	return execSRegister(c.vbuf, c.vlen);
+}
+
+ZResult ZModem::atVerbose(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber)
+		return ZERROR;
+	SREG.setResultCodeNumeric(c.vval == 0);
+	return rc;
+}
+
+ZResult ZModem::atWiFi(const ZCommand &c, ZResult rc)
+{
+	return execWiFi(c.vval, c.vbuf, c.vlen, c.isNumber, c.dmodifiers);
+}
+
+ZResult ZModem::atLongSpace(const ZCommand &c, ZResult rc)
+{
+	return c.isNumber ? ZOK : ZERROR;
+}
+
+ZResult ZModem::atReset(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber || c.vval < 0 || c.vval > 2)
+		return ZERROR;
+	DPRINTLN("Reset and Restore Profile");
+	for (int i = 0; i < clients.size(); i++)
+	{
+		ZClient *client = clients.get(i);
+		client->stop();
+		delay(50);
+		delete client;
+	}
+	clients.clear();
+	socket = nullptr;
+	SREG.loadProfile(int(c.vval));
+	return rc;
+}
+
+ZResult ZModem::atFlowControl(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber || c.vval >= FCM_INVALID)
+		return ZERROR;
+	SREG.setFlowControlMode((FlowControlMode)c.vval);
+	Serial2.setFlowControl(SREG.flowControlMode());
+	return rc;
+}
+
+ZResult ZModem::atConfiguration(const ZCommand &c, ZResult rc)
+{
+	sendConfiguration();
+	return sendReport(rc);
+}
+
+ZResult ZModem::atWriteProfile(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber || c.vval < 0 || c.vval >= MAX_USER_PROFILES)
+		return ZERROR;
+	SREG.saveProfile(int(c.vval));
+	return rc;
+}
+
+ZResult ZModem::atFactory(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber || c.vval < 0 || c.vval >= MAX_USER_PROFILES)
+		return ZERROR;
+	SREG.loadProfile(-1);
+	return rc;
+}
+
+ZResult ZModem::atActiveProfile(const ZCommand &c, ZResult rc)
+{
+	if (!c.isNumber || c.vval < 0 || c.vval >= MAX_USER_PROFILES)
+		return ZERROR;
+	ZProfile::setActiveProfile(c.vval);
+	return rc;
+}
+
+ZResult ZModem::atTime(const ZCommand &c, ZResult rc)
+{
+	return execTime(c.vval, c.vbuf, c.vlen, c.isNumber);
+}
+
+ZResult ZModem::atCompression(const ZCommand &c, ZResult rc)
+{
+	// AT%C0 plain DTE link, AT%C1 V.42bis compressed data mode
+	if (c.vlen > 0 && c.vbuf[0] == '?')
+	{
+		sendNewline();
+		Serial2.print(SREG.compressionEnabled() ? 1 : 0);
+		return rc;
+	}
+	if (!c.isNumber || c.vval > 1)
+		return ZERROR;
+	if (c.vval == 1 && !v42.begin())
+		return ZERROR;
+	SREG.setCompressionEnabled(c.vval == 1);
+	if (c.vval == 0)
+		v42.end();
+	return rc;
+}
+
+ZResult ZModem::atConsole(const ZCommand &c, ZResult rc)
+{
+	switchTo(ZCONSOLE_MODE);
+	return rc;
+}
+
+ZResult ZModem::atShell(const ZCommand &c, ZResult rc)
+{
+	switchTo(ZSHELL_MODE);
+	return rc;
+}
+
+ZResult ZModem::atRestart(const ZCommand &c, ZResult rc)
+{
+	ESP.restart();
+	return rc;
+}
+
+ZResult ZModem::atBench(const ZCommand &c, ZResult rc)
+{
+	return execBenchmark();
+}
+
+ZResult ZModem::atMux(const ZCommand &c, ZResult rc)
+{
+	switchTo(ZMUX_MODE);
+	return rc;
+}
+
+ZResult ZModem::atSlip(const ZCommand &c, ZResult rc)
+{
+	return execGateway(ZGATEWAY_SLIP);
+}
+
+ZResult ZModem::atPpp(const ZCommand &c, ZResult rc)
+{
+	return execGateway(ZGATEWAY_PPP);
+}
+
+ZResult ZModem::atSSID(const ZCommand &c, ZResult rc)
+{
+	if (c.vlen == 0 || c.vlen >= (int)sizeof(SREG.wifiSSID))
+		return ZERROR;
+	strcpy(SREG.wifiSSID, (const char *)c.vbuf);
+	return rc;
+}
+
+ZResult ZModem::atPassword(const ZCommand &c, ZResult rc)
+{
+	if (c.vlen >= (int)sizeof(SREG.wifiPSWD))
+		return ZERROR;
+	strcpy(SREG.wifiPSWD, (const char *)c.vbuf);
+	return rc;
+}
+
+ZResult ZModem::atHostname(const ZCommand &c, ZResult rc)
+{
+	if (c.vlen == 0 || c.vlen >= (int)sizeof(SREG.hostname))
+		return ZERROR;
+	strcpy(SREG.hostname, (const char *)c.vbuf);
+	return rc;
+}
+
+ZResult ZModem::atSerialBaud(const ZCommand &c, ZResult rc)
+{
+	if (c.vlen == 0)
+		return ZERROR;
+	return execBaud(c.vval, c.vbuf, c.vlen);
+}
+
+ZResult ZModem::atXmodem(const ZCommand &c, ZResult rc)
+{
+	if (c.vlen == 0)
+		return ZERROR;
+	SREG.setXmodemSpoofing(c.vval != 0);
+	return rc;
+}
+
+ZResult ZModem::atDma(const ZCommand &c, ZResult rc)
+{
+	if (c.vlen == 0)
+		return ZERROR;
+	SREG.setUartDmaEnabled(c.vval != 0);
+	return Serial2.setDmaMode(SREG.uartDmaEnabled()) ? rc : ZERROR;
+}
+
+ZResult ZModem::beginOperation(ZOperation op)
+{
+	operation = op;
+	opStarted = millis();
+	// lines sent along with this one are type-ahead, keystrokes from now on abort
+	while (Serial2.available() > 0)
+	{
+		if (readSerialStream())
+		{
+			queueCommand();
+		}
+	}
+	return ZPENDING;
+}
+
+void ZModem::queueCommand()
+{
+	if (queueCount < MAX_QUEUED_COMMANDS)
+	{
+		memcpy(cmdQueue[(queueHead + queueCount) % MAX_QUEUED_COMMANDS], buffer, buflen + 1);
+		queueCount++;
+	}
+	else
+	{
+		DPRINTF("Command queue full, dropped: %s\n", (char *)buffer);
+	}
+	buffer[0] = '\0';
+	buflen = 0;
+}
+
+ZResult ZModem::pollOperation()
+{
+	switch (operation)
+	{
+	case ZOP_SCAN:
+	{
+		int n = WiFi.scanComplete();
+		if (n == WIFI_SCAN_RUNNING)
+		{
+			return ZPENDING;
+		}
+		if (n < 0)
+		{
+			return ZERROR;
+		}
+		sendScanResults(n);
+		return sendReport(ZOK);
+	}
+	case ZOP_WIFI:
+	{
+		ZResult rc = pollWiFi();
+		if (rc == ZOK)
+		{
+			strcpy(SREG.wifiSSID, opSSID.c_str());
+			strcpy(SREG.wifiPSWD, opPSWD.c_str());
+			setStaticIPs(opIP[0], opIP[1], opIP[2], opIP[3]);
+			for (int i = 0; i < 4; i++)
+			{
+				opIP[i] = nullptr;
+			}
+		}
+		else if (rc == ZERROR)
+		{
+			freeOperationIPs();
+		}
 		return rc;
 	}
-	return ZERROR;
+	case ZOP_DIAL:
+		return pollDial();
+	case ZOP_REPORT:
+		return pollReport();
+	case ZOP_BAUD:
+		if ((millis() - opStarted) < BAUD_SETTLE_TIME)
+		{
+			return ZPENDING;
+		}
+		Serial2.end();
+		SREG.baudRate = opCount;
+		Serial2.begin(opCount);
+		digitalWrite(PIN_LED_HS, opCount >= DEFAULT_HS_RATE ? HIGH : LOW);
+		return ZOK;
+	default:
+		return ZOK;
+	}
+}
+
+void ZModem::abortOperation()
+{
+	DPRINTF("Abort operation %d\n", operation);
+	switch (operation)
+	{
+	case ZOP_SCAN:
+		// the driver finishes the scan on its own, its results are dropped
+		WiFi.scanDelete();
+		break;
+	case ZOP_WIFI:
+		WiFi.disconnect();
+		digitalWrite(PIN_LED_WIFI, LOW);
+		freeOperationIPs();
+		break;
+	case ZOP_REPORT:
+		report.begin();
+		break;
+	case ZOP_DIAL:
+		dialer.abort();
+		if (opClient != nullptr)
+		{
+			opClient->stop();
+			delete opClient;
+			opClient = nullptr;
+		}
+		break;
+	default:
+		break;
+	}
+	operation = ZOP_NONE;
+	queueCount = 0;
+}
+
+void ZModem::tickOperation()
+{
+	ZResult rc;
+	if (Serial2.available() > 0)
+	{
+		// any keystroke aborts, as on a Hayes modem; one that starts a
+		// new AT command is kept, anything else is swallowed
+		if (lc(Serial2.peek()) != 'a')
+		{
+			Serial2.read();
+		}
+		rc = operation == ZOP_DIAL ? ZNOCARRIER : ZERROR;
+		abortOperation();
+	}
+	else
+	{
+		rc = pollOperation();
+		if (rc == ZPENDING)
+		{
+			return;
+		}
+		operation = ZOP_NONE;
+		rc = execCommandFrom(rc);
+	}
+	if (SREG.resultCodeEnabled())
+	{
+		sendResponse(rc);
+	}
 }
 
 ZResult ZModem::execInfo(int vval, uint8_t *vbuf, int vlen, bool isNumber)
@@ -1169,67 +1822,169 @@ ZResult ZModem::execInfo(int vval, uint8_t *vbuf, int vlen, bool isNumber)
 		sendConfiguration();
 		break;
 	case 2:
-		sendNewline();
-		Serial2.print(WiFi.localIP().toString());
+		sendNewline(report);
+		report.print(WiFi.localIP().toString());
 		break;
 	case 3:
-		sendNewline();
-		Serial2.print(SREG.wifiSSID);
+		sendNewline(report);
+		report.print(SREG.wifiSSID);
 		break;
 	case 4:
-		sendNewline();
-		Serial2.print(ZMODEM_VERSION);
+		sendNewline(report);
+		report.print(ZMODEM_VERSION);
 		break;
 	case 6:
-		sendNewline();
-		Serial2.print(WiFi.macAddress());
+		sendNewline(report);
+		report.print(WiFi.macAddress());
 		break;
 	case 7:
 		struct tm now;
 		if (getLocalTime(&now))
 		{
-			sendNewline();
-			Serial2.print(&now, "%A, %B %d %Y %H:%M:%S");
+			sendNewline(report);
+			report.print(&now, "%A, %B %d %Y %H:%M:%S");
 		}
 		break;
 	case 8:
-		sendNewline();
-		Serial2.print(compile_date);
+		sendNewline(report);
+		report.print(compile_date);
 		break;
 	case 9:
-		sendNewline();
-		Serial2.print(SREG.wifiSSID);
+		sendNewline(report);
+		report.print(SREG.wifiSSID);
 		if (staticIP != nullptr)
 		{
-			sendNewline();
-			Serial2.print(staticIP->toString());
-			sendNewline();
-			Serial2.print(staticSN->toString());
-			sendNewline();
-			Serial2.print(staticGW->toString());
-			sendNewline();
-			Serial2.print(staticDNS->toString());
+			sendNewline(report);
+			report.print(staticIP->toString());
+			sendNewline(report);
+			report.print(staticSN->toString());
+			sendNewline(report);
+			report.print(staticGW->toString());
+			sendNewline(report);
+			report.print(staticDNS->toString());
 		}
 		break;
 	case 11:
-		sendNewline();
-		Serial2.print(ESP.getFreeHeap());
+		sendNewline(report);
+		report.print(ESP.getFreeHeap());
 		break;
 	case 12:
-		sendNewline();
-		Serial2.printf("TX Total bytes: %lu", totalBytesTx);
-		sendNewline();
-		Serial2.printf("RX Total bytes: %lu", totalBytesRx);
-		sendNewline();
-		Serial2.printf("TX Max Rate: %lu bytes/sec", maxRateTx);
-		sendNewline();
-		Serial2.printf("RX Max Rate: %lu bytes/sec", maxRateRx);
+		sendNewline(report);
+		report.format("TX Total bytes: %lu", totalBytesTx);
+		sendNewline(report);
+		report.format("RX Total bytes: %lu", totalBytesRx);
+		sendNewline(report);
+		report.format("TX Max Rate: %lu bytes/sec", maxRateTx);
+		sendNewline(report);
+		report.format("RX Max Rate: %lu bytes/sec", maxRateRx);
+		if (socket != nullptr && socket->telnetMode())
+		{
+			sendNewline(report);
+			report.format("MCCP %s: %lu compressed, %lu decompressed bytes", socket->compressing() ? "ON" : "OFF", socket->compressedBytes(), socket->decompressedBytes());
+		}
+		if (socket != nullptr && socket->secure())
+		{
+			sendNewline(report);
+			report.format("TLS %s: %s handshake %lu ms", socket->tls()->cipher(), socket->tls()->resumed() ? "resumed" : "full", socket->tls()->handshakeTime());
+		}
+		sendNewline(report);
+		report.format("TLS sessions: %lu handshakes, %lu resumed", TlsSessions.handshakes(), TlsSessions.resumed());
+		break;
+	case 13:
+	{
+		unsigned long elapsed = bridgeUpTime ? (unsigned long)((esp_timer_get_time() - bridgeUpTime) / 1000) : 0;
+		sendNewline(report);
+		report.format("Uplink buffer: %u/%u bytes peak", uplink.highWaterMark(), uplink.capacity());
+		sendNewline(report);
+		report.format("Downlink buffer: %u/%u bytes peak", downlink.highWaterMark(), downlink.capacity());
+		sendNewline(report);
+		report.format("DTE task: %lu ms busy of %lu ms", (unsigned long)(dteBusyTime / 1000), elapsed);
+		sendNewline(report);
+		report.format("NET task: %lu ms busy of %lu ms", (unsigned long)(netBusyTime / 1000), elapsed);
+		sendNewline(report);
+		report.format("NET writes: %lu", netWrites);
+		sendNewline(report);
+		report.format("UART events: %s", Serial2.eventsEnabled() ? "ON" : "OFF");
+		sendNewline(report);
+		report.format("UART overflows: %lu fifo, %lu buffer", Serial2.statistics().fifoOverflows, Serial2.statistics().bufferFull);
+		sendNewline(report);
+		report.format("UART breaks: %lu, errors: %lu frame, %lu parity, patterns: %lu", Serial2.statistics().breaks, Serial2.statistics().frameErrors, Serial2.statistics().parityErrors, Serial2.statistics().patterns);
+		sendNewline(report);
+		report.format("UART DMA: %s, %lu bytes, %lu blocks, %lu overruns", Serial2.dmaEnabled() ? "ON" : "OFF", Serial2.dmaStatistics().bytes, Serial2.dmaStatistics().blocks, Serial2.dmaStatistics().overruns);
+		sendNewline(report);
+		report.format("UART buffers: %u rx, %u tx, FIFO threshold %u", Serial2.rxBufferCapacity(), Serial2.txBufferCapacity(), Serial2.flowControlThreshold());
+		sendNewline(report);
+		report.format("Flow holds: %lu, %lu ms held, longest %lu ms", flow.statistics().holds, flow.statistics().heldTime, flow.statistics().longestHold);
+		sendNewline(report);
+		report.format("Flow unprotected holds: %lu, socket stalls: %lu", flow.statistics().unprotected, flow.statistics().socketStalls);
+		sendNewline(report);
+		report.format("V.42bis: %s, %lu in, %lu out, %lu us", SREG.compressionEnabled() ? "ON" : "OFF", v42BytesIn, v42BytesOut, (unsigned long)v42Time);
+		sendNewline(report);
+		report.format("XMODEM: %lu transfers, %lu blocks, %lu local NAKs, %lu resent, %lu cancels", xmodem.statistics().transfers, xmodem.statistics().blocks, xmodem.statistics().localNaks, xmodem.statistics().resent, xmodem.statistics().cancels);
+		sendNewline(report);
+		report.format("Mux frames: %lu in, %lu out, %lu CRC errors, %lu oversize", mux.statistics().framesIn, mux.statistics().framesOut, mux.statistics().crcErrors, mux.statistics().oversize);
+		sendNewline(report);
+		report.format("Gateway: %lu bytes in, %lu out, %lu SLIP frames in, %lu out, %lu errors", gateway.statistics().bytesIn, gateway.statistics().bytesOut, gateway.statistics().framesIn, gateway.statistics().framesOut, gateway.statistics().errors);
+		break;
+	}
+	case 14:
+		sendNewline(report);
+		report.format("DNS cache: %lu hits, %lu misses, %lu failures", Resolver.hits(), Resolver.misses(), Resolver.failures());
+		sendNewline(report);
+		report.format("DNS wait: %lu ms total", Resolver.waitTime());
+		sendNewline(report);
+		report.format("Race dials: %lu, last %lu ms", dialer.races(), dialer.lastTime());
+		for (int i = 0; i < Resolver.size(); i++)
+		{
+			ZResolverEntry &e = Resolver.entry(i);
+			if (e.state == ZRESOLVER_EMPTY)
+			{
+				continue;
+			}
+			sendNewline(report);
+			if (e.state == ZRESOLVER_PENDING)
+				report.format("%s PENDING", e.host);
+			else if (e.state == ZRESOLVER_FAILED)
+				report.format("%s FAILED", e.host);
+			else
+				report.format("%s %s %lus %lu", e.host, IPAddress(e.addr).toString().c_str(), Resolver.timeToLive(e), e.hits);
+		}
 		break;
 	default:
-		sendNewline();
-		return ZERROR;
+		sendNewline(report);
+		return sendReport(ZERROR);
 	}
 
+	return sendReport(ZOK);
+}
+
+ZResult ZModem::execBenchmark()
+{
+	// UART loopback at multi-megabit rates, through the driver and through DMA
+	static const unsigned long rates[] = {1000000, 2000000};
+	bool dma = SREG.uartDmaEnabled();
+	// the test reinstalls the UART driver, which replaces the event queue;
+	// only run it while nothing is set up to wait on that queue
+	if (SREG.uartEventsEnabled() || Serial2.eventsEnabled())
+	{
+		return ZERROR;
+	}
+	for (int backend = 0; backend < 2; backend++)
+	{
+		if (!Serial2.setDmaMode(backend == 1))
+		{
+			sendNewline();
+			Serial2.print("DMA unavailable");
+			break;
+		}
+		for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+		{
+			ZSerialBench r = Serial2.loopbackTest(rates[i], ZSERIAL_BENCH_BYTES);
+			sendNewline();
+			Serial2.printf("%lu bps %s: %u sent, %u lost, %u gaps, %lu kB/s", r.baud, backend ? "DMA" : "driver", r.sent, r.sent - r.received, r.gaps, r.micros ? (unsigned long)((unsigned long long)r.received * 1000 / r.micros) : 0);
+		}
+	}
+	Serial2.setDmaMode(dma);
 	return ZOK;
 }
 
@@ -1249,22 +2004,12 @@ ZResult ZModem::execWiFi(int vval, uint8_t *vbuf, int vlen, bool isNumber, const
 {
 	if (vlen == 0 || vval > 0)
 	{
-		int n = WiFi.scanNetworks();
-		if (vval > 0 && vval < n)
-		{
-			n = vval;
-		}
-		sendNewline();
-		for (int i = 0; i < n; ++i)
+		if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED)
 		{
-			Serial2.print(WiFi.SSID(i));
-			Serial2.print(" (");
-			Serial2.print(WiFi.RSSI(i));
-			Serial2.print(")");
-			Serial2.print(WiFi.encryptionType(i) == ENC_TYPE_NONE ? " " : "*");
-			sendNewline();
-			delay(10);
+			return ZERROR;
 		}
+		opCount = vval;
+		return beginOperation(ZOP_SCAN);
 	}
 	else
 	{
@@ -1337,38 +2082,61 @@ ZResult ZModem::execWiFi(int vval, uint8_t *vbuf, int vlen, bool isNumber, const
 			}
 		}
 
-		if (!connectWiFi(ssid, pswd, ip[0], ip[1], ip[2], ip[3]))
+		for (int i = 0; i < 4; i++)
 		{
-			for (int i = 0; i < 4; i++)
-			{
-				if (ip[i] != nullptr)
-				{
-					free(ip[i]);
-				}
-			}
+			opIP[i] = ip[i];
+		}
+		opSSID = ssid;
+		opPSWD = pswd;
+		if (!beginWiFi(ssid, pswd, ip[0], ip[1], ip[2], ip[3]))
+		{
+			freeOperationIPs();
 			digitalWrite(PIN_LED_WIFI, LOW);
 			return ZERROR;
 		}
-		strcpy(SREG.wifiSSID, ssid);
-		strcpy(SREG.wifiPSWD, pswd);
-		setStaticIPs(ip[0], ip[1], ip[2], ip[3]);
-		digitalWrite(PIN_LED_WIFI, HIGH);
+		return beginOperation(ZOP_WIFI);
 	}
 	return ZOK;
 }
 
+void ZModem::sendScanResults(int n)
+{
+	if (opCount > 0 && opCount < n)
+	{
+		n = opCount;
+	}
+	sendNewline(report);
+	for (int i = 0; i < n; ++i)
+	{
+		report.print(WiFi.SSID(i));
+		report.print(" (");
+		report.print(WiFi.RSSI(i));
+		report.print(")");
+		report.print(WiFi.encryptionType(i) == ENC_TYPE_NONE ? " " : "*");
+		sendNewline(report);
+	}
+	WiFi.scanDelete();
+}
+
+void ZModem::freeOperationIPs()
+{
+	for (int i = 0; i < 4; i++)
+	{
+		if (opIP[i] != nullptr)
+		{
+			free(opIP[i]);
+			opIP[i] = nullptr;
+		}
+	}
+}
+
 ZResult ZModem::execBaud(int vval, uint8_t *vbuf, int vlen)
 {
 	DPRINTF("change baud rate to: %d\n", vval);
 	Serial2.flush();
-	delay(500);
-	Serial2.end();
-
-	SREG.baudRate = vval;
-	Serial2.begin(vval);
-	digitalWrite(PIN_LED_HS, vval >= DEFAULT_HS_RATE ? HIGH : LOW);
-
-	return ZOK;
+	// the line settles for BAUD_SETTLE_TIME before switching, see pollOperation()
+	opCount = vval;
+	return beginOperation(ZOP_BAUD);
 }
 
 ZResult ZModem::execDial(unsigned long vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers)
@@ -1379,7 +2147,7 @@ ZResult ZModem::execDial(unsigned long vval, uint8_t *vbuf, int vlen, bool isNum
 		{
 			return ZERROR;
 		}
-		switchTo(ZSTREAM_MODE);
+		return goOnline(ZOK);
 	}
 	else if (vval >= 0 && isNumber)
 	{
@@ -1389,7 +2157,7 @@ ZResult ZModem::execDial(unsigned long vval, uint8_t *vbuf, int vlen, bool isNum
 		{
 			PBEntry pbe;
 			Phonebook.get(i, &pbe);
-			return execDial(0, (uint8_t *)pbe.address, strlen(pbe.address), false, pbe.modifiers);
+			return beginDial(pbe, pbe.modifiers, true, pbe.endpoints() > 1);
 		}
 		for (i = 0; i < clients.size(); i++)
 		{
@@ -1397,43 +2165,103 @@ ZResult ZModem::execDial(unsigned long vval, uint8_t *vbuf, int vlen, bool isNum
 			if (c->id() == vval && c->connected())
 			{
 				socket = c;
-				switchTo(ZSTREAM_MODE);
-				return ZCONNECT;
+				return goOnline(ZCONNECT);
 			}
 		}
 		return ZERROR;
 	}
 	else
 	{
-		char *colon = strstr((char *)vbuf, ":");
-		int port = 23;
-		if (colon != NULL)
-		{
-			*colon = '\0';
-			port = atoi((char *)(++colon));
-		}
-		DPRINTF("Connecting to %s:%d ", (char *)vbuf, port);
-		ZClient *client = new ZClient();
-		if (client->connect((char *)vbuf, port))
-		{
-			DPRINTLN("OK");
-			client->setNoDelay(true);
-			if (strchr(dmodifiers, 'p') != NULL || strchr(dmodifiers, 'P') != NULL)
-				client->setPetsciiMode(true);
-			if (strchr(dmodifiers, 't') != NULL || strchr(dmodifiers, 'T') != NULL)
-				client->setTelnetMode(true);
-			socket = client;
-			clients.add(client);
-			switchTo(ZSTREAM_MODE);
-			return ZCONNECT;
-		}
-		DPRINTLN("FAILED");
-		delete client;
-		return ZNOANSWER;
+		PBEntry pbe;
+		memset(&pbe, 0, sizeof(pbe));
+		strncpy(pbe.address, (char *)vbuf, sizeof(pbe.address) - 1);
+		return beginDial(pbe, dmodifiers, true, false);
 	}
 	return ZOK;
 }
 
+ZResult ZModem::beginDial(const PBEntry &pbe, const char *dmodifiers, bool stream, bool save)
+{
+	DPRINTF("Dialing %s\n", pbe.address);
+	opModifiers = dmodifiers;
+	opStream = stream;
+	opSave = save;
+	dialer.begin(pbe);
+	return beginOperation(ZOP_DIAL);
+}
+
+ZResult ZModem::pollDial()
+{
+	if (opClient == nullptr)
+	{
+		int winner = dialer.poll();
+		if (winner == ZDIALER_PENDING)
+		{
+			return ZPENDING;
+		}
+		if (opSave && dialer.reordered())
+		{
+			// keep the measured latencies so the next dial tries the fastest mirror first,
+			// but only write flash when the mirror order changed
+			Phonebook.put(&dialer.entry());
+		}
+		opClient = new ZClient();
+		if (winner < 0 || !dialer.take(*opClient))
+		{
+			DPRINTLN("Dial FAILED");
+			delete opClient;
+			opClient = nullptr;
+			return ZNOANSWER;
+		}
+		if (strchr(opModifiers.c_str(), 's') != NULL && !opClient->startTls())
+		{
+			delete opClient;
+			opClient = nullptr;
+			return ZNOANSWER;
+		}
+	}
+	if (opClient->secure())
+	{
+		int rc = opClient->pollTls();
+		if (rc == ZTLS_PENDING)
+		{
+			return ZPENDING;
+		}
+		if (rc == ZTLS_FAILED)
+		{
+			opClient->stop();
+			delete opClient;
+			opClient = nullptr;
+			return ZNOANSWER;
+		}
+	}
+	ZClient *client = opClient;
+	opClient = nullptr;
+	applyModifiers(client, opModifiers.c_str());
+	clients.add(client);
+	socket = client;
+	if (opStream)
+	{
+		// lines typed during the dial were meant for command mode, not the remote
+		queueCount = 0;
+		return goOnline(ZCONNECT);
+	}
+	return ZCONNECT;
+}
+
+void ZModem::applyModifiers(ZClient *client, const char *dmodifiers)
+{
+	client->setNoDelay(true);
+	if (strchr(dmodifiers, 'p') != NULL || strchr(dmodifiers, 'P') != NULL)
+		client->setPetsciiMode(true);
+	if (strchr(dmodifiers, 't') != NULL || strchr(dmodifiers, 'T') != NULL)
+	{
+		client->setTelnetMode(true);
+		client->telnet().setTermType(termType.c_str());
+		client->telnet().setCompression(SREG.mccpEnabled());
+	}
+}
+
 ZResult ZModem::execConnect(int vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers)
 {
 	if (vlen == 0)
@@ -1466,22 +2294,27 @@ ZResult ZModem::execConnect(int vval, uint8_t *vbuf, int vlen, bool isNumber, co
 			return ZERROR;
 		}
 		// ATC0 Lists information about all of the network connections in the format
-		// [CONNECTION STATE] [CONNECTION ID] [CONNECTED TO HOST]:[CONNECTED TO PORT]
+		// [CONNECTION STATE] [CONNECTION ID] [CONNECTED TO HOST]:[CONNECTED TO PORT] [BUFFERED BYTES]
 		// including any Server (ATA) listeners.
 		if (vval == 0)
 		{
 			for (int i = 0; i < clients.size(); i++)
 			{
 				ZClient *c = clients.get(i);
-				if (c->connected())
+				if (c->ringing())
+				{
+					sendNewline();
+					Serial2.printf("%s %d %s:%d %u", "RINGING", c->id(), c->host(), c->port(), c->backlogLength());
+				}
+				else if (c->connected())
 				{
 					sendNewline();
-					Serial2.printf("%s %d %s:%d", "CONNECTED", c->id(), c->host(), c->port());
+					Serial2.printf("%s %d %s:%d %u", "CONNECTED", c->id(), c->host(), c->port(), c->backlogLength());
 				}
-				else if (socket->answered())
+				else if (c->answered() || c->backlogLength() > 0)
 				{
 					sendNewline();
-					Serial2.printf("%s %d %s:%d", "NO CARRIER", c->id(), c->host(), c->port());
+					Serial2.printf("%s %d %s:%d %u", "NO CARRIER", c->id(), c->host(), c->port(), c->backlogLength());
 				}
 			}
 			return ZOK;
@@ -1506,30 +2339,10 @@ ZResult ZModem::execConnect(int vval, uint8_t *vbuf, int vlen, bool isNumber, co
 		// ATC"[HOSTNAME]:[PORT]" creates a new connection to the given host and port,
 		// assigning a new id if the connection is successful, and making this connection
 		// the new current connection.  The quotes and colon are required.
-		char *colon = strstr((char *)vbuf, ":");
-		int port = 23;
-		if (colon != NULL)
-		{
-			*colon = '\0';
-			port = atoi((char *)(++colon));
-		}
-		DPRINTF("Connecting to %s:%d ", (char *)vbuf, port);
-		ZClient *client = new ZClient();
-		if (client->connect((char *)vbuf, port))
-		{
-			DPRINTLN("OK");
-			client->setNoDelay(true);
-			if (strchr(dmodifiers, 'p') != NULL || strchr(dmodifiers, 'P') != NULL)
-				client->setPetsciiMode(true);
-			if (strchr(dmodifiers, 't') != NULL || strchr(dmodifiers, 'T') != NULL)
-				client->setTelnetMode(true);
-			clients.add(client);
-			socket = client;
-			return ZCONNECT;
-		}
-		DPRINTLN("FAILED");
-		delete client;
-		return ZNOANSWER;
+		PBEntry pbe;
+		memset(&pbe, 0, sizeof(pbe));
+		strncpy(pbe.address, (char *)vbuf, sizeof(pbe.address) - 1);
+		return beginDial(pbe, dmodifiers, false, false);
 	}
 	return ZOK;
 }
@@ -1587,6 +2400,183 @@ ZResult ZModem::execHangup(int vval, uint8_t *vbuf, int vlen, bool isNumber)
 	return ZERROR;
 }
 
+ZResult ZModem::execListen(int vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers)
+{
+	if (vlen == 1 && *vbuf == '?')
+	{
+		// ATN? shows the configured port and whether the listener is open
+		sendNewline();
+		Serial2.printf("%d %s", SREG.listenPort, listener != nullptr ? "LISTENING" : "CLOSED");
+		return ZOK;
+	}
+	if (vlen > 0 && (!isNumber || vval < 0 || vval > 65535))
+	{
+		return ZERROR;
+	}
+	if (vlen > 0)
+	{
+		// ATN0 closes the listener, ATNn opens one on port n
+		SREG.listenPort = vval;
+	}
+	else if (SREG.listenPort == 0)
+	{
+		return ZERROR;
+	}
+	listenModifiers = dmodifiers;
+	if (listener != nullptr)
+	{
+		listener->end();
+		delete listener;
+		listener = nullptr;
+		listenerPort = 0;
+	}
+	pollListener();
+	return (SREG.listenPort == 0 || listener != nullptr) ? ZOK : ZERROR;
+}
+
+ZResult ZModem::execAnswer(int vval, uint8_t *vbuf, int vlen, bool isNumber)
+{
+	if (vlen > 0 && !isNumber)
+	{
+		return ZERROR;
+	}
+	// ATA picks up the oldest ringing caller, ATAn the caller with id n
+	for (int i = 0; i < clients.size(); i++)
+	{
+		ZClient *c = clients.get(i);
+		if (c->ringing() && (vlen == 0 || c->id() == vval))
+		{
+			return answerCaller(c);
+		}
+	}
+	return ZERROR;
+}
+
+ZResult ZModem::answerCaller(ZClient *caller)
+{
+	if (!caller->connected())
+	{
+		return ZNOCARRIER;
+	}
+	DPRINTF("Answer %d from %s\n", caller->id(), caller->host());
+	caller->answer();
+	socket = caller;
+	stopRinging();
+	return goOnline(ZCONNECT);
+}
+
+void ZModem::stopRinging()
+{
+	if (ringActive)
+	{
+		digitalWrite(PIN_RI, !RI_ACTIVE);
+	}
+	ringActive = false;
+	ringTimer = 0;
+	SREG[1] = 0;
+}
+
+void ZModem::pollListener()
+{
+	if (listener != nullptr && listenerPort != SREG.listenPort)
+	{
+		listener->end();
+		delete listener;
+		listener = nullptr;
+		listenerPort = 0;
+	}
+	if (listener == nullptr)
+	{
+		if (SREG.listenPort == 0 || WiFi.status() != WL_CONNECTED)
+		{
+			return;
+		}
+		DPRINTF("Listening on port %d\n", SREG.listenPort);
+		listener = new WiFiServer(SREG.listenPort, LISTEN_BACKLOG);
+		listener->begin();
+		listener->setNoDelay(true);
+		listenerPort = SREG.listenPort;
+	}
+
+	// accept without blocking, queue up to MAX_PENDING_CALLERS and turn the rest away
+	int pending = 0;
+	for (int i = 0; i < clients.size(); i++)
+	{
+		ZClient *c = clients.get(i);
+		if (c->ringing())
+		{
+			if (c->connected())
+			{
+				pending++;
+			}
+			else
+			{
+				DPRINTF("Caller %d hung up\n", c->id());
+				clients.remove(i--);
+				delete c;
+			}
+		}
+	}
+	while (listener->hasClient())
+	{
+		WiFiClient incoming = listener->available();
+		if (pending >= MAX_PENDING_CALLERS)
+		{
+			incoming.print(LISTEN_BUSY_BANNER);
+			incoming.stop();
+			continue;
+		}
+		ZClient *caller = new ZClient(incoming);
+		applyModifiers(caller, listenModifiers.c_str());
+		DPRINTF("Caller %d from %s\n", caller->id(), caller->host());
+		clients.add(caller);
+		pending++;
+	}
+
+	// only ring the DTE while it is in command mode, callers wait otherwise
+	if (pending == 0 || mode != ZCOMMAND_MODE || operation != ZOP_NONE)
+	{
+		if (ringActive || SREG[1] > 0)
+		{
+			stopRinging();
+		}
+		return;
+	}
+	unsigned long now = millis();
+	if (ringActive && (now - ringTimer) >= RING_PULSE)
+	{
+		digitalWrite(PIN_RI, !RI_ACTIVE);
+		ringActive = false;
+	}
+	if (ringTimer == 0 || (now - ringTimer) >= RING_INTERVAL)
+	{
+		ringTimer = now ? now : 1;
+		ringActive = true;
+		digitalWrite(PIN_RI, RI_ACTIVE);
+		if (SREG.resultCodeEnabled())
+		{
+			sendResponse(ZRING);
+		}
+		SREG[1]++;
+		if (SREG.autoAnswerRings() > 0 && SREG[1] >= SREG.autoAnswerRings())
+		{
+			for (int i = 0; i < clients.size(); i++)
+			{
+				ZClient *c = clients.get(i);
+				if (c->ringing())
+				{
+					ZResult rc = answerCaller(c);
+					if (SREG.resultCodeEnabled())
+					{
+						sendResponse(rc);
+					}
+					break;
+				}
+			}
+		}
+	}
+}
+
 ZResult ZModem::execPhonebook(unsigned long vval, uint8_t *vbuf, int vlen, bool isNumber, const char *dmodifiers)
 {
 	if (vlen == 0 || isNumber || (vlen == 1 && *vbuf == '?'))
@@ -1606,6 +2596,11 @@ ZResult ZModem::execPhonebook(unsigned long vval, uint8_t *vbuf, int vlen, bool
 					Serial2.print(" ");
 				Serial2.print(" ");
 				Serial2.print(pbe.address);
+				for (int n = 1; n < pbe.endpoints(); n++)
+				{
+					Serial2.print(ZPHONEBOOK_SEPARATOR);
+					Serial2.print(pbe.endpoint(n));
+				}
 				if (!isNumber)
 				{
 					Serial2.print(" (");
@@ -1646,8 +2641,24 @@ ZResult ZModem::execPhonebook(unsigned long vval, uint8_t *vbuf, int vlen, bool
 		notes = comma + 1;
 		DPRINTLN(notes);
 	}
-	if (!Phonebook.checkEntry(colon))
-		return ZERROR;
+	// every mirror in "host:port|host:port" needs its own port
+	for (char *ep = rest; ep != NULL; ep = strchr(ep, ZPHONEBOOK_SEPARATOR))
+	{
+		if (*ep == ZPHONEBOOK_SEPARATOR)
+			ep++;
+		char *port = strchr(ep, ':');
+		char *next = strchr(ep, ZPHONEBOOK_SEPARATOR);
+		if (port == NULL || (next != NULL && port > next))
+			return ZERROR;
+		char digits[16];
+		size_t len = (next != NULL ? next : port + strlen(port)) - (port + 1);
+		if (len >= sizeof(digits))
+			return ZERROR;
+		memcpy(digits, port + 1, len);
+		digits[len] = '\0';
+		if (!Phonebook.checkEntry(digits))
+			return ZERROR;
+	}
 	Phonebook.put(number, rest, dmodifiers, notes);
 	return ZOK;
 }
@@ -1661,7 +2672,7 @@ ZResult ZModem::execSRegister(uint8_t *vbuf, int vlen)
 		{
 			*cmd = '\0';
 			int snum = atoi((char *)vbuf);
-			if (snum >= 0 && snum < SREG.registerSize())
+			if (ZProfile::registerInfo(snum) != nullptr)
 			{
 				sendNewline();
 				Serial2.print((int)SREG[snum]);
@@ -1674,9 +2685,8 @@ ZResult ZModem::execSRegister(uint8_t *vbuf, int vlen)
 			*cmd = '\0';
 			int snum = atoi((char *)vbuf);
 			int sval = atoi((char *)(cmd + 1));
-			if (snum >= 0 && snum < SREG.registerSize() && sval >= 0 && sval <= 255)
+			if (SREG.setRegister(snum, sval))
 			{
-				SREG[snum] = (uint8_t)sval;
 				return ZOK;
 			}
 		}
@@ -1694,8 +2704,18 @@ void ZModem::switchTo(ZMode newMode, ZResult rc)
 		console.end();
 		break;
 	case ZSTREAM_MODE:
+		bridgeStop();
+		break;
+	case ZGATEWAY_MODE:
+		gateway.end();
 		break;
-	case ZPRINT_MODE:
+	case ZMUX_MODE:
+		if (muxDialing)
+		{
+			dialer.abort();
+			muxDialing = false;
+		}
+		muxOpens.clear();
 		break;
 	case ZSHELL_MODE:
 		shell.end();
@@ -1714,8 +2734,13 @@ void ZModem::switchTo(ZMode newMode, ZResult rc)
 	case ZSTREAM_MODE:
 		DPRINTF("Switch to %s mode\n", "STREAM");
 		break;
-	case ZPRINT_MODE:
-		DPRINTF("Switch to %s mode\n", "PRINT");
+	case ZGATEWAY_MODE:
+		DPRINTF("Switch to %s mode\n", "GATEWAY");
+		break;
+	case ZMUX_MODE:
+		DPRINTF("Switch to %s mode\n", "MUX");
+		mux.reset();
+		muxStarted = false;
 		break;
 	case ZSHELL_MODE:
 		DPRINTF("Switch to %s mode\n", "SHELL");
@@ -1731,6 +2756,19 @@ void ZModem::switchTo(ZMode newMode, ZResult rc)
 	esc.gt2 = 0;
 	esc.len = 0;
 	mode = newMode;
+
+	if (mode == ZSTREAM_MODE)
+	{
+		bridgeStart();
+	}
+}
+
+ZResult ZModem::goOnline(ZResult rc)
+{
+	// the result code has to be out before the bridge tasks wake up, remote
+	// data and compressed output must not overtake or split it
+	switchTo(ZSTREAM_MODE, SREG.resultCodeEnabled() ? rc : ZIGNORE);
+	return ZIGNORE;
 }
 
 IPAddress *ZModem::parseIP(const char *str)
@@ -1808,6 +2846,8 @@ void ZModem::begin()
 	pinMode(PIN_LED_HS, OUTPUT);
 	pinMode(PIN_LED_DATA, OUTPUT);
 	pinMode(PIN_LED_WIFI, OUTPUT);
+	pinMode(PIN_RI, OUTPUT);
+	digitalWrite(PIN_RI, !RI_ACTIVE);
 
 	buzzer.playTuneAsync();
 
@@ -1832,16 +2872,26 @@ void ZModem::begin()
 	}
 	else
 	{
-		SREG.loadProfile(activeProfile());
+		SREG.loadProfile(ZProfile::activeProfile());
 		Phonebook.begin();
 	}
 
 	Serial2.begin(SREG.baudRate, DEFAULT_SERIAL_CONFIG);
-	Serial2.setRxBufferSize(MAX_COMMAND_SIZE);
 	Serial2.setFlowControl(SREG.flowControlMode());
+	Serial2.setDmaMode(SREG.uartDmaEnabled());
 	DPRINTF("COM port open at %d bit/s\n", SREG.baudRate);
 	digitalWrite(PIN_LED_HS, SREG.baudRate >= DEFAULT_HS_RATE ? HIGH : LOW);
 
+	esp_timer_create_args_t timerArgs = {};
+	timerArgs.callback = &callbackEscapeTimer;
+	timerArgs.arg = this;
+	timerArgs.name = "ZESCAPE";
+	esp_timer_create(&timerArgs, &escTimer);
+
+	bridgeEvents = xEventGroupCreate();
+	xTaskCreatePinnedToCore(&callbackDteTask, "ZDTE", BRIDGE_TASK_STACK, this, BRIDGE_TASK_PRIORITY, &dteTaskHandle, BRIDGE_DTE_CORE);
+	xTaskCreatePinnedToCore(&callbackNetTask, "ZNET", BRIDGE_TASK_STACK, this, BRIDGE_TASK_PRIORITY, &netTaskHandle, BRIDGE_NET_CORE);
+
 	httpUpdater.setup(&httpServer);
 
 	if (strlen(SREG.wifiSSID) > 0)
@@ -1850,4 +2900,6 @@ void ZModem::begin()
 	}
 
 	sendAnnouncement();
+	flushReport();
+	Serial2.flush();
 }
@@ -0,0 +1,152 @@
+#include "ZMux.h"
+#include "ZCrc16.h"
+#include <string.h>
+
+void ZMux::reset()
+{
+    state = HUNT;
+    pos = 0;
+}
+
+size_t ZMux::needed()
+{
+    switch (state)
+    {
+    case HEADER:
+        return sizeof(header) - pos;
+    case PAYLOAD:
+        return frame.length - pos;
+    case TRAILER:
+        return sizeof(trailer) - pos;
+    default:
+        return 1;
+    }
+}
+
+// Consumes input up to and including one complete, valid frame.  A frame
+// with a bad length or CRC is dropped whole and the hunt for the next SOF
+// starts after it; tools/zmux.py resyncs the same way.
+bool ZMux::receive(const uint8_t *data, size_t len, size_t *used)
+{
+    size_t i = 0;
+    bool complete = false;
+    while (i < len && !complete)
+    {
+        switch (state)
+        {
+        case HUNT:
+            if (data[i++] == ZMUX_SOF)
+            {
+                state = HEADER;
+                pos = 0;
+            }
+            break;
+        case HEADER:
+            header[pos++] = data[i++];
+            if (pos == sizeof(header))
+            {
+                frame.channel = header[0] | (header[1] << 8);
+                frame.type = header[2];
+                frame.length = header[3] | (header[4] << 8);
+                pos = 0;
+                if (frame.length > ZMUX_MAX_PAYLOAD)
+                {
+                    stats.oversize++;
+                    state = HUNT;
+                }
+                else
+                {
+                    state = frame.length > 0 ? PAYLOAD : TRAILER;
+                }
+            }
+            break;
+        case PAYLOAD:
+        {
+            size_t n = frame.length - pos < len - i ? frame.length - pos : len - i;
+            memcpy(frame.payload + pos, data + i, n);
+            pos += n;
+            i += n;
+            if (pos == frame.length)
+            {
+                state = TRAILER;
+                pos = 0;
+            }
+            break;
+        }
+        case TRAILER:
+            trailer[pos++] = data[i++];
+            if (pos == sizeof(trailer))
+            {
+                state = HUNT;
+                uint16_t crc = ZCrc16::update(0xFFFF, header, sizeof(header));
+                crc = ZCrc16::update(crc, frame.payload, frame.length);
+                if (crc != (trailer[0] | (trailer[1] << 8)))
+                {
+                    stats.crcErrors++;
+                    break;
+                }
+                stats.framesIn++;
+                complete = true;
+            }
+            break;
+        }
+    }
+    if (used != nullptr)
+    {
+        *used = i;
+    }
+    return complete;
+}
+
+void ZMux::wrap(uint8_t *head, uint8_t *tail, uint16_t channel, uint8_t type, const uint8_t *data, size_t len)
+{
+    head[0] = ZMUX_SOF;
+    head[1] = channel & 0xFF;
+    head[2] = channel >> 8;
+    head[3] = type;
+    head[4] = len & 0xFF;
+    head[5] = len >> 8;
+    uint16_t crc = ZCrc16::update(0xFFFF, head + 1, ZMUX_HEADER_SIZE - 1);
+    crc = ZCrc16::update(crc, data, len);
+    tail[0] = crc & 0xFF;
+    tail[1] = crc >> 8;
+}
+
+#ifdef ARDUINO
+bool ZMux::receive(Stream &in)
+{
+    // never reads past the frame, the rest stays in the UART for next time
+    uint8_t chunk[128];
+    while (in.available() > 0)
+    {
+        size_t n = min(min(needed(), sizeof(chunk)), (size_t)in.available());
+        n = in.readBytes(chunk, n);
+        if (receive(chunk, n, nullptr))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ZMux::send(Print &out, uint16_t channel, uint8_t type, const uint8_t *data, size_t len)
+{
+    uint8_t head[ZMUX_HEADER_SIZE];
+    uint8_t tail[ZMUX_TRAILER_SIZE];
+    wrap(head, tail, channel, type, data, len);
+    size_t n = out.write(head, sizeof(head));
+    if (len > 0)
+    {
+        n += out.write(data, len);
+    }
+    n += out.write(tail, sizeof(tail));
+    stats.framesOut++;
+    return n;
+}
+
+size_t ZMux::sendCredit(Print &out, uint16_t channel, uint16_t bytes)
+{
+    uint8_t credit[2] = {(uint8_t)(bytes & 0xFF), (uint8_t)(bytes >> 8)};
+    return send(out, channel, ZMUX_CREDIT, credit, sizeof(credit));
+}
+#endif
@@ -18,6 +18,16 @@ bool ZPhonebook::checkEntry(char *cmd)
     return (error || strlen(cmd) > 9) ? false : true;
 }
 
+int PBEntry::endpoints() const
+{
+    int n = 0;
+    while (n < ZPHONEBOOK_ENDPOINTS && endpoint(n)[0] != '\0')
+    {
+        n++;
+    }
+    return n;
+}
+
 ZPhonebook::ZPhonebook()
 {
 }
@@ -75,9 +85,10 @@ bool ZPhonebook::get(int index, PBEntry *pbe)
     File file = SPIFFS.open(name, "r");
     if (file)
     {
-        if (file.available() >= sizeof(PBEntry))
+        size_t avail = file.available();
+        if (avail >= ZPHONEBOOK_LEGACY_SIZE)
         {
-            bytesRead += file.readBytes((char *)pbe, sizeof(PBEntry));
+            bytesRead += file.readBytes((char *)pbe, avail < sizeof(PBEntry) ? avail : sizeof(PBEntry));
             DPRINTF("Phonebook entry #%d (%lu) %s\n", index, pbe->number, "read");
         }
         file.close();
@@ -115,7 +126,23 @@ bool ZPhonebook::put(unsigned long number, const char *address, const char *modi
     memset(&pbe, 0, sizeof(pbe));
     pbe.number = number;
     if (address != NULL)
-        strncpy(pbe.address, address, sizeof(pbe.address));
+    {
+        // "host:port|host:port|..." lists mirrors of the same board
+        const char *start = address;
+        for (int i = 0; i < ZPHONEBOOK_ENDPOINTS && *start != '\0'; i++)
+        {
+            const char *end = strchr(start, ZPHONEBOOK_SEPARATOR);
+            size_t len = end != NULL ? end - start : strlen(start);
+            char *dest = pbe.endpoint(i);
+            if (len >= sizeof(pbe.address))
+                len = sizeof(pbe.address) - 1;
+            memcpy(dest, start, len);
+            dest[len] = '\0';
+            if (end == NULL)
+                break;
+            start = end + 1;
+        }
+    }
     if (modifiers != NULL)
         strncpy(pbe.modifiers, modifiers, sizeof(pbe.modifiers));
     if (notes != NULL)
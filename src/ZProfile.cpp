@@ -3,7 +3,14 @@
 #include "z/options.h"
 #include "z/version.h"
 #include <SPIFFS.h>
-#include <ArduinoJson.h>
+
+static_assert(sizeof(ZProfileRecord::hostname) == sizeof(ZProfile::hostname), "hostname size");
+static_assert(sizeof(ZProfileRecord::wifiSSID) == sizeof(ZProfile::wifiSSID), "wifiSSID size");
+static_assert(sizeof(ZProfileRecord::wifiPSWD) == sizeof(ZProfile::wifiPSWD), "wifiPSWD size");
+
+ZProfileImage ZProfile::image;
+bool ZProfile::imageLoaded = false;
+bool ZProfile::tempOnly = false;
 
 ZProfile::ZProfile()
 {
@@ -14,81 +21,220 @@ ZProfile::~ZProfile()
 }
 
 
-void ZProfile::loadProfile(int num)
+void ZProfile::loadDefaults()
 {
 	memset(regs, 0, sizeof(regs));
 	memset(hostname, 0, sizeof(hostname));
 	memset(wifiSSID, 0, sizeof(wifiSSID));
 	memset(wifiPSWD, 0, sizeof(wifiPSWD));
-	regs[2] = (uint8_t)'+';
-	regs[3] = (uint8_t)'\r';		// ASCII 13
-	regs[4] = (uint8_t)'\n';		// ASCII 10
-	regs[5] = (uint8_t)'\b';		// ASCII 8
-	regs[12] = 50;					// in fiftieths of a second
-	regs[14] = 0b00001010;
-	regs[32] = ASCII_XON;
-	regs[33] = ASCII_XOFF;
+	for (const ZRegister &r : ZREGISTERS)
+	{
+		regs[r.index] = r.defaultValue;
+	}
 	baudRate = DEFAULT_BAUD_RATE;
+	listenPort = 0;
+}
 
-	if (num >= 0 && num < MAX_USER_PROFILES)
+static bool validRegister(const ZRegister *r, int value)
+{
+	return r != nullptr && value >= r->minValue && value <= r->maxValue && (value & ~r->mask) == 0;
+}
+
+void ZProfile::loadRegister(int index, int value)
+{
+	const ZRegister *r = registerInfo(index);
+	if (validRegister(r, value) && (r->flags & ZREG_PERSIST))
 	{
-		char name[32];
-		snprintf(name, sizeof(name), "/profile/%d", num);
-		File file = SPIFFS.open(name, "r");
-		if (file)
-		{
-			StaticJsonDocument<1024> doc;
-			if (deserializeJson(doc, file))
-			{
-				if (doc.containsKey("hostname"))
-					strcpy(hostname, doc["hostname"]);
-				if (doc.containsKey("wifiSSID"))
-					strcpy(wifiSSID, doc["wifiSSID"]);
-				if (doc.containsKey("wifiPSWD"))
-					strcpy(wifiPSWD, doc["wifiPSWD"]);
-				if (doc.containsKey("baudRate"))
-					baudRate = doc["baudRate"];
-				if (doc.containsKey("regs"))
-				{
-					JsonArray array = doc["regs"].as<JsonArray>();
-					for (int i = 0; i < sizeof(regs) && i < array.size(); i++)
-					{
-						regs[i] = array[i].as<uint8_t>();
-					}
-				}
-				DPRINTF("Profile %d %s\n", num, "loaded");
-			}
-			file.close();
-		}
-	}	
+		regs[index] = (uint8_t)value;
+	}
 }
 
-void ZProfile::saveProfile(int num)
+bool ZProfile::setRegister(int index, int value)
 {
-	char name[32];
-	snprintf(name, sizeof(name), "/profile/%d", num);
-	File file = SPIFFS.open(name, "w");
-	if (file)
+	const ZRegister *r = registerInfo(index);
+	if (!validRegister(r, value) || (r->flags & ZREG_READONLY))
 	{
-		StaticJsonDocument<1024> doc;
+		return false;
+	}
+	regs[index] = (uint8_t)value;
+	return true;
+}
 
-		doc["version"] = ZMODEM_VERSION;
-		doc["hostname"] = hostname;
-		doc["wifiSSID"] = wifiSSID;
-		doc["wifiPSWD"] = wifiPSWD;
-		doc["baudRate"] = baudRate;
+bool ZProfile::readImage(const char *path)
+{
+	File file = SPIFFS.open(path, "r");
+	if (!file)
+	{
+		return false;
+	}
+	bool ok = file.read((uint8_t *)&image, sizeof(image)) == sizeof(image) && ZProfileStore::valid(image);
+	file.close();
+	return ok;
+}
 
-		JsonArray array = doc.createNestedArray("regs");
+bool ZProfile::writeImage()
+{
+	ZProfileStore::seal(image);
+	// never truncate the last good copy: while only the temporary file is
+	// valid the new image goes straight to PROFILE_FILE
+	File file = SPIFFS.open(tempOnly ? PROFILE_FILE : PROFILE_TEMP_FILE, "w");
+	if (!file)
+	{
+		return false;
+	}
+	bool ok = file.write((const uint8_t *)&image, sizeof(image)) == sizeof(image);
+	file.close();
+	if (ok && tempOnly)
+	{
+		SPIFFS.remove(PROFILE_TEMP_FILE);
+		tempOnly = false;
+	}
+	else if (ok)
+	{
+		// SPIFFS will not rename over an existing file; until the rename
+		// lands loadImage() picks the complete temporary copy up instead
+		SPIFFS.remove(PROFILE_FILE);
+		ok = SPIFFS.rename(PROFILE_TEMP_FILE, PROFILE_FILE);
+		tempOnly = !ok;
+	}
+	DPRINTF("Profiles %s\n", ok ? "written" : "not written");
+	return ok;
+}
+
+void ZProfile::loadImage()
+{
+	imageLoaded = true;
+	tempOnly = false;
+	if (readImage(PROFILE_FILE))
+	{
+		return;
+	}
+	if (readImage(PROFILE_TEMP_FILE))
+	{
+		// an earlier write stopped between remove and rename, finish it
+		SPIFFS.remove(PROFILE_FILE);
+		tempOnly = !SPIFFS.rename(PROFILE_TEMP_FILE, PROFILE_FILE);
+		return;
+	}
+	ZProfileStore::clear(image);
+	migrateJson();
+}
 
-		for (int i = 0; i < sizeof(regs); i++)
+void ZProfile::migrateJson()
+{
+	// one-off conversion of /profile/<n> and /profile/active
+	bool found = false;
+	for (int num = 0; num < MAX_USER_PROFILES; num++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "/profile/%d", num);
+		File file = SPIFFS.open(name, "r");
+		if (!file)
 		{
-			array.add(regs[i]);
+			continue;
 		}
-
-		if (serializeJson(doc, file) > 0)
+		String json = file.readString();
+		file.close();
+		if (ZProfileStore::fromJson(image.profiles[num], json.c_str(), json.length()))
+		{
+			found = true;
+		}
+	}
+	File file = SPIFFS.open("/profile/active", "r");
+	if (file)
+	{
+		String line = file.readString();
+		if (!line.isEmpty())
 		{
-			DPRINTF("Profile %d %s\n", num, "saved");
+			image.active = line.toInt();
 		}
 		file.close();
+		found = true;
+	}
+	if (found && writeImage())
+	{
+		for (int num = 0; num < MAX_USER_PROFILES; num++)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "/profile/%d", num);
+			SPIFFS.remove(name);
+		}
+		SPIFFS.remove("/profile/active");
+		DPRINTLN("Profiles migrated");
+	}
+}
+
+void ZProfile::loadProfile(int num)
+{
+	if (!imageLoaded)
+	{
+		loadImage();
+	}
+	loadDefaults();
+	if (num < 0 || num >= MAX_USER_PROFILES || !image.profiles[num].used)
+	{
+		return;
+	}
+	const ZProfileRecord &rec = image.profiles[num];
+	baudRate = rec.baudRate;
+	listenPort = rec.listenPort;
+	memcpy(hostname, rec.hostname, sizeof(hostname) - 1);
+	memcpy(wifiSSID, rec.wifiSSID, sizeof(wifiSSID) - 1);
+	memcpy(wifiPSWD, rec.wifiPSWD, sizeof(wifiPSWD) - 1);
+	for (const ZRegister &r : ZREGISTERS)
+	{
+		loadRegister(r.index, rec.regs[r.index]);
+	}
+	DPRINTF("Profile %d %s\n", num, "loaded");
+}
+
+void ZProfile::saveProfile(int num)
+{
+	if (num < 0 || num >= MAX_USER_PROFILES)
+	{
+		return;
+	}
+	if (!imageLoaded)
+	{
+		loadImage();
+	}
+	ZProfileRecord &rec = image.profiles[num];
+	memset(&rec, 0, sizeof(rec));
+	rec.used = 1;
+	rec.baudRate = baudRate;
+	rec.listenPort = listenPort;
+	memcpy(rec.hostname, hostname, sizeof(rec.hostname));
+	memcpy(rec.wifiSSID, wifiSSID, sizeof(rec.wifiSSID));
+	memcpy(rec.wifiPSWD, wifiPSWD, sizeof(rec.wifiPSWD));
+	for (const ZRegister &r : ZREGISTERS)
+	{
+		rec.regs[r.index] = (r.flags & ZREG_PERSIST) ? regs[r.index] : r.defaultValue;
+	}
+	if (writeImage())
+	{
+		DPRINTF("Profile %d %s\n", num, "saved");
+	}
+}
+
+int ZProfile::activeProfile()
+{
+	if (!imageLoaded)
+	{
+		loadImage();
+	}
+	DPRINTF("Active profile: %d\n", image.active);
+	return image.active;
+}
+
+void ZProfile::setActiveProfile(int num)
+{
+	if (!imageLoaded)
+	{
+		loadImage();
+	}
+	image.active = num;
+	if (writeImage())
+	{
+		DPRINTF("Set active profile: %d\n", num);
 	}
 }
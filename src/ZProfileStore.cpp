@@ -0,0 +1,93 @@
+#include "ZProfileStore.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ArduinoJson.h>
+#ifdef ARDUINO
+#include <esp32/rom/crc.h>
+#endif
+
+uint32_t ZProfileStore::crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+#ifdef ARDUINO
+    return crc32_le(crc, data, len);
+#else
+    // same result as the ROM routine and zlib, for host tools
+    static const uint32_t nibble[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = (crc >> 4) ^ nibble[(crc ^ data[i]) & 0x0F];
+        crc = (crc >> 4) ^ nibble[(crc ^ (data[i] >> 4)) & 0x0F];
+    }
+    return ~crc;
+#endif
+}
+
+void ZProfileStore::clear(ZProfileImage &image)
+{
+    memset(&image, 0, sizeof(image));
+    image.active = -1;
+}
+
+void ZProfileStore::seal(ZProfileImage &image)
+{
+    image.magic = PROFILE_MAGIC;
+    image.version = PROFILE_VERSION;
+    image.size = sizeof(image);
+    image.count = MAX_USER_PROFILES;
+    image.crc = crc32(0, (const uint8_t *)&image, offsetof(ZProfileImage, crc));
+}
+
+bool ZProfileStore::valid(const ZProfileImage &image)
+{
+    return image.magic == PROFILE_MAGIC && image.version == PROFILE_VERSION && image.size == sizeof(image) &&
+           image.count == MAX_USER_PROFILES && image.crc == crc32(0, (const uint8_t *)&image, offsetof(ZProfileImage, crc));
+}
+
+// the same checks ZProfile::loadRegister() applies
+static void loadRegister(ZProfileRecord &rec, int index, int value)
+{
+    int slot = zregisterSlot(index);
+    if (slot < 0)
+    {
+        return;
+    }
+    const ZRegister &r = ZREGISTERS[slot];
+    if (value >= r.minValue && value <= r.maxValue && (value & ~r.mask) == 0 && (r.flags & ZREG_PERSIST))
+    {
+        rec.regs[index] = (uint8_t)value;
+    }
+}
+
+bool ZProfileStore::fromJson(ZProfileRecord &rec, const char *json, size_t len)
+{
+    // room for the dense register array of older profiles and the strings
+    StaticJsonDocument<JSON_ARRAY_SIZE(ZREGISTER_SPACE) + JSON_OBJECT_SIZE(8) + 512> doc;
+    if (deserializeJson(doc, json, len))
+    {
+        return false;
+    }
+    memset(&rec, 0, sizeof(rec));
+    rec.used = 1;
+    rec.baudRate = doc["baudRate"] | DEFAULT_BAUD_RATE;
+    rec.listenPort = doc["listenPort"] | 0;
+    strncpy(rec.hostname, doc["hostname"] | "", sizeof(rec.hostname) - 1);
+    strncpy(rec.wifiSSID, doc["wifiSSID"] | "", sizeof(rec.wifiSSID) - 1);
+    strncpy(rec.wifiPSWD, doc["wifiPSWD"] | "", sizeof(rec.wifiPSWD) - 1);
+    for (const ZRegister &r : ZREGISTERS)
+    {
+        rec.regs[r.index] = r.defaultValue;
+    }
+    JsonArray regs = doc["regs"];
+    for (size_t i = 0; i < regs.size() && i < ZREGISTER_SPACE; i++)
+    {
+        loadRegister(rec, i, regs[i].as<int>());
+    }
+    for (JsonPair kv : doc["sregs"].as<JsonObject>())
+    {
+        loadRegister(rec, atoi(kv.key().c_str()), kv.value().as<int>());
+    }
+    return true;
+}
@@ -0,0 +1,243 @@
+#include "ZResolver.h"
+#include "ZPhonebook.h"
+#include "ZDebug.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/dns.h>
+#include <lwip/tcpip.h>
+
+ZResolver Resolver;
+
+ZResolver::ZResolver()
+{
+    memset(entries, 0, sizeof(entries));
+    m_hits = 0;
+    m_misses = 0;
+    m_failures = 0;
+    m_waitTime = 0;
+}
+
+void ZResolver::callbackStart(void *arg)
+{
+    ZResolverEntry *e = reinterpret_cast<ZResolverEntry *>(arg);
+    ip_addr_t ip;
+    err_t err = dns_gethostbyname(e->host, &ip, &ZResolver::callbackFound, e);
+    if (err == ERR_OK)
+    {
+        callbackFound(e->host, &ip, e);
+    }
+    else if (err != ERR_INPROGRESS)
+    {
+        callbackFound(e->host, nullptr, e);
+    }
+}
+
+void ZResolver::callbackFound(const char *name, const ip_addr_t *ipaddr, void *arg)
+{
+    ZResolverEntry *e = reinterpret_cast<ZResolverEntry *>(arg);
+    e->stamp = millis();
+    if (ipaddr != nullptr && IP_IS_V4(ipaddr))
+    {
+        e->addr = ip4_addr_get_u32(ip_2_ip4(ipaddr));
+        e->state = ZRESOLVER_RESOLVED;
+    }
+    else
+    {
+        e->state = ZRESOLVER_FAILED;
+    }
+}
+
+ZResolverEntry *ZResolver::find(const char *host)
+{
+    for (int i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        if (entries[i].state != ZRESOLVER_EMPTY && strcasecmp(entries[i].host, host) == 0)
+        {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+ZResolverEntry *ZResolver::allocate(const char *host)
+{
+    // reuse a free slot or the least recently used answer; pending slots
+    // still belong to the tcpip thread and are never evicted
+    ZResolverEntry *victim = nullptr;
+    for (int i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        ZResolverEntry *e = &entries[i];
+        if (e->state == ZRESOLVER_EMPTY)
+        {
+            victim = e;
+            break;
+        }
+        if (e->state != ZRESOLVER_PENDING && (victim == nullptr || (long)(e->used - victim->used) < 0))
+        {
+            victim = e;
+        }
+    }
+    if (victim != nullptr)
+    {
+        strncpy(victim->host, host, sizeof(victim->host));
+        victim->state = ZRESOLVER_EMPTY;
+        victim->addr = 0;
+        victim->hits = 0;
+        victim->used = millis();
+    }
+    return victim;
+}
+
+bool ZResolver::start(ZResolverEntry *e)
+{
+    e->waiting = false;
+    e->requested = millis();
+    e->state = ZRESOLVER_PENDING;
+    if (tcpip_callback(&ZResolver::callbackStart, e) != ERR_OK)
+    {
+        e->state = ZRESOLVER_FAILED;
+        return false;
+    }
+    return true;
+}
+
+bool ZResolver::expired(ZResolverEntry *e)
+{
+    if (e->state == ZRESOLVER_FAILED)
+    {
+        return (millis() - e->stamp) >= DNS_NEGATIVE_TTL * 1000UL;
+    }
+    return e->state == ZRESOLVER_RESOLVED && (millis() - e->stamp) >= DNS_CACHE_TTL * 1000UL;
+}
+
+unsigned long ZResolver::timeToLive(ZResolverEntry &e)
+{
+    if (e.state != ZRESOLVER_RESOLVED || expired(&e))
+    {
+        return 0;
+    }
+    return DNS_CACHE_TTL - (millis() - e.stamp) / 1000;
+}
+
+int ZResolver::query(const char *host, IPAddress &addr)
+{
+    if (addr.fromString(host))
+    {
+        return ZRESOLVER_RESOLVED;
+    }
+    if (strlen(host) >= DNS_CACHE_HOST_SIZE)
+    {
+        // too long to cache, take the blocking path
+        return WiFi.hostByName(host, addr) == 1 ? ZRESOLVER_RESOLVED : ZRESOLVER_FAILED;
+    }
+
+    ZResolverEntry *e = find(host);
+    if (e != nullptr && e->state == ZRESOLVER_PENDING)
+    {
+        return ZRESOLVER_PENDING;
+    }
+    if (e != nullptr && !expired(e))
+    {
+        e->used = millis();
+        if (e->waiting)
+        {
+            // first look at an answer this lookup asked for
+            e->waiting = false;
+            m_waitTime += e->stamp - e->requested;
+            if (e->state == ZRESOLVER_FAILED)
+            {
+                DPRINTF("DNS lookup for %s failed\n", host);
+                m_failures++;
+            }
+        }
+        else if (e->state == ZRESOLVER_RESOLVED)
+        {
+            m_hits++;
+            e->hits++;
+        }
+        addr = IPAddress(e->addr);
+        return e->state;
+    }
+
+    m_misses++;
+    if (e == nullptr)
+    {
+        e = allocate(host);
+        if (e == nullptr)
+        {
+            return WiFi.hostByName(host, addr) == 1 ? ZRESOLVER_RESOLVED : ZRESOLVER_FAILED;
+        }
+    }
+    if (!start(e))
+    {
+        m_failures++;
+        return ZRESOLVER_FAILED;
+    }
+    e->waiting = true;
+    return ZRESOLVER_PENDING;
+}
+
+bool ZResolver::resolve(const char *host, IPAddress &addr, unsigned long timeout)
+{
+    unsigned long started = millis();
+    int state;
+    while ((state = query(host, addr)) == ZRESOLVER_PENDING && (millis() - started) < timeout)
+    {
+        delay(5);
+    }
+    return state == ZRESOLVER_RESOLVED;
+}
+
+void ZResolver::prefetch(const char *host)
+{
+    IPAddress addr;
+    if (addr.fromString(host) || strlen(host) >= DNS_CACHE_HOST_SIZE)
+    {
+        return;
+    }
+    ZResolverEntry *e = find(host);
+    if (e != nullptr && (e->state == ZRESOLVER_PENDING || (e->state == ZRESOLVER_RESOLVED && !expired(e))))
+    {
+        return;
+    }
+    if (e == nullptr)
+    {
+        e = allocate(host);
+    }
+    if (e != nullptr)
+    {
+        start(e);
+    }
+}
+
+void ZResolver::prefetchPhonebook()
+{
+    PBEntry pbe;
+    for (int i = 0; i < Phonebook.size(); i++)
+    {
+        if (Phonebook.get(i, &pbe))
+        {
+            for (int n = 0; n < pbe.endpoints(); n++)
+            {
+                char *host = pbe.endpoint(n);
+                char *colon = strchr(host, ':');
+                if (colon != nullptr)
+                {
+                    *colon = '\0';
+                }
+                prefetch(host);
+            }
+        }
+    }
+}
+
+void ZResolver::flush()
+{
+    for (int i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        if (entries[i].state != ZRESOLVER_PENDING)
+        {
+            entries[i].state = ZRESOLVER_EMPTY;
+        }
+    }
+}
@@ -1,49 +1,98 @@
 #include "ZSerial.h"
 #include "z/options.h"
-#include "driver/uart.h"
 
 ZSerial Serial2(UART_NUM_2); // global instance
 
 void ZSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin, bool invert, unsigned long timeout_ms)
 {
+    sizeBuffers(baud);
     uart_set_pin(UART_NUM_2, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, PIN_RTS, PIN_CTS);
     HardwareSerial::begin(baud, config, rxPin, txPin, invert, timeout_ms);
     pinMode(PIN_LED_DATA, OUTPUT);
     digitalWrite(PIN_LED_DATA, LOW);
+    dataLed = false;
     lastActivity = 0;
+    // the Arduino driver has been (re)installed without our queue, our
+    // buffer sizes and flow control
+    eventQueue = nullptr;
+    dma.end();
+    installDriver();
+    rxHeld = false;
+    rxHoldWanted = false;
+    setFlowControl(flowMode);
+    if (dmaMode)
+    {
+        dma.begin(&ZSerial::callbackDmaData, this);
+    }
+}
+
+void ZSerial::sizeBuffers(unsigned long baud)
+{
+    // driver buffers hold ZSERIAL_BUFFER_MS of traffic at this rate
+    size_t bytesPerSec = baud / 10;
+    size_t size = ZSERIAL_RX_BUFFER_SIZE;
+    while (size < bytesPerSec * ZSERIAL_BUFFER_MS / 1000 && size < ZSERIAL_MAX_BUFFER_SIZE)
+    {
+        size <<= 1;
+    }
+    rxBufferSize = size;
+    txBufferSize = size;
+    // leave FIFO room for what is still on the wire once RTS/XOFF goes out
+    size_t headroom = bytesPerSec * FLOW_CTRL_REACTION_US / 1000000 + 4;
+    if (headroom < SOC_UART_FIFO_LEN - FLOW_CTRL_RX_THRESH)
+    {
+        headroom = SOC_UART_FIFO_LEN - FLOW_CTRL_RX_THRESH;
+    }
+    flowThreshold = headroom > SOC_UART_FIFO_LEN - FLOW_CTRL_RX_THRESH_MIN ? FLOW_CTRL_RX_THRESH_MIN : SOC_UART_FIFO_LEN - headroom;
 }
 
 int ZSerial::available()
 {
-    int avail = HardwareSerial::available();
+    int avail = dma.running() ? dma.available() : HardwareSerial::available();
     if (avail > 0)
     {
         lastActivity = millis();
-        digitalWrite(PIN_LED_DATA, HIGH);
+        setDataLed(true);
     }
-    else if ((millis() - lastActivity) > 10)
+    else if (dataLed && (millis() - lastActivity) > 10)
     {
-        digitalWrite(PIN_LED_DATA, LOW);
+        setDataLed(false);
     }
     return avail;
 }
 
+int ZSerial::read()
+{
+    return dma.running() ? dma.read() : HardwareSerial::read();
+}
+
+size_t ZSerial::read(uint8_t *buffer, size_t size)
+{
+    return dma.running() ? dma.read(buffer, size) : HardwareSerial::read(buffer, size);
+}
+
+int ZSerial::peek()
+{
+    return dma.running() ? dma.peek() : HardwareSerial::peek();
+}
+
 size_t ZSerial::write(uint8_t c)
 {
     lastActivity = millis();
-    digitalWrite(PIN_LED_DATA, HIGH);
+    setDataLed(true);
     return HardwareSerial::write(c);
 }
 
 size_t ZSerial::write(const uint8_t *buffer, size_t size)
 {
     lastActivity = millis();
-    digitalWrite(PIN_LED_DATA, HIGH);
+    setDataLed(true);
     return HardwareSerial::write(buffer, size);
 }
 
 void ZSerial::setFlowControl(FlowControlMode mode)
 {
+    flowMode = mode;
     switch (mode)
     {
     case FCM_DISABLED:
@@ -53,17 +102,293 @@ void ZSerial::setFlowControl(FlowControlMode mode)
         uart_set_sw_flow_ctrl(UART_NUM_2, false, 0, 0);
         break;
     case FCM_HARDWARE:
-        uart_set_hw_flow_ctrl(UART_NUM_2, UART_HW_FLOWCTRL_CTS_RTS, FLOW_CTRL_RX_THRESH);
+        uart_set_hw_flow_ctrl(UART_NUM_2, UART_HW_FLOWCTRL_CTS_RTS, flowThreshold);
         break;
     case FCM_SOFTWARE:
-        uart_set_sw_flow_ctrl(UART_NUM_2, true, FLOW_CTRL_RX_THRESH_XON, FLOW_CTRL_RX_THRESH_XOFF);
+        uart_set_sw_flow_ctrl(UART_NUM_2, true, flowThreshold / 2, flowThreshold);
         break;
     case FCM_BOTH:
-        uart_set_hw_flow_ctrl(UART_NUM_2, UART_HW_FLOWCTRL_CTS_RTS, FLOW_CTRL_RX_THRESH);
-        uart_set_sw_flow_ctrl(UART_NUM_2, true, FLOW_CTRL_RX_THRESH_XON, FLOW_CTRL_RX_THRESH_XOFF);
+        uart_set_hw_flow_ctrl(UART_NUM_2, UART_HW_FLOWCTRL_CTS_RTS, flowThreshold);
+        uart_set_sw_flow_ctrl(UART_NUM_2, true, flowThreshold / 2, flowThreshold);
         break;
     case FCM_TRANSPARENT:
     case FCM_INVALID:
         break;
     }
-}
\ No newline at end of file
+}
+
+void ZSerial::holdReceive(bool hold)
+{
+    // the UART only drops RTS on FIFO level, backpressure from further
+    // downstream takes RTS over by hand and sends XOFF out of band
+    if (hold == rxHoldWanted)
+    {
+        return;
+    }
+    rxHoldWanted = hold;
+    if (flowMode == FCM_HARDWARE || flowMode == FCM_BOTH)
+    {
+        if (hold)
+        {
+            uart_set_hw_flow_ctrl(UART_NUM_2, UART_HW_FLOWCTRL_CTS, 0);
+            uart_set_rts(UART_NUM_2, 0);
+        }
+        else
+        {
+            uart_set_hw_flow_ctrl(UART_NUM_2, UART_HW_FLOWCTRL_CTS_RTS, flowThreshold);
+        }
+    }
+    pollHold();
+}
+
+void ZSerial::pollHold()
+{
+    if (rxHeld == rxHoldWanted)
+    {
+        return;
+    }
+    if (flowMode == FCM_SOFTWARE || flowMode == FCM_BOTH)
+    {
+        const char c = rxHoldWanted ? ASCII_XOFF : ASCII_XON;
+        // a full TX FIFO takes nothing, the next poll tries again
+        if (uart_tx_chars(UART_NUM_2, &c, 1) != 1)
+        {
+            return;
+        }
+    }
+    rxHeld = rxHoldWanted;
+}
+
+bool ZSerial::installDriver()
+{
+    // the queue is always there so event mode can be switched on and off
+    // without reinstalling, which would throw away what is buffered
+    uart_driver_delete(UART_NUM_2);
+    esp_err_t err = uart_driver_install(UART_NUM_2, rxBufferSize, txBufferSize, ZSERIAL_EVENT_QUEUE_LEN, &eventQueue, 0);
+    if (err != ESP_OK)
+    {
+        eventQueue = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ZSerial::resizeDriver(unsigned long baud)
+{
+    // reinstalling the driver turns its receive interrupts back on
+    dma.end();
+    sizeBuffers(baud);
+    bool ok = installDriver();
+    rxHeld = false;
+    rxHoldWanted = false;
+    setFlowControl(flowMode);
+    if (dmaMode)
+    {
+        dma.begin(&ZSerial::callbackDmaData, this);
+    }
+    return ok;
+}
+
+bool ZSerial::setEventMode(bool enabled)
+{
+    eventMode = enabled;
+    return !enabled || eventQueue != nullptr;
+}
+
+bool ZSerial::setDmaMode(bool enabled)
+{
+    dmaMode = enabled;
+    if (!enabled)
+    {
+        dma.end();
+        return true;
+    }
+    if (!dma.begin(&ZSerial::callbackDmaData, this))
+    {
+        dmaMode = false;
+        return false;
+    }
+    return true;
+}
+
+void ZSerial::countEvent(const uart_event_t &event)
+{
+    switch (event.type)
+    {
+    case UART_FIFO_OVF:
+        stats.fifoOverflows++;
+        break;
+    case UART_BUFFER_FULL:
+        stats.bufferFull++;
+        break;
+    case UART_BREAK:
+        stats.breaks++;
+        break;
+    case UART_FRAME_ERR:
+        stats.frameErrors++;
+        break;
+    case UART_PARITY_ERR:
+        stats.parityErrors++;
+        break;
+    case UART_PATTERN_DET:
+        stats.patterns++;
+        break;
+    default:
+        break;
+    }
+}
+
+bool ZSerial::waitForEvent(TickType_t timeout)
+{
+    uart_event_t event;
+
+    if (!eventsEnabled())
+    {
+        vTaskDelay(timeout);
+        return false;
+    }
+    if (xQueueReceive(eventQueue, &event, timeout) != pdTRUE)
+    {
+        return false;
+    }
+    countEvent(event);
+    return true;
+}
+
+void ZSerial::pollEvents()
+{
+    uart_event_t event;
+
+    pollHold();
+    if (eventQueue == nullptr)
+    {
+        return;
+    }
+    // a busy bridge never waits, count what queued up since the last pump
+    while (xQueueReceive(eventQueue, &event, 0) == pdTRUE)
+    {
+        countEvent(event);
+    }
+}
+
+void ZSerial::wake()
+{
+    if (eventQueue != nullptr)
+    {
+        uart_event_t event = {};
+        event.type = UART_EVENT_MAX;
+        xQueueSend(eventQueue, &event, 0);
+    }
+}
+
+void IRAM_ATTR ZSerial::wakeFromISR()
+{
+    if (eventQueue != nullptr)
+    {
+        uart_event_t event = {};
+        event.type = UART_DATA;
+        BaseType_t woken = pdFALSE;
+        xQueueSendFromISR(eventQueue, &event, &woken);
+        if (woken)
+        {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+bool ZSerial::enablePatternDetect(char c, unsigned long guardTime)
+{
+    // the pattern is matched by the driver's FIFO interrupt, which DMA replaces
+    if (dma.running())
+    {
+        return false;
+    }
+    // idle times are in baud cycles and the registers are only 16 bits wide
+    unsigned long long cycles = (unsigned long long)baudRate() * guardTime / 1000;
+    patternFull = cycles <= 0xFFFF;
+    if (!patternFull)
+    {
+        cycles = 0xFFFF;
+    }
+    patternIdle = (unsigned long)(cycles * 1000000ULL / baudRate());
+    if (uart_enable_pattern_det_baud_intr(UART_NUM_2, c, 3, (int)cycles, (int)cycles, (int)cycles) != ESP_OK)
+    {
+        patternIdle = 0;
+        patternFull = false;
+        return false;
+    }
+    uart_pattern_queue_reset(UART_NUM_2, ZSERIAL_PATTERN_QUEUE_LEN);
+    return true;
+}
+
+void ZSerial::disablePatternDetect()
+{
+    uart_disable_pattern_det_intr(UART_NUM_2);
+    patternIdle = 0;
+    patternFull = false;
+}
+
+ZSerialBench ZSerial::loopbackTest(unsigned long baud, size_t total)
+{
+    ZSerialBench result = {};
+    result.baud = baud;
+    uint8_t out[256];
+    uint8_t in[256];
+    uint8_t next = 0;
+    uint8_t expect = 0;
+    unsigned long saved = baudRate();
+
+    // keep the test pattern off the DTE's receive line
+    pinMode(PIN_TXD, OUTPUT);
+    digitalWrite(PIN_TXD, HIGH);
+    uart_set_loop_back(UART_NUM_2, true);
+    updateBaudRate(baud);
+    // buffers sized for the saved rate would overflow at a faster one
+    resizeDriver(baud);
+    while (read(in, sizeof(in)) > 0)
+        ;
+
+    unsigned long start = micros();
+    unsigned long lastRx = millis();
+    while (result.received < total)
+    {
+        if (result.sent < total)
+        {
+            size_t n = total - result.sent < sizeof(out) ? total - result.sent : sizeof(out);
+            for (size_t i = 0; i < n; i++)
+            {
+                out[i] = next++;
+            }
+            result.sent += HardwareSerial::write(out, n);
+        }
+        size_t n = read(in, sizeof(in));
+        for (size_t i = 0; i < n; i++)
+        {
+            if (in[i] != expect)
+            {
+                result.gaps++;
+                expect = in[i];
+            }
+            expect++;
+        }
+        result.received += n;
+        if (n > 0)
+        {
+            lastRx = millis();
+        }
+        else if (result.sent >= total && (millis() - lastRx) > 100)
+        {
+            break;
+        }
+    }
+    result.micros = micros() - start;
+
+    uart_wait_tx_done(UART_NUM_2, pdMS_TO_TICKS(100));
+    uart_set_loop_back(UART_NUM_2, false);
+    updateBaudRate(saved);
+    resizeDriver(saved);
+    uart_set_pin(UART_NUM_2, PIN_TXD, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    while (read(in, sizeof(in)) > 0)
+        ;
+    return result;
+}
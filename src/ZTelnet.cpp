@@ -0,0 +1,251 @@
+#include "ZTelnet.h"
+#include <string.h>
+
+ZTelnet::ZTelnet()
+{
+    termType = "";
+    compress = false;
+    output = nullptr;
+    outputArg = nullptr;
+    reset();
+}
+
+void ZTelnet::reset()
+{
+    state = TS_DATA;
+    verb = 0;
+    sbOption = 0;
+    sbLen = 0;
+    replyLen = 0;
+    scratchLen = 0;
+    compressStart = false;
+}
+
+void ZTelnet::queue(const uint8_t *data, size_t len)
+{
+    // a reply that does not fit is dropped rather than sent truncated
+    if (replyLen + len <= sizeof(reply))
+    {
+        memcpy(reply + replyLen, data, len);
+        replyLen += len;
+    }
+}
+
+void ZTelnet::negotiate(uint8_t option)
+{
+    uint8_t answer[] = {TELNET_IAC, 0, option};
+    switch (verb)
+    {
+    case TELNET_WILL:
+        answer[1] = (option == TELNET_TERMTYPE || (option == TELNET_COMPRESS2 && compress)) ? TELNET_DO : TELNET_DONT;
+        break;
+    case TELNET_DO:
+        answer[1] = option == TELNET_TERMTYPE ? TELNET_WILL : TELNET_WONT;
+        break;
+    case TELNET_DONT:
+        answer[1] = TELNET_WONT;
+        break;
+    default:
+        return;
+    }
+    queue(answer, sizeof(answer));
+}
+
+void ZTelnet::subnegotiate()
+{
+    if (sbOption == TELNET_TERMTYPE && sbLen > 0 && sbBuf[0] == TELNET_TTYPE_SEND)
+    {
+        size_t len = strlen(termType);
+        if (replyLen + len + 6 <= sizeof(reply))
+        {
+            const uint8_t head[] = {TELNET_IAC, TELNET_SB, TELNET_TERMTYPE, TELNET_TTYPE_IS};
+            const uint8_t tail[] = {TELNET_IAC, TELNET_SE};
+            queue(head, sizeof(head));
+            queue((const uint8_t *)termType, len);
+            queue(tail, sizeof(tail));
+        }
+    }
+}
+
+size_t ZTelnet::receive(uint8_t *buf, size_t len, size_t *used)
+{
+    size_t k = 0;
+    size_t i = 0;
+
+    while (i < len)
+    {
+        if (state == TS_DATA)
+        {
+            // copy the clean span up to the next IAC in one go
+            const uint8_t *iac = (const uint8_t *)memchr(buf + i, TELNET_IAC, len - i);
+            size_t n = (iac != NULL ? (size_t)(iac - buf) : len) - i;
+            if (k != i)
+            {
+                memmove(buf + k, buf + i, n);
+            }
+            k += n;
+            i += n;
+            if (iac != NULL)
+            {
+                state = TS_IAC;
+                i++;
+            }
+            continue;
+        }
+
+        uint8_t c = buf[i++];
+        switch (state)
+        {
+        case TS_IAC:
+            switch (c)
+            {
+            case TELNET_IAC:
+                buf[k++] = TELNET_IAC;
+                state = TS_DATA;
+                break;
+            case TELNET_WILL:
+            case TELNET_WONT:
+            case TELNET_DO:
+            case TELNET_DONT:
+                verb = c;
+                state = TS_OPTION;
+                break;
+            case TELNET_SB:
+                state = TS_SB;
+                break;
+            default:
+                // NOP, GA, AYT and friends carry no data
+                state = TS_DATA;
+                break;
+            }
+            break;
+        case TS_OPTION:
+            negotiate(c);
+            state = TS_DATA;
+            break;
+        case TS_SB:
+            sbOption = c;
+            sbLen = 0;
+            state = TS_SB_DATA;
+            break;
+        case TS_SB_DATA:
+            if (c == TELNET_IAC)
+                state = TS_SB_IAC;
+            else if (sbLen < sizeof(sbBuf))
+                sbBuf[sbLen++] = c;
+            break;
+        case TS_SB_IAC:
+            if (c == TELNET_SE)
+            {
+                subnegotiate();
+                state = TS_DATA;
+                if (sbOption == TELNET_COMPRESS2 && compress)
+                {
+                    // the rest of the input is a zlib stream (MCCP2)
+                    compressStart = true;
+                    if (used != nullptr)
+                        *used = i;
+                    return k;
+                }
+            }
+            else
+            {
+                if (c == TELNET_IAC && sbLen < sizeof(sbBuf))
+                    sbBuf[sbLen++] = c;
+                state = TS_SB_DATA;
+            }
+            break;
+        case TS_DATA:
+            break;
+        }
+    }
+    if (used != nullptr)
+        *used = len;
+    return k;
+}
+
+size_t ZTelnet::cleanSpan(const uint8_t *buf, size_t len)
+{
+    size_t i = 0;
+
+    while (i < len && ((uintptr_t)(buf + i) & 3) != 0)
+    {
+        if (buf[i] == TELNET_IAC)
+            return i;
+        i++;
+    }
+    // a word holds an IAC when its complement has a zero byte
+    while (i + 4 <= len)
+    {
+        uint32_t v = ~*(const uint32_t *)(buf + i);
+        if (((v - 0x01010101UL) & ~v & 0x80808080UL) != 0)
+            break;
+        i += 4;
+    }
+    while (i < len && buf[i] != TELNET_IAC)
+    {
+        i++;
+    }
+    return i;
+}
+
+bool ZTelnet::flush()
+{
+    if (scratchLen > 0)
+    {
+        size_t n = output != nullptr ? output(outputArg, scratch, scratchLen) : 0;
+        if (n < scratchLen)
+        {
+            // keep the rest in order, it was already reported as sent
+            memmove(scratch, scratch + n, scratchLen - n);
+            scratchLen -= n;
+            return false;
+        }
+        scratchLen = 0;
+    }
+    return true;
+}
+
+// Returns how much of buf was taken.  Escaped bytes still in the scratch
+// buffer after a short write count as taken and go out first next time.
+size_t ZTelnet::send(const uint8_t *buf, size_t len)
+{
+    size_t i = 0;
+
+    if (output == nullptr || !flush())
+    {
+        return 0;
+    }
+    while (i < len)
+    {
+        size_t n = cleanSpan(buf + i, len - i);
+        if (n >= ZTELNET_TX_DIRECT)
+        {
+            // long clean runs go straight out without copying
+            if (!flush())
+                return i;
+            size_t sent = output(outputArg, buf + i, n);
+            i += sent;
+            if (sent < n)
+                return i;
+        }
+        else if (n > 0)
+        {
+            if (scratchLen + n > sizeof(scratch) && !flush())
+                return i;
+            memcpy(scratch + scratchLen, buf + i, n);
+            scratchLen += n;
+            i += n;
+        }
+        if (i < len)
+        {
+            if (scratchLen + 2 > sizeof(scratch) && !flush())
+                return i;
+            scratch[scratchLen++] = TELNET_IAC;
+            scratch[scratchLen++] = TELNET_IAC;
+            i++;
+        }
+    }
+    flush();
+    return i;
+}
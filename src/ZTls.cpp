@@ -0,0 +1,326 @@
+#include "ZTls.h"
+#include "ZDebug.h"
+#include <lwip/sockets.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl_internal.h>
+
+ZTlsSessionCache TlsSessions;
+
+mbedtls_ssl_config ZTls::conf;
+mbedtls_entropy_context ZTls::entropy;
+mbedtls_ctr_drbg_context ZTls::drbg;
+bool ZTls::configured = false;
+
+ZTlsSessionCache::ZTlsSessionCache()
+{
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++)
+    {
+        entries[i].host[0] = '\0';
+        entries[i].valid = false;
+        entries[i].used = 0;
+        mbedtls_ssl_session_init(&entries[i].session);
+    }
+    m_handshakes = 0;
+    m_resumed = 0;
+}
+
+const mbedtls_ssl_session *ZTlsSessionCache::find(const char *host, uint16_t port)
+{
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++)
+    {
+        ZTlsSession &e = entries[i];
+        if (e.valid && e.port == port && strcasecmp(e.host, host) == 0)
+        {
+            e.used = millis();
+            return &e.session;
+        }
+    }
+    return nullptr;
+}
+
+void ZTlsSessionCache::store(const char *host, uint16_t port, const mbedtls_ssl_context *ssl, bool resumed)
+{
+    m_handshakes++;
+    if (resumed)
+    {
+        m_resumed++;
+    }
+    // replace the entry for this host, else the least recently used one
+    ZTlsSession *slot = &entries[0];
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++)
+    {
+        ZTlsSession &e = entries[i];
+        if (e.valid && e.port == port && strcasecmp(e.host, host) == 0)
+        {
+            slot = &e;
+            break;
+        }
+        if (!e.valid || (slot->valid && e.used < slot->used))
+        {
+            slot = &e;
+        }
+    }
+    mbedtls_ssl_session_free(&slot->session);
+    mbedtls_ssl_session_init(&slot->session);
+    slot->valid = mbedtls_ssl_get_session(ssl, &slot->session) == 0;
+    strncpy(slot->host, host, sizeof(slot->host) - 1);
+    slot->host[sizeof(slot->host) - 1] = '\0';
+    slot->port = port;
+    slot->used = millis();
+}
+
+void ZTlsSessionCache::flush()
+{
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++)
+    {
+        mbedtls_ssl_session_free(&entries[i].session);
+        mbedtls_ssl_session_init(&entries[i].session);
+        entries[i].valid = false;
+    }
+}
+
+bool ZTls::configure()
+{
+    if (configured)
+    {
+        return true;
+    }
+    mbedtls_ssl_config_init(&conf);
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&drbg);
+    if (mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, nullptr, 0) != 0 ||
+        mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT) != 0)
+    {
+        return false;
+    }
+    // BBS hosts mostly run self-signed certificates, like a telnet dial the
+    // peer is not authenticated
+    mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &drbg);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+    configured = true;
+    return true;
+}
+
+ZTls::ZTls()
+{
+    mbedtls_ssl_init(&ssl);
+    m_host[0] = '\0';
+}
+
+ZTls::~ZTls()
+{
+    mbedtls_ssl_free(&ssl);
+}
+
+bool ZTls::begin(int fd, const char *host, uint16_t port)
+{
+    if (!configure() || mbedtls_ssl_setup(&ssl, &conf) != 0)
+    {
+        return false;
+    }
+    strncpy(m_host, host, sizeof(m_host) - 1);
+    m_host[sizeof(m_host) - 1] = '\0';
+    m_port = port;
+    m_fd = fd;
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    mbedtls_ssl_set_hostname(&ssl, m_host);
+    mbedtls_ssl_set_bio(&ssl, this, &ZTls::callbackSend, &ZTls::callbackRecv, nullptr);
+    const mbedtls_ssl_session *cached = TlsSessions.find(m_host, m_port);
+    if (cached != nullptr)
+    {
+        mbedtls_ssl_set_session(&ssl, cached);
+    }
+    m_resumed = false;
+    m_started = millis();
+    state = HANDSHAKE;
+    return true;
+}
+
+int ZTls::poll()
+{
+    if (state != HANDSHAKE)
+    {
+        return state == OPEN ? ZTLS_DONE : ZTLS_FAILED;
+    }
+    // stepped by hand so an abbreviated handshake can be told from a full one
+    while (ssl.state != MBEDTLS_SSL_HANDSHAKE_OVER)
+    {
+        int ret = mbedtls_ssl_handshake_step(&ssl);
+        if (ssl.handshake != nullptr && ssl.handshake->resume)
+        {
+            m_resumed = true;
+        }
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+        {
+            if ((millis() - m_started) >= TLS_HANDSHAKE_TIMEOUT)
+            {
+                fail(ret);
+                return ZTLS_FAILED;
+            }
+            return ZTLS_PENDING;
+        }
+        if (ret != 0)
+        {
+            fail(ret);
+            return ZTLS_FAILED;
+        }
+    }
+    m_handshakeTime = millis() - m_started;
+    DPRINTF("TLS %s %s handshake %lu ms\n", cipher(), m_resumed ? "resumed" : "full", m_handshakeTime);
+    TlsSessions.store(m_host, m_port, &ssl, m_resumed);
+    state = OPEN;
+    return ZTLS_DONE;
+}
+
+void ZTls::fail(int ret)
+{
+    DPRINTF("TLS handshake failed: -0x%04x\n", -ret);
+    state = CLOSED;
+}
+
+void ZTls::updateBuffered()
+{
+    m_buffered = mbedtls_ssl_get_bytes_avail(&ssl) + (m_peek >= 0 ? 1 : 0);
+}
+
+int ZTls::available()
+{
+    if (state == OPEN)
+    {
+        // a zero length read pulls in the next record without consuming it
+        int ret = mbedtls_ssl_read(&ssl, nullptr, 0);
+        if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+        {
+            state = CLOSED;
+        }
+    }
+    updateBuffered();
+    return m_buffered;
+}
+
+int ZTls::read(uint8_t *buf, size_t size)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+    int n = 0;
+    if (m_peek >= 0)
+    {
+        buf[n++] = m_peek;
+        m_peek = -1;
+    }
+    if (state != OPEN || (size_t)n == size)
+    {
+        updateBuffered();
+        return n;
+    }
+    int ret = mbedtls_ssl_read(&ssl, buf + n, size - n);
+    if (ret > 0)
+    {
+        n += ret;
+    }
+    else if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+    {
+        // close_notify or a broken connection
+        state = CLOSED;
+    }
+    updateBuffered();
+    return n > 0 ? n : -1;
+}
+
+int ZTls::peek()
+{
+    if (m_peek < 0)
+    {
+        uint8_t c;
+        if (read(&c, 1) == 1)
+        {
+            m_peek = c;
+            updateBuffered();
+        }
+    }
+    return m_peek;
+}
+
+// Never waits for the socket.  What it will not take now is left to the
+// caller, which must offer the same bytes again: a record that went out in
+// part is finished from the retry, as mbedtls requires.
+size_t ZTls::write(const uint8_t *buf, size_t size)
+{
+    size_t done = 0;
+    while (state == OPEN && done < size)
+    {
+        size_t len = size - done;
+        if (m_unsent > 0)
+        {
+            if (len < m_unsent)
+            {
+                break;
+            }
+            len = m_unsent;
+        }
+        int ret = mbedtls_ssl_write(&ssl, buf + done, len);
+        if (ret > 0)
+        {
+            done += ret;
+            m_unsent = 0;
+        }
+        else if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+        {
+            if (m_unsent == 0)
+            {
+                int record = mbedtls_ssl_get_max_out_record_payload(&ssl);
+                m_unsent = record > 0 && (size_t)record < len ? record : len;
+            }
+            break;
+        }
+        else
+        {
+            state = CLOSED;
+        }
+    }
+    return done;
+}
+
+void ZTls::close()
+{
+    if (state == OPEN)
+    {
+        mbedtls_ssl_close_notify(&ssl);
+    }
+    state = CLOSED;
+}
+
+int ZTls::callbackSend(void *ctx, const unsigned char *buf, size_t len)
+{
+    return reinterpret_cast<ZTls *>(ctx)->send(buf, len);
+}
+
+int ZTls::callbackRecv(void *ctx, unsigned char *buf, size_t len)
+{
+    return reinterpret_cast<ZTls *>(ctx)->recv(buf, len);
+}
+
+int ZTls::send(const unsigned char *buf, size_t len)
+{
+    int ret = lwip_send(m_fd, buf, len, 0);
+    if (ret < 0)
+    {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_SEND_FAILED;
+    }
+    return ret;
+}
+
+int ZTls::recv(unsigned char *buf, size_t len)
+{
+    int ret = lwip_recv(m_fd, buf, len, 0);
+    if (ret < 0)
+    {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_RECV_FAILED;
+    }
+    return ret;
+}
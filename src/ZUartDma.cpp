@@ -0,0 +1,191 @@
+#include "ZUartDma.h"
+#include "ZDebug.h"
+#include <driver/uart.h>
+#include <driver/periph_ctrl.h>
+#include <esp_heap_caps.h>
+#include <soc/uhci_struct.h>
+#include <soc/uhci_reg.h>
+
+ZUartDma::~ZUartDma()
+{
+    end();
+}
+
+void IRAM_ATTR ZUartDma::isr(void *arg)
+{
+    ZUartDma *self = reinterpret_cast<ZUartDma *>(arg);
+    uint32_t status = UHCI0.int_st.val;
+    UHCI0.int_clr.val = status;
+    if (status & (UHCI_IN_DSCR_EMPTY_INT_ST | UHCI_IN_DSCR_ERR_INT_ST))
+    {
+        self->overrun = true;
+    }
+    if (self->notify != nullptr && (status & (UHCI_IN_SUC_EOF_INT_ST | UHCI_IN_DONE_INT_ST)))
+    {
+        self->notify(self->notifyArg);
+    }
+}
+
+bool ZUartDma::begin(void (*onData)(void *), void *arg)
+{
+    if (running())
+    {
+        return true;
+    }
+    descs = (lldesc_t *)heap_caps_calloc(ZSERIAL_DMA_BLOCKS, sizeof(lldesc_t), MALLOC_CAP_DMA);
+    blocks = (uint8_t *)heap_caps_malloc(ZSERIAL_DMA_BLOCKS * ZSERIAL_DMA_BLOCK_SIZE, MALLOC_CAP_DMA);
+    if (descs == nullptr || blocks == nullptr)
+    {
+        end();
+        return false;
+    }
+    for (int i = 0; i < ZSERIAL_DMA_BLOCKS; i++)
+    {
+        descs[i].size = ZSERIAL_DMA_BLOCK_SIZE;
+        descs[i].length = 0;
+        descs[i].eof = 0;
+        descs[i].owner = 1;
+        descs[i].buf = blocks + i * ZSERIAL_DMA_BLOCK_SIZE;
+        descs[i].qe.stqe_next = &descs[(i + 1) % ZSERIAL_DMA_BLOCKS];
+    }
+    readDesc = 0;
+    readOffset = 0;
+    overrun = false;
+    notify = onData;
+    notifyArg = arg;
+
+    // the driver must stop draining the FIFO, the DMA engine owns it now
+    uart_disable_rx_intr(UART_NUM_2);
+    uart_flush_input(UART_NUM_2);
+
+    periph_module_enable(PERIPH_UHCI0_MODULE);
+    enabled = true;
+    UHCI0.conf0.val = 0;
+    UHCI0.conf0.in_rst = 1;
+    UHCI0.conf0.in_rst = 0;
+    UHCI0.conf0.ahbm_rst = 1;
+    UHCI0.conf0.ahbm_rst = 0;
+    // raw bytes: no SLIP separators, headers, CRC or escaping
+    UHCI0.conf0.uart2_ce = 1;
+    UHCI0.conf0.uart_idle_eof_en = 1;
+    UHCI0.conf0.indscr_burst_en = 1;
+    UHCI0.conf0.clk_en = 1;
+    UHCI0.conf1.val = 0;
+    UHCI0.conf1.crc_disable = 1;
+    UHCI0.conf1.check_owner = 1;
+    UHCI0.escape_conf.val = 0;
+    UHCI0.int_clr.val = 0xFFFFFFFF;
+    UHCI0.int_ena.val = UHCI_IN_SUC_EOF_INT_ENA | UHCI_IN_DONE_INT_ENA | UHCI_IN_DSCR_EMPTY_INT_ENA | UHCI_IN_DSCR_ERR_INT_ENA;
+    if (esp_intr_alloc(ETS_UHCI0_INTR_SOURCE, ESP_INTR_FLAG_IRAM, &ZUartDma::isr, this, &intr) != ESP_OK)
+    {
+        DPRINTLN("UHCI interrupt unavailable");
+        end();
+        return false;
+    }
+    UHCI0.dma_in_link.addr = (uint32_t)&descs[0] & UHCI_INLINK_ADDR_V;
+    UHCI0.dma_in_link.start = 1;
+    return true;
+}
+
+void ZUartDma::end()
+{
+    // the registers are only there while the module is clocked
+    if (enabled)
+    {
+        UHCI0.dma_in_link.stop = 1;
+        UHCI0.int_ena.val = 0;
+        UHCI0.conf0.uart2_ce = 0;
+        periph_module_disable(PERIPH_UHCI0_MODULE);
+        uart_flush_input(UART_NUM_2);
+        uart_enable_rx_intr(UART_NUM_2);
+        enabled = false;
+    }
+    if (intr != nullptr)
+    {
+        esp_intr_free(intr);
+        intr = nullptr;
+    }
+    heap_caps_free(descs);
+    heap_caps_free(blocks);
+    descs = nullptr;
+    blocks = nullptr;
+}
+
+void ZUartDma::recycle(lldesc_t *d)
+{
+    d->length = 0;
+    d->eof = 0;
+    d->owner = 1;
+    stats.blocks++;
+    readOffset = 0;
+    readDesc = (readDesc + 1) % ZSERIAL_DMA_BLOCKS;
+    if (overrun)
+    {
+        // the engine stopped on a block we held, it can go on now
+        overrun = false;
+        stats.overruns++;
+        UHCI0.dma_in_link.restart = 1;
+    }
+}
+
+size_t ZUartDma::available()
+{
+    if (!running())
+    {
+        return 0;
+    }
+    size_t avail = 0;
+    int i = readDesc;
+    size_t offset = readOffset;
+    for (int n = 0; n < ZSERIAL_DMA_BLOCKS && descs[i].owner == 0; n++)
+    {
+        avail += descs[i].length - offset;
+        offset = 0;
+        i = (i + 1) % ZSERIAL_DMA_BLOCKS;
+    }
+    return avail;
+}
+
+size_t ZUartDma::read(uint8_t *buf, size_t len)
+{
+    size_t done = 0;
+    while (running() && done < len && descs[readDesc].owner == 0)
+    {
+        lldesc_t *d = &descs[readDesc];
+        size_t n = d->length - readOffset;
+        if (n > len - done)
+        {
+            n = len - done;
+        }
+        memcpy(buf + done, (const uint8_t *)d->buf + readOffset, n);
+        done += n;
+        readOffset += n;
+        if (readOffset >= d->length)
+        {
+            recycle(d);
+        }
+    }
+    stats.bytes += done;
+    return done;
+}
+
+int ZUartDma::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int ZUartDma::peek()
+{
+    while (running() && descs[readDesc].owner == 0)
+    {
+        lldesc_t *d = &descs[readDesc];
+        if (readOffset < d->length)
+        {
+            return d->buf[readOffset];
+        }
+        // an empty block closed by an idle EOF
+        recycle(d);
+    }
+    return -1;
+}
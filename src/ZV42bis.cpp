@@ -0,0 +1,319 @@
+#include "ZV42bis.h"
+#include <stdlib.h>
+#include <string.h>
+
+ZV42bisDictionary::~ZV42bisDictionary()
+{
+    end();
+}
+
+bool ZV42bisDictionary::begin()
+{
+    if (t == nullptr)
+    {
+        t = (Tables *)malloc(sizeof(Tables));
+    }
+    if (t != nullptr)
+    {
+        clear();
+    }
+    return t != nullptr;
+}
+
+void ZV42bisDictionary::end()
+{
+    free(t);
+    t = nullptr;
+}
+
+void ZV42bisDictionary::clear()
+{
+    memset(t->child, 0, sizeof(t->child));
+    next = V42BIS_N5;
+    full = false;
+    bits = 9;
+    threshold = 1 << bits;
+}
+
+uint16_t ZV42bisDictionary::find(uint16_t node, uint8_t c)
+{
+    for (uint16_t k = t->child[node]; k != 0; k = t->sibling[k])
+    {
+        if (t->symbol[k] == c)
+        {
+            return k;
+        }
+    }
+    return 0;
+}
+
+uint16_t ZV42bisDictionary::slot(uint16_t parent)
+{
+    if (!full)
+    {
+        return next;
+    }
+    // the oldest leaf that is not the prefix of the new string
+    uint16_t k = next;
+    while (t->child[k] != 0 || k == parent)
+    {
+        k = k + 1 < V42BIS_DICT_SIZE ? k + 1 : V42BIS_N5;
+    }
+    return k;
+}
+
+void ZV42bisDictionary::add(uint16_t parent, uint8_t c)
+{
+    uint16_t k = slot(parent);
+    if (full)
+    {
+        uint16_t p = t->parent[k];
+        if (t->child[p] == k)
+        {
+            t->child[p] = t->sibling[k];
+        }
+        else
+        {
+            uint16_t s = t->child[p];
+            while (t->sibling[s] != k)
+            {
+                s = t->sibling[s];
+            }
+            t->sibling[s] = t->sibling[k];
+        }
+    }
+    t->parent[k] = parent;
+    t->symbol[k] = c;
+    t->child[k] = 0;
+    t->sibling[k] = t->child[parent];
+    t->child[parent] = k;
+    next = k + 1;
+    if (next >= V42BIS_DICT_SIZE)
+    {
+        next = V42BIS_N5;
+        full = true;
+    }
+}
+
+bool ZV42bisEncoder::begin()
+{
+    if (!ZV42bisDictionary::begin())
+    {
+        return false;
+    }
+    reset();
+    return true;
+}
+
+void ZV42bisEncoder::reset()
+{
+    clear();
+    code = 0;
+    length = 0;
+    acc = 0;
+    accBits = 0;
+}
+
+void ZV42bisEncoder::put(uint16_t value, uint8_t n)
+{
+    acc |= (uint32_t)value << accBits;
+    accBits += n;
+    while (accBits >= 8)
+    {
+        *out++ = acc & 0xFF;
+        acc >>= 8;
+        accBits -= 8;
+    }
+}
+
+void ZV42bisEncoder::emit(uint16_t value)
+{
+    while (value >= threshold)
+    {
+        put(V42BIS_STEPUP, bits);
+        bits++;
+        threshold <<= 1;
+    }
+    put(value, bits);
+}
+
+size_t ZV42bisEncoder::encode(const uint8_t *data, size_t len, uint8_t *output)
+{
+    out = output;
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t c = data[i];
+        if (code == 0)
+        {
+            code = c + V42BIS_N6;
+            length = 1;
+            continue;
+        }
+        uint16_t k = length < V42BIS_MAX_STRING ? find(code, c) : 0;
+        if (k != 0)
+        {
+            code = k;
+            length++;
+            continue;
+        }
+        emit(code);
+        if (length < V42BIS_MAX_STRING)
+        {
+            add(code, c);
+        }
+        code = c + V42BIS_N6;
+        length = 1;
+    }
+    return out - output;
+}
+
+size_t ZV42bisEncoder::flush(uint8_t *output)
+{
+    // the partial string goes out as is, the decoder starts a new one after FLUSH
+    out = output;
+    if (code != 0)
+    {
+        emit(code);
+        code = 0;
+        length = 0;
+    }
+    put(V42BIS_FLUSH, bits);
+    if (accBits > 0)
+    {
+        put(0, 8 - accBits);
+    }
+    return out - output;
+}
+
+size_t ZV42bisEncoder::finish(uint8_t *output)
+{
+    // ETM hands the link back to plain bytes, the decoder stops at the
+    // octet boundary after it
+    out = output;
+    if (code != 0)
+    {
+        emit(code);
+        code = 0;
+        length = 0;
+    }
+    put(V42BIS_ETM, bits);
+    if (accBits > 0)
+    {
+        put(0, 8 - accBits);
+    }
+    return out - output;
+}
+
+bool ZV42bisDecoder::begin()
+{
+    if (!ZV42bisDictionary::begin())
+    {
+        return false;
+    }
+    reset();
+    return true;
+}
+
+void ZV42bisDecoder::reset()
+{
+    clear();
+    prev = 0;
+    prevLength = 0;
+    prevFirst = 0;
+    acc = 0;
+    accBits = 0;
+    failed = false;
+    ended = false;
+}
+
+size_t ZV42bisDecoder::expand(uint16_t node, uint8_t *output)
+{
+    size_t n = 0;
+    for (uint16_t k = node; k >= V42BIS_N5; k = t->parent[k])
+    {
+        n++;
+    }
+    n++;
+    size_t i = n;
+    uint16_t k = node;
+    while (k >= V42BIS_N5)
+    {
+        output[--i] = t->symbol[k];
+        k = t->parent[k];
+    }
+    output[--i] = k - V42BIS_N6;
+    return n;
+}
+
+size_t ZV42bisDecoder::decode(const uint8_t *data, size_t len, uint8_t *output, size_t *used)
+{
+    uint8_t *o = output;
+    size_t i = 0;
+    for (; i < len && !failed && !ended; i++)
+    {
+        acc |= (uint32_t)data[i] << accBits;
+        accBits += 8;
+        while (accBits >= bits && !failed)
+        {
+            uint16_t value = acc & ((1 << bits) - 1);
+            acc >>= bits;
+            accBits -= bits;
+            if (value == V42BIS_STEPUP)
+            {
+                bits++;
+                continue;
+            }
+            if (value == V42BIS_FLUSH)
+            {
+                // the encoder padded to an octet boundary
+                acc >>= accBits % 8;
+                accBits -= accBits % 8;
+                prev = 0;
+                continue;
+            }
+            if (value == V42BIS_ETM)
+            {
+                // the rest of this octet is padding, what follows is not ours
+                acc = 0;
+                accBits = 0;
+                ended = true;
+                break;
+            }
+            if (value >= V42BIS_DICT_SIZE || (!full && value > next))
+            {
+                failed = true;
+                break;
+            }
+            size_t n;
+            if (prev != 0 && prevLength < V42BIS_MAX_STRING)
+            {
+                uint16_t k = slot(prev);
+                if (value == k)
+                {
+                    // the string being defined by this very codeword
+                    n = expand(prev, o);
+                    o[n++] = prevFirst;
+                    add(prev, prevFirst);
+                }
+                else
+                {
+                    n = expand(value, o);
+                    add(prev, o[0]);
+                }
+            }
+            else
+            {
+                n = expand(value, o);
+            }
+            prev = value;
+            prevLength = n;
+            prevFirst = o[0];
+            o += n;
+        }
+    }
+    if (used != nullptr)
+    {
+        *used = i;
+    }
+    return o - output;
+}
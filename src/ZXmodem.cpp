@@ -0,0 +1,338 @@
+#include "ZXmodem.h"
+#include "ZCrc16.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+// the native env links every module into every test; the XMODEM test
+// drives the clock with its own millis()
+__attribute__((weak)) unsigned long millis()
+{
+    return 0;
+}
+#endif
+
+ZXmodem::~ZXmodem()
+{
+    end();
+}
+
+bool ZXmodem::begin(ZXmodemOutput toRemote, ZXmodemOutput toDte, void *arg)
+{
+    if (window == nullptr)
+    {
+        window = (uint8_t *)malloc(XMODEM_WINDOW * XMODEM_MAX_BLOCK);
+    }
+    this->toRemote = toRemote;
+    this->toDte = toDte;
+    this->arg = arg;
+    reset();
+    return window != nullptr;
+}
+
+void ZXmodem::end()
+{
+    free(window);
+    window = nullptr;
+    reset();
+}
+
+void ZXmodem::reset()
+{
+    state = IDLE;
+    head = 0;
+    count = 0;
+    blockLen = 0;
+    lastRemote = 0;
+    ackOwed = false;
+}
+
+size_t ZXmodem::fromDte(const uint8_t *data, size_t len)
+{
+    // bytes outside a transfer go on in runs, not one by one
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t c = data[i];
+        if (state == IDLE && blockLen == 0)
+        {
+            if ((c != XMODEM_SOH && c != XMODEM_STX) || (lastRemote != XMODEM_NAK && lastRemote != XMODEM_CRC))
+            {
+                continue;
+            }
+            // could be block 1 of a transfer the remote end just asked for
+            if (i > start)
+            {
+                toRemote(arg, data + start, i - start);
+            }
+            crc = lastRemote == XMODEM_CRC;
+        }
+        dte(c);
+        start = i + 1;
+    }
+    if (len > start)
+    {
+        toRemote(arg, data + start, len - start);
+    }
+    if (len > 0)
+    {
+        lastDteByte = millis();
+    }
+    return len;
+}
+
+void ZXmodem::dte(uint8_t c)
+{
+    if (blockLen > 0)
+    {
+        block[blockLen++] = c;
+        if (blockLen == blockSize)
+        {
+            blockReceived();
+        }
+        return;
+    }
+    switch (c)
+    {
+    case XMODEM_SOH:
+    case XMODEM_STX:
+        block[0] = c;
+        blockLen = 1;
+        blockSize = 3 + (c == XMODEM_SOH ? 128 : 1024) + (crc ? 2 : 1);
+        break;
+    case XMODEM_EOT:
+        if (count == 0)
+        {
+            finish();
+        }
+        else
+        {
+            state = DRAINING;
+        }
+        break;
+    case XMODEM_CAN:
+        // the sender gave up, the remote end hears it from the sender's CANs
+        toRemote(arg, &c, 1);
+        stats.cancels++;
+        reset();
+        break;
+    default:
+        // line noise between blocks
+        break;
+    }
+}
+
+bool ZXmodem::verify(const uint8_t *data, size_t len)
+{
+    if (data[1] != (uint8_t)~data[2])
+    {
+        return false;
+    }
+    const uint8_t *payload = data + 3;
+    size_t size = len - 3 - (crc ? 2 : 1);
+    if (crc)
+    {
+        return ZCrc16::update(0, payload, size) == ((payload[size] << 8) | payload[size + 1]);
+    }
+    uint8_t sum = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        sum += payload[i];
+    }
+    return sum == payload[size];
+}
+
+void ZXmodem::blockReceived()
+{
+    bool ok = verify(block, blockSize);
+    uint8_t number = block[1];
+    if (state == IDLE)
+    {
+        if (ok && number == 1 && window != nullptr)
+        {
+            state = ACTIVE;
+            lastBlock = 0;
+            remoteAcked = false;
+            retries = 0;
+            stats.transfers++;
+            queue();
+        }
+        else
+        {
+            // not ours (or a YMODEM header), hand it on unchanged
+            passBlock();
+        }
+    }
+    else if (!ok)
+    {
+        reply(XMODEM_NAK);
+        stats.localNaks++;
+    }
+    else if (number == lastBlock)
+    {
+        // the DTE timed out waiting for an ACK we still owe it
+        if (!ackOwed)
+        {
+            reply(XMODEM_ACK);
+        }
+    }
+    else if (number == (uint8_t)(lastBlock + 1) && state == ACTIVE)
+    {
+        queue();
+    }
+    else
+    {
+        cancel();
+    }
+    blockLen = 0;
+}
+
+void ZXmodem::reply(uint8_t c)
+{
+    toDte(arg, &c, 1);
+}
+
+void ZXmodem::passBlock()
+{
+    toRemote(arg, block, blockLen);
+    blockLen = 0;
+}
+
+void ZXmodem::queue()
+{
+    int slot = (head + count) % XMODEM_WINDOW;
+    memcpy(window + slot * XMODEM_MAX_BLOCK, block, blockSize);
+    sizes[slot] = blockSize;
+    if (count == 0)
+    {
+        lastRemoteReply = millis();
+    }
+    count++;
+    lastBlock = block[1];
+    toRemote(arg, block, blockSize);
+    stats.blocks++;
+    if (count < XMODEM_WINDOW)
+    {
+        reply(XMODEM_ACK);
+    }
+    else
+    {
+        // window full, the DTE waits for the remote end to catch up
+        ackOwed = true;
+    }
+}
+
+void ZXmodem::resend()
+{
+    if (++retries > XMODEM_RETRIES)
+    {
+        cancel();
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        int slot = (head + i) % XMODEM_WINDOW;
+        toRemote(arg, window + slot * XMODEM_MAX_BLOCK, sizes[slot]);
+    }
+    stats.resent += count;
+    lastRemoteReply = millis();
+}
+
+void ZXmodem::acknowledged()
+{
+    if (count == 0)
+    {
+        return;
+    }
+    head = (head + 1) % XMODEM_WINDOW;
+    count--;
+    retries = 0;
+    if (ackOwed)
+    {
+        reply(XMODEM_ACK);
+        ackOwed = false;
+    }
+    if (count == 0 && state == DRAINING)
+    {
+        finish();
+    }
+}
+
+void ZXmodem::finish()
+{
+    // the remote end's answer to EOT goes straight back to the DTE
+    static const uint8_t eot = XMODEM_EOT;
+    toRemote(arg, &eot, 1);
+    reset();
+}
+
+void ZXmodem::cancel()
+{
+    static const uint8_t cans[] = {XMODEM_CAN, XMODEM_CAN, XMODEM_CAN};
+    toDte(arg, cans, sizeof(cans));
+    toRemote(arg, cans, sizeof(cans));
+    stats.cancels++;
+    reset();
+}
+
+size_t ZXmodem::fromRemote(uint8_t *data, size_t len)
+{
+    // filters in place, returns what is left for the DTE
+    size_t out = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t c = data[i];
+        if (state == IDLE)
+        {
+            lastRemote = c;
+            data[out++] = c;
+            continue;
+        }
+        lastRemoteReply = millis();
+        switch (c)
+        {
+        case XMODEM_ACK:
+            remoteAcked = true;
+            acknowledged();
+            break;
+        case XMODEM_NAK:
+            // NAKs before the first ACK repeat the request for block 1
+            if (remoteAcked)
+            {
+                resend();
+            }
+            break;
+        case XMODEM_CAN:
+            data[out++] = c;
+            stats.cancels++;
+            reset();
+            break;
+        default:
+            break;
+        }
+    }
+    return out;
+}
+
+void ZXmodem::poll()
+{
+    unsigned long now = millis();
+    if (state == IDLE)
+    {
+        if (blockLen > 0 && (now - lastDteByte) >= XMODEM_HOLD_TIME)
+        {
+            passBlock();
+        }
+        return;
+    }
+    if (count > 0 && (now - lastRemoteReply) >= XMODEM_TIMEOUT)
+    {
+        resend();
+    }
+    else if (count == 0 && (now - lastDteByte) >= XMODEM_ABANDON_TIME)
+    {
+        // the DTE went away mid transfer
+        reset();
+    }
+}
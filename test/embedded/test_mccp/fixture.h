@@ -0,0 +1,231 @@
+// Generated by tools/mccp_fixture.py, 1200 lines, 58992 bytes inflated
+#define MCCP_FIXTURE_LINES 1200
+static const uint8_t MCCP_FIXTURE[3617] = {
+    0x57, 0x65, 0x6c, 0x63, 0x6f, 0x6d, 0x65, 0x20, 0x74, 0x6f, 0x20, 0x74, 0x68, 0x65, 0x20, 0x66,
+    0x69, 0x78, 0x74, 0x75, 0x72, 0x65, 0x20, 0x4d, 0x55, 0x44, 0x0d, 0x0a, 0xff, 0xfb, 0x56, 0xff,
+    0xfa, 0x56, 0xff, 0xf0, 0x78, 0xda, 0x9d, 0xd8, 0x3d, 0x8e, 0xac, 0xc9, 0x71, 0x86, 0x51, 0x5f,
+    0x80, 0xf6, 0xd0, 0x2b, 0x10, 0x3a, 0xf2, 0x27, 0x22, 0x73, 0x07, 0x32, 0x65, 0xc8, 0x23, 0x64,
+    0x10, 0xd2, 0x40, 0x1a, 0x43, 0x24, 0xa0, 0x4b, 0x42, 0xd0, 0xd2, 0x69, 0x8d, 0x72, 0xc0, 0xc4,
+    0xb5, 0xf3, 0x54, 0x39, 0xe5, 0xc4, 0x8b, 0x36, 0x1e, 0x54, 0xf5, 0x57, 0xe7, 0xfb, 0xfb, 0xbc,
+    0xbe, 0xfe, 0xf5, 0xbf, 0x7e, 0xf9, 0xfa, 0xf3, 0xff, 0xfc, 0xfb, 0xd7, 0x8f, 0xff, 0xfd, 0xf5,
+    0x4f, 0xff, 0xf9, 0xe3, 0xeb, 0x8f, 0x7f, 0xf9, 0xfa, 0xbf, 0x3f, 0xff, 0xf5, 0xeb, 0x8f, 0x7f,
+    0xfa, 0x8f, 0xaf, 0xff, 0xfe, 0xf5, 0xc7, 0x8f, 0x5f, 0x7e, 0xfc, 0xd3, 0xd7, 0x1f, 0xfe, 0xf9,
+    0x5f, 0xbe, 0xe2, 0xfb, 0xfb, 0xdf, 0xfe, 0xf1, 0x1f, 0x7e, 0x1f, 0xc4, 0xe3, 0x62, 0xef, 0x3b,
+    0x68, 0xaf, 0x83, 0x75, 0x07, 0xfd, 0x75, 0x50, 0x77, 0x30, 0x5e, 0x07, 0x79, 0x07, 0xf3, 0x75,
+    0x30, 0xef, 0x20, 0x5f, 0x07, 0xe3, 0x0e, 0xea, 0x75, 0xd0, 0xef, 0x60, 0xbd, 0x0e, 0xda, 0x1d,
+    0xec, 0xd7, 0x41, 0x9c, 0xc1, 0x6f, 0x7f, 0xfb, 0xbd, 0xdc, 0x6b, 0xec, 0x7d, 0x5b, 0xc7, 0x6b,
+    0xeb, 0x75, 0x5b, 0xc7, 0x6b, 0xeb, 0x75, 0x5b, 0xc7, 0x6b, 0xeb, 0x75, 0x5b, 0xc7, 0x6b, 0xeb,
+    0x75, 0x5b, 0xc7, 0x6b, 0xeb, 0x75, 0x5b, 0xc7, 0x6b, 0xeb, 0x75, 0x5b, 0xc7, 0x6b, 0xeb, 0x75,
+    0x5b, 0xc7, 0x6b, 0xeb, 0x75, 0x5b, 0xc7, 0x6b, 0xeb, 0xf5, 0xb3, 0x75, 0x7b, 0x6d, 0xbd, 0x6e,
+    0xeb, 0xf6, 0xda, 0xba, 0x6e, 0xeb, 0xf6, 0xda, 0xba, 0x6e, 0xeb, 0xf6, 0xda, 0xba, 0x6e, 0xeb,
+    0xf6, 0xda, 0xba, 0x6e, 0xeb, 0xf6, 0xda, 0xba, 0x6e, 0xeb, 0xf6, 0xda, 0xba, 0x6e, 0xeb, 0xf6,
+    0xda, 0xba, 0x6e, 0xeb, 0xf6, 0xda, 0xba, 0x6e, 0xeb, 0xf6, 0xda, 0xba, 0x7e, 0xb6, 0xee, 0xaf,
+    0xad, 0xeb, 0xb6, 0xee, 0xaf, 0xad, 0xf3, 0xb6, 0xee, 0xaf, 0xad, 0xf3, 0xb6, 0xee, 0xaf, 0xad,
+    0xf3, 0xb6, 0xee, 0xaf, 0xad, 0xf3, 0xb6, 0xee, 0xaf, 0xad, 0xf3, 0xb6, 0xee, 0xaf, 0xad, 0xf3,
+    0xb6, 0xee, 0xaf, 0xad, 0xf3, 0xb6, 0xee, 0xaf, 0xad, 0xf3, 0xb6, 0xee, 0xaf, 0xad, 0xf3, 0x67,
+    0xeb, 0xf1, 0xda, 0x3a, 0x6f, 0xeb, 0xf1, 0xda, 0x7a, 0xde, 0xd6, 0xe3, 0xb5, 0xf5, 0xbc, 0xad,
+    0xc7, 0x6b, 0xeb, 0x79, 0x5b, 0x8f, 0xd7, 0xd6, 0xf3, 0xb6, 0x1e, 0xaf, 0xad, 0xe7, 0x6d, 0x3d,
+    0x5e, 0x5b, 0xcf, 0xdb, 0x7a, 0xbc, 0xb6, 0x9e, 0xb7, 0xf5, 0x78, 0x6d, 0x3d, 0x6f, 0xeb, 0xf1,
+    0xda, 0x7a, 0xfe, 0xbd, 0xf5, 0x6f, 0xbf, 0xfd, 0xfe, 0x9c, 0xf2, 0x5a, 0x7b, 0xde, 0xda, 0xf3,
+    0xb5, 0xf6, 0xb8, 0xb5, 0xe7, 0x6b, 0xed, 0x71, 0x6b, 0xcf, 0xd7, 0xda, 0xe3, 0xd6, 0x9e, 0xaf,
+    0xb5, 0xc7, 0xad, 0x3d, 0x5f, 0x6b, 0x8f, 0x5b, 0x7b, 0xbe, 0xd6, 0x1e, 0xb7, 0xf6, 0x7c, 0xad,
+    0x3d, 0x6e, 0xed, 0xf9, 0x5a, 0x7b, 0xdc, 0xda, 0xf3, 0xb5, 0xf6, 0xf8, 0xf9, 0xc9, 0xce, 0xd7,
+    0xd6, 0xe3, 0xb6, 0xce, 0xd7, 0xd6, 0xfd, 0xb6, 0xce, 0xd7, 0xd6, 0xfd, 0xb6, 0xce, 0xd7, 0xd6,
+    0xfd, 0xb6, 0xce, 0xd7, 0xd6, 0xfd, 0xb6, 0xce, 0xd7, 0xd6, 0xfd, 0xb6, 0xce, 0xd7, 0xd6, 0xfd,
+    0xb6, 0xce, 0xd7, 0xd6, 0xfd, 0xb6, 0xce, 0xd7, 0xd6, 0xfd, 0xb6, 0xce, 0xd7, 0xd6, 0xfd, 0x67,
+    0xeb, 0x7a, 0x6d, 0xdd, 0x6f, 0xeb, 0x7a, 0x6d, 0xdd, 0x6e, 0xeb, 0x7a, 0x6d, 0xdd, 0x6e, 0xeb,
+    0x7a, 0x6d, 0xdd, 0x6e, 0xeb, 0x7a, 0x6d, 0xdd, 0x6e, 0xeb, 0x7a, 0x6d, 0xdd, 0x6e, 0xeb, 0x7a,
+    0x6d, 0xdd, 0x6e, 0xeb, 0x7a, 0x6d, 0xdd, 0x6e, 0xeb, 0x7a, 0x6d, 0xdd, 0x6e, 0xeb, 0x7a, 0x6d,
+    0xdd, 0x7e, 0xb6, 0x5e, 0xaf, 0xad, 0xdb, 0x6d, 0xbd, 0x5e, 0x5b, 0xc7, 0x6d, 0xbd, 0x5e, 0x5b,
+    0xc7, 0x6d, 0xbd, 0x5e, 0x5b, 0xc7, 0x6d, 0xbd, 0x5e, 0x5b, 0xc7, 0x6d, 0xbd, 0x5e, 0x5b, 0xc7,
+    0x6d, 0xbd, 0x5e, 0x5b, 0xc7, 0x6d, 0xbd, 0x5e, 0x5b, 0xc7, 0x6d, 0xbd, 0x5e, 0x5b, 0xc7, 0x6d,
+    0xbd, 0x5e, 0x5b, 0xc7, 0xcf, 0xd6, 0xfb, 0x9d, 0x53, 0xfe, 0xfe, 0x37, 0xf6, 0xb3, 0xa6, 0xdc,
+    0xfb, 0xe7, 0x1f, 0xd8, 0xf7, 0xfe, 0xf9, 0x37, 0xd7, 0xbd, 0x7f, 0x7e, 0x0c, 0xbf, 0xf7, 0xcf,
+    0x4f, 0x66, 0xf7, 0xfe, 0xf9, 0x5f, 0xf5, 0xbd, 0x7f, 0xfe, 0xf6, 0xbe, 0xf7, 0xcf, 0x1f, 0xe8,
+    0x7b, 0xff, 0xdc, 0xf8, 0xe7, 0x43, 0x59, 0xb0, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a,
+    0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9b, 0x59,
+    0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8,
+    0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9b, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99,
+    0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85,
+    0x9b, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a,
+    0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9b, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59,
+    0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8, 0x99, 0x85, 0x9a, 0x59, 0xa8,
+    0x99, 0xc5, 0x27, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a,
+    0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xe1, 0x66, 0x16, 0x6a, 0x66,
+    0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1,
+    0x66, 0x16, 0x6a, 0x66, 0xe1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66,
+    0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xe1, 0x66, 0x16,
+    0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xa1, 0x66, 0x16, 0x6a,
+    0x66, 0xa1, 0x66, 0x16, 0x6a, 0x66, 0xe1, 0x66, 0x16, 0x6a, 0x66, 0x81, 0x66, 0x16, 0x68, 0x66,
+    0x81, 0x66, 0x16, 0x68, 0x66, 0x81, 0x66, 0x16, 0x68, 0x66, 0x81, 0x66, 0x16, 0x68, 0x66, 0xf1,
+    0x81, 0x99, 0x35, 0x36, 0xb3, 0xa6, 0x66, 0xd6, 0xd4, 0xcc, 0x9a, 0x9a, 0x59, 0x53, 0x33, 0x6b,
+    0x6a, 0x66, 0x4d, 0xcd, 0xac, 0xa9, 0x99, 0x35, 0x35, 0xb3, 0xe6, 0x66, 0xd6, 0xd4, 0xcc, 0x9a,
+    0x9a, 0x59, 0x53, 0x33, 0x6b, 0x6a, 0x66, 0x4d, 0xcd, 0xac, 0xa9, 0x99, 0x35, 0x35, 0xb3, 0xa6,
+    0x66, 0xd6, 0xd4, 0xcc, 0x9a, 0x9b, 0x59, 0x53, 0x33, 0x6b, 0x6a, 0x66, 0x4d, 0xcd, 0xac, 0xa9,
+    0x99, 0x35, 0x35, 0xb3, 0xa6, 0x66, 0xd6, 0xd4, 0xcc, 0x9a, 0x9a, 0x59, 0x53, 0x33, 0x6b, 0x6e,
+    0x66, 0x4d, 0xcd, 0xac, 0xa9, 0x99, 0x35, 0x35, 0xb3, 0xa6, 0x66, 0xd6, 0xd4, 0xcc, 0x9a, 0x9a,
+    0x59, 0x53, 0x33, 0x6b, 0x6a, 0x66, 0x4d, 0xcd, 0xac, 0xb9, 0x99, 0x35, 0x35, 0xb3, 0xa6, 0x66,
+    0xd6, 0xd4, 0xcc, 0x9a, 0x9a, 0x59, 0x53, 0x33, 0x6b, 0x6a, 0x66, 0x4d, 0xcd, 0xac, 0xa9, 0x99,
+    0x35, 0x35, 0xb3, 0xf6, 0x89, 0x99, 0x35, 0x35, 0xb3, 0xa6, 0x66, 0xd6, 0xd4, 0xcc, 0x9a, 0x9a,
+    0x59, 0x53, 0x33, 0x6b, 0x6a, 0x66, 0x4d, 0xcd, 0xac, 0xa9, 0x99, 0x35, 0x35, 0xb3, 0xe6, 0x66,
+    0xd6, 0xd4, 0xcc, 0x9a, 0x9a, 0x59, 0x53, 0x33, 0x6b, 0x6a, 0x66, 0x4d, 0xcd, 0xac, 0xa9, 0x99,
+    0x35, 0x35, 0xb3, 0xa6, 0x66, 0xd6, 0xd4, 0xcc, 0x9a, 0x9b, 0x59, 0x53, 0x33, 0x6b, 0x6a, 0x66,
+    0x4d, 0xcd, 0xac, 0xa9, 0x99, 0x35, 0x35, 0xb3, 0xa6, 0x66, 0xd6, 0xd4, 0xcc, 0x9a, 0x9a, 0x59,
+    0x53, 0x33, 0x6b, 0x6e, 0x66, 0x4d, 0xcd, 0xac, 0xa9, 0x99, 0x35, 0x35, 0xb3, 0xa6, 0x66, 0xd6,
+    0xd4, 0xcc, 0x9a, 0x9a, 0x59, 0x53, 0x33, 0x6b, 0x6a, 0x66, 0x4d, 0xcd, 0xac, 0xb9, 0x99, 0x35,
+    0x35, 0xb3, 0x86, 0x66, 0xd6, 0xd0, 0xcc, 0x1a, 0x9a, 0x59, 0x43, 0x33, 0x6b, 0x68, 0x66, 0x0d,
+    0xcd, 0xac, 0xa1, 0x99, 0x35, 0x34, 0xb3, 0xf6, 0x81, 0x99, 0x75, 0x36, 0xb3, 0xae, 0x66, 0xd6,
+    0xd5, 0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33, 0xeb, 0x6a, 0x66, 0x5d, 0xcd, 0xac, 0xab, 0x99, 0x75,
+    0x35, 0xb3, 0xee, 0x66, 0xd6, 0xd5, 0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33, 0xeb, 0x6a, 0x66, 0x5d,
+    0xcd, 0xac, 0xab, 0x99, 0x75, 0x35, 0xb3, 0xae, 0x66, 0xd6, 0xd5, 0xcc, 0xba, 0x9b, 0x59, 0x57,
+    0x33, 0xeb, 0x6a, 0x66, 0x5d, 0xcd, 0xac, 0xab, 0x99, 0x75, 0x35, 0xb3, 0xae, 0x66, 0xd6, 0xd5,
+    0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33, 0xeb, 0x6e, 0x66, 0x5d, 0xcd, 0xac, 0xab, 0x99, 0x75, 0x35,
+    0xb3, 0xae, 0x66, 0xd6, 0xd5, 0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33, 0xeb, 0x6a, 0x66, 0x5d, 0xcd,
+    0xac, 0xbb, 0x99, 0x75, 0x35, 0xb3, 0xae, 0x66, 0xd6, 0xd5, 0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33,
+    0xeb, 0x6a, 0x66, 0x5d, 0xcd, 0xac, 0xab, 0x99, 0x75, 0x35, 0xb3, 0xfe, 0x89, 0x99, 0x75, 0x35,
+    0xb3, 0xae, 0x66, 0xd6, 0xd5, 0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33, 0xeb, 0x6a, 0x66, 0x5d, 0xcd,
+    0xac, 0xab, 0x99, 0x75, 0x35, 0xb3, 0xee, 0x66, 0xd6, 0xd5, 0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33,
+    0xeb, 0x6a, 0x66, 0x5d, 0xcd, 0xac, 0xab, 0x99, 0x75, 0x35, 0xb3, 0xae, 0x66, 0xd6, 0xd5, 0xcc,
+    0xba, 0x9b, 0x59, 0x57, 0x33, 0xeb, 0x6a, 0x66, 0x5d, 0xcd, 0xac, 0xab, 0x99, 0x75, 0x35, 0xb3,
+    0xae, 0x66, 0xd6, 0xd5, 0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33, 0xeb, 0x6e, 0x66, 0x5d, 0xcd, 0xac,
+    0xab, 0x99, 0x75, 0x35, 0xb3, 0xae, 0x66, 0xd6, 0xd5, 0xcc, 0xba, 0x9a, 0x59, 0x57, 0x33, 0xeb,
+    0x6a, 0x66, 0x5d, 0xcd, 0xac, 0xbb, 0x99, 0x75, 0x35, 0xb3, 0x8e, 0x66, 0xd6, 0xd1, 0xcc, 0x3a,
+    0x9a, 0x59, 0x47, 0x33, 0xeb, 0x68, 0x66, 0x1d, 0xcd, 0xac, 0xa3, 0x99, 0x75, 0x34, 0xb3, 0xfe,
+    0x81, 0x99, 0x0d, 0x36, 0xb3, 0xa1, 0x66, 0x36, 0xd4, 0xcc, 0x86, 0x9a, 0xd9, 0x50, 0x33, 0x1b,
+    0x6a, 0x66, 0x43, 0xcd, 0x6c, 0xa8, 0x99, 0x0d, 0x35, 0xb3, 0xe1, 0x66, 0x36, 0xd4, 0xcc, 0x86,
+    0x9a, 0xd9, 0x50, 0x33, 0x1b, 0x6a, 0x66, 0x43, 0xcd, 0x6c, 0xa8, 0x99, 0x0d, 0x35, 0xb3, 0xa1,
+    0x66, 0x36, 0xd4, 0xcc, 0x86, 0x9b, 0xd9, 0x50, 0x33, 0x1b, 0x6a, 0x66, 0x43, 0xcd, 0x6c, 0xa8,
+    0x99, 0x0d, 0x35, 0xb3, 0xa1, 0x66, 0x36, 0xd4, 0xcc, 0x86, 0x9a, 0xd9, 0x50, 0x33, 0x1b, 0x6e,
+    0x66, 0x43, 0xcd, 0x6c, 0xa8, 0x99, 0x0d, 0x35, 0xb3, 0xa1, 0x66, 0x36, 0xd4, 0xcc, 0x86, 0x9a,
+    0xd9, 0x50, 0x33, 0x1b, 0x6a, 0x66, 0x43, 0xcd, 0x6c, 0xb8, 0x99, 0x0d, 0x35, 0xb3, 0xa1, 0x66,
+    0x36, 0xd4, 0xcc, 0x86, 0x9a, 0xd9, 0x50, 0x33, 0x1b, 0x6a, 0x66, 0x43, 0xcd, 0x6c, 0xa8, 0x99,
+    0x0d, 0x35, 0xb3, 0xf1, 0x89, 0x99, 0x0d, 0x35, 0xb3, 0xa1, 0x66, 0x36, 0xd4, 0xcc, 0x86, 0x9a,
+    0xd9, 0x50, 0x33, 0x1b, 0x6a, 0x66, 0x43, 0xcd, 0x6c, 0xa8, 0x99, 0x0d, 0x35, 0xb3, 0xe1, 0x66,
+    0x36, 0xd4, 0xcc, 0x86, 0x9a, 0xd9, 0x50, 0x33, 0x1b, 0x6a, 0x66, 0x43, 0xcd, 0x6c, 0xa8, 0x99,
+    0x0d, 0x35, 0xb3, 0xa1, 0x66, 0x36, 0xd4, 0xcc, 0x86, 0x9b, 0xd9, 0x50, 0x33, 0x1b, 0x6a, 0x66,
+    0x43, 0xcd, 0x6c, 0xa8, 0x99, 0x0d, 0x35, 0xb3, 0xa1, 0x66, 0x36, 0xd4, 0xcc, 0x86, 0x9a, 0xd9,
+    0x50, 0x33, 0x1b, 0x6e, 0x66, 0x43, 0xcd, 0x6c, 0xa8, 0x99, 0x0d, 0x35, 0xb3, 0xa1, 0x66, 0x36,
+    0xd4, 0xcc, 0x86, 0x9a, 0xd9, 0x50, 0x33, 0x1b, 0x6a, 0x66, 0x43, 0xcd, 0x6c, 0xb8, 0x99, 0x0d,
+    0x35, 0xb3, 0x81, 0x66, 0x36, 0xd0, 0xcc, 0x06, 0x9a, 0xd9, 0x40, 0x33, 0x1b, 0x68, 0x66, 0x03,
+    0xcd, 0x6c, 0xa0, 0x99, 0x0d, 0x34, 0xb3, 0xf1, 0x81, 0x99, 0x4d, 0x36, 0xb3, 0xa9, 0x66, 0x36,
+    0xd5, 0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33, 0x9b, 0x6a, 0x66, 0x53, 0xcd, 0x6c, 0xaa, 0x99, 0x4d,
+    0x35, 0xb3, 0xe9, 0x66, 0x36, 0xd5, 0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33, 0x9b, 0x6a, 0x66, 0x53,
+    0xcd, 0x6c, 0xaa, 0x99, 0x4d, 0x35, 0xb3, 0xa9, 0x66, 0x36, 0xd5, 0xcc, 0xa6, 0x9b, 0xd9, 0x54,
+    0x33, 0x9b, 0x6a, 0x66, 0x53, 0xcd, 0x6c, 0xaa, 0x99, 0x4d, 0x35, 0xb3, 0xa9, 0x66, 0x36, 0xd5,
+    0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33, 0x9b, 0x6e, 0x66, 0x53, 0xcd, 0x6c, 0xaa, 0x99, 0x4d, 0x35,
+    0xb3, 0xa9, 0x66, 0x36, 0xd5, 0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33, 0x9b, 0x6a, 0x66, 0x53, 0xcd,
+    0x6c, 0xba, 0x99, 0x4d, 0x35, 0xb3, 0xa9, 0x66, 0x36, 0xd5, 0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33,
+    0x9b, 0x6a, 0x66, 0x53, 0xcd, 0x6c, 0xaa, 0x99, 0x4d, 0x35, 0xb3, 0xf9, 0x89, 0x99, 0x4d, 0x35,
+    0xb3, 0xa9, 0x66, 0x36, 0xd5, 0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33, 0x9b, 0x6a, 0x66, 0x53, 0xcd,
+    0x6c, 0xaa, 0x99, 0x4d, 0x35, 0xb3, 0xe9, 0x66, 0x36, 0xd5, 0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33,
+    0x9b, 0x6a, 0x66, 0x53, 0xcd, 0x6c, 0xaa, 0x99, 0x4d, 0x35, 0xb3, 0xa9, 0x66, 0x36, 0xd5, 0xcc,
+    0xa6, 0x9b, 0xd9, 0x54, 0x33, 0x9b, 0x6a, 0x66, 0x53, 0xcd, 0x6c, 0xaa, 0x99, 0x4d, 0x35, 0xb3,
+    0xa9, 0x66, 0x36, 0xd5, 0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33, 0x9b, 0x6e, 0x66, 0x53, 0xcd, 0x6c,
+    0xaa, 0x99, 0x4d, 0x35, 0xb3, 0xa9, 0x66, 0x36, 0xd5, 0xcc, 0xa6, 0x9a, 0xd9, 0x54, 0x33, 0x9b,
+    0x6a, 0x66, 0x53, 0xcd, 0x6c, 0xba, 0x99, 0x4d, 0x35, 0xb3, 0x89, 0x66, 0x36, 0xd1, 0xcc, 0x26,
+    0x9a, 0xd9, 0x44, 0x33, 0x9b, 0x68, 0x66, 0x13, 0xcd, 0x6c, 0xa2, 0x99, 0x4d, 0x34, 0xb3, 0xf9,
+    0x81, 0x99, 0x25, 0x9b, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa,
+    0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xba, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99,
+    0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5,
+    0x9a, 0x59, 0xba, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a,
+    0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xba, 0x99, 0xa5, 0x9a, 0x59,
+    0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa,
+    0x99, 0xa5, 0x9a, 0x59, 0xba, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99,
+    0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0xaa, 0x99, 0xa5, 0x9a, 0x59, 0x7e, 0x62, 0x66,
+    0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9,
+    0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6e, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66,
+    0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96,
+    0x6e, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6a,
+    0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6e, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66,
+    0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9, 0x66, 0x96, 0x6a, 0x66, 0xa9,
+    0x66, 0x96, 0x6e, 0x66, 0xa9, 0x66, 0x96, 0x68, 0x66, 0x89, 0x66, 0x96, 0x68, 0x66, 0x89, 0x66,
+    0x96, 0x68, 0x66, 0x89, 0x66, 0x96, 0x68, 0x66, 0x89, 0x66, 0x96, 0x1f, 0x98, 0x59, 0xb1, 0x99,
+    0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95,
+    0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9b, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a,
+    0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9b, 0x59,
+    0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9,
+    0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9b, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99,
+    0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95,
+    0x9b, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0x95, 0x9a,
+    0x59, 0xa9, 0x99, 0x95, 0x9a, 0x59, 0xa9, 0x99, 0xd5, 0x27, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66,
+    0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56,
+    0x6a, 0x66, 0xe5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a,
+    0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xe5, 0x66, 0x56, 0x6a, 0x66,
+    0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5,
+    0x66, 0x56, 0x6a, 0x66, 0xe5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66,
+    0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xa5, 0x66, 0x56, 0x6a, 0x66, 0xe5, 0x66, 0x56,
+    0x6a, 0x66, 0x85, 0x66, 0x56, 0x68, 0x66, 0x85, 0x66, 0x56, 0x68, 0x66, 0x85, 0x66, 0x56, 0x68,
+    0x66, 0x85, 0x66, 0x56, 0x68, 0x66, 0xf5, 0x81, 0x99, 0x2d, 0x36, 0xb3, 0xa5, 0x66, 0xb6, 0xd4,
+    0xcc, 0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b, 0x6a, 0x66, 0x4b, 0xcd, 0x6c, 0xa9, 0x99, 0x2d, 0x35,
+    0xb3, 0xe5, 0x66, 0xb6, 0xd4, 0xcc, 0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b, 0x6a, 0x66, 0x4b, 0xcd,
+    0x6c, 0xa9, 0x99, 0x2d, 0x35, 0xb3, 0xa5, 0x66, 0xb6, 0xd4, 0xcc, 0x96, 0x9b, 0xd9, 0x52, 0x33,
+    0x5b, 0x6a, 0x66, 0x4b, 0xcd, 0x6c, 0xa9, 0x99, 0x2d, 0x35, 0xb3, 0xa5, 0x66, 0xb6, 0xd4, 0xcc,
+    0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b, 0x6e, 0x66, 0x4b, 0xcd, 0x6c, 0xa9, 0x99, 0x2d, 0x35, 0xb3,
+    0xa5, 0x66, 0xb6, 0xd4, 0xcc, 0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b, 0x6a, 0x66, 0x4b, 0xcd, 0x6c,
+    0xb9, 0x99, 0x2d, 0x35, 0xb3, 0xa5, 0x66, 0xb6, 0xd4, 0xcc, 0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b,
+    0x6a, 0x66, 0x4b, 0xcd, 0x6c, 0xa9, 0x99, 0x2d, 0x35, 0xb3, 0xf5, 0x89, 0x99, 0x2d, 0x35, 0xb3,
+    0xa5, 0x66, 0xb6, 0xd4, 0xcc, 0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b, 0x6a, 0x66, 0x4b, 0xcd, 0x6c,
+    0xa9, 0x99, 0x2d, 0x35, 0xb3, 0xe5, 0x66, 0xb6, 0xd4, 0xcc, 0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b,
+    0x6a, 0x66, 0x4b, 0xcd, 0x6c, 0xa9, 0x99, 0x2d, 0x35, 0xb3, 0xa5, 0x66, 0xb6, 0xd4, 0xcc, 0x96,
+    0x9b, 0xd9, 0x52, 0x33, 0x5b, 0x6a, 0x66, 0x4b, 0xcd, 0x6c, 0xa9, 0x99, 0x2d, 0x35, 0xb3, 0xa5,
+    0x66, 0xb6, 0xd4, 0xcc, 0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b, 0x6e, 0x66, 0x4b, 0xcd, 0x6c, 0xa9,
+    0x99, 0x2d, 0x35, 0xb3, 0xa5, 0x66, 0xb6, 0xd4, 0xcc, 0x96, 0x9a, 0xd9, 0x52, 0x33, 0x5b, 0x6a,
+    0x66, 0x4b, 0xcd, 0x6c, 0xb9, 0x99, 0x2d, 0x35, 0xb3, 0x85, 0x66, 0xb6, 0xd0, 0xcc, 0x16, 0x9a,
+    0xd9, 0x42, 0x33, 0x5b, 0x68, 0x66, 0x0b, 0xcd, 0x6c, 0xa1, 0x99, 0x2d, 0x34, 0xb3, 0xf5, 0x81,
+    0x99, 0x6d, 0x36, 0xb3, 0xad, 0x66, 0xb6, 0xd5, 0xcc, 0xb6, 0x9a, 0xd9, 0x56, 0x33, 0xdb, 0x6a,
+    0x66, 0x5b, 0xcd, 0x6c, 0xab, 0x99, 0x6d, 0x35, 0xb3, 0xed, 0x66, 0xb6, 0xd5, 0xcc, 0xb6, 0x9a,
+    0xd9, 0x56, 0x33, 0xdb, 0x6a, 0x66, 0x5b, 0xcd, 0x6c, 0xab, 0x99, 0x6d, 0x35, 0xb3, 0xad, 0x66,
+    0xb6, 0xd5, 0xcc, 0xb6, 0x9b, 0xd9, 0x56, 0x33, 0xdb, 0x6a, 0x66, 0x5b, 0xcd, 0x6c, 0xab, 0x99,
+    0x6d, 0x35, 0xb3, 0xad, 0x66, 0xb6, 0xd5, 0xcc, 0xb6, 0x9a, 0xd9, 0x56, 0x33, 0xdb, 0x6e, 0x66,
+    0x5b, 0xcd, 0x6c, 0xab, 0x99, 0x6d, 0x35, 0xb3, 0xad, 0x66, 0xb6, 0xd5, 0xcc, 0xb6, 0x9a, 0xd9,
+    0x56, 0x33, 0xdb, 0x6a, 0x66, 0x5b, 0xcd, 0x6c, 0xbb, 0x99, 0x6d, 0x35, 0xb3, 0xad, 0x66, 0xb6,
+    0xd5, 0xcc, 0xb6, 0x9a, 0xd9, 0x56, 0x33, 0xdb, 0x6a, 0x66, 0x5b, 0xcd, 0x6c, 0xab, 0x99, 0x6d,
+    0x35, 0xb3, 0xfd, 0x89, 0x99, 0x6d, 0x35, 0xb3, 0xad, 0x66, 0xb6, 0xd5, 0xcc, 0xb6, 0x9a, 0xd9,
+    0x56, 0x33, 0xdb, 0x6a, 0x66, 0x5b, 0xcd, 0x6c, 0xab, 0x99, 0x6d, 0x35, 0xb3, 0xed, 0x66, 0xb6,
+    0xd5, 0xcc, 0xb6, 0x9a, 0xd9, 0x56, 0x33, 0xdb, 0x6a, 0x66, 0x5b, 0xcd, 0x6c, 0xab, 0x99, 0x6d,
+    0x35, 0xb3, 0xad, 0x66, 0xb6, 0xd5, 0xcc, 0xb6, 0x9b, 0xd9, 0x56, 0x33, 0xdb, 0x6a, 0x66, 0x5b,
+    0xcd, 0x6c, 0xab, 0x99, 0x6d, 0x35, 0xb3, 0xad, 0x66, 0xb6, 0xd5, 0xcc, 0xb6, 0x9a, 0xd9, 0x56,
+    0x33, 0xdb, 0x6e, 0x66, 0x5b, 0xcd, 0x6c, 0xab, 0x99, 0x6d, 0x35, 0xb3, 0xad, 0x66, 0xb6, 0xd5,
+    0xcc, 0xb6, 0x9a, 0xd9, 0x56, 0x33, 0xdb, 0x6a, 0x66, 0x5b, 0xcd, 0x6c, 0xbb, 0x99, 0x6d, 0x35,
+    0xb3, 0x8d, 0x66, 0xb6, 0xd1, 0xcc, 0x36, 0x9a, 0xd9, 0x46, 0x33, 0xdb, 0x68, 0x66, 0x1b, 0xcd,
+    0x6c, 0xa3, 0x99, 0x6d, 0x34, 0xb3, 0xed, 0x66, 0x16, 0xdf, 0x6a, 0x66, 0xe7, 0xcd, 0xcc, 0xec,
+    0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc,
+    0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0x40, 0xcd, 0x2c, 0xbe, 0xd1, 0xcc, 0xce,
+    0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc,
+    0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0x40, 0xcd, 0x2c, 0xbe,
+    0xd1, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc,
+    0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0x40,
+    0xcd, 0x2c, 0xbe, 0xd1, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec,
+    0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc,
+    0xcc, 0xce, 0x40, 0xcd, 0x2c, 0xbe, 0xd1, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce,
+    0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc,
+    0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcd, 0x2c, 0xbe, 0xd1, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c,
+    0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc,
+    0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0x40, 0xcd, 0x2c, 0xbe, 0xd1, 0xcc, 0xce, 0xc0,
+    0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec,
+    0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0x40, 0xcd, 0x2c, 0xbe, 0xd1,
+    0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce,
+    0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0x40, 0xcd,
+    0x2c, 0xbe, 0xd1, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c,
+    0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc, 0xce, 0xc0, 0xcc, 0xec, 0x0c, 0xcc, 0xcc,
+    0xce, 0x40, 0xcd, 0x2c, 0xbe, 0xd1, 0xcc, 0xce, 0x80, 0xcc, 0xec, 0xdc, 0x93, 0x99, 0x9d, 0x7b,
+    0x32, 0xb3, 0x73, 0x4f, 0x66, 0x76, 0xee, 0xc9, 0xcc, 0xce, 0x3d, 0x99, 0xd9, 0xb9, 0x27, 0x33,
+    0x3b, 0xf7, 0x64, 0x66, 0xe7, 0xde, 0xcd, 0x2c, 0xd8, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42,
+    0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0xc2, 0xcd,
+    0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c,
+    0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0xc2, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4,
+    0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc,
+    0xc2, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42,
+    0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0xc2, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd,
+    0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c, 0xd4, 0xcc, 0x42, 0xcd, 0x2c,
+    0xd4, 0xcc, 0xe2, 0x13, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b,
+    0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x70, 0x33, 0x0b, 0x35,
+    0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3,
+    0x50, 0x33, 0x0b, 0x35, 0xb3, 0x70, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x50,
+    0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x70, 0x33,
+    0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x50, 0x33, 0x0b,
+    0x35, 0xb3, 0x50, 0x33, 0x0b, 0x35, 0xb3, 0x70, 0x33, 0x0b, 0x35, 0xb3, 0x40, 0x33, 0x0b, 0x34,
+    0xb3, 0x40, 0x33, 0x0b, 0x34, 0xb3, 0x40, 0x33, 0x0b, 0x34, 0xb3, 0x40, 0x33, 0x0b, 0x34, 0xb3,
+    0x60, 0x33, 0xfb, 0x7f, 0x62, 0xc7, 0xbc, 0x06, 0x47, 0x6f, 0x6f, 0x64, 0x62, 0x79, 0x65, 0x0d,
+    0x0a,
+};
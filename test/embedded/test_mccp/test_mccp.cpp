@@ -0,0 +1,130 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "ZInflate.h"
+#include "ZTelnet.h"
+#include "fixture.h"
+
+// MCCP2 receive path against a recorded zlib stream: ZTelnet finds the
+// COMPRESS2 start, ZInflate expands the rest and ZTelnet strips the
+// commands from what comes out, exactly as ZModem::receiveClean() does.
+
+static uint8_t *expected;
+static size_t expectedLen;
+static size_t checked;
+static bool mismatch;
+
+// rebuilds what the DTE should see, see tools/mccp_fixture.py
+static void buildExpected()
+{
+    const char *greeting = "Welcome to the fixture MUD\r\n";
+    expected = (uint8_t *)malloc(64 * 1024);
+    expectedLen = strlen(greeting);
+    memcpy(expected, greeting, expectedLen);
+    for (int i = 0; i < MCCP_FIXTURE_LINES; i++)
+    {
+        expectedLen += sprintf((char *)expected + expectedLen, "%05d The orc swings at you and misses. [HP %d]\r\n", i, 100 - i % 100);
+        if (i % 50 == 49)
+        {
+            expected[expectedLen++] = TELNET_IAC;
+        }
+    }
+    memcpy(expected + expectedLen, "Goodbye\r\n", 9);
+    expectedLen += 9;
+}
+
+static void check(const uint8_t *data, size_t len)
+{
+    if (checked + len > expectedLen || memcmp(expected + checked, data, len) != 0)
+    {
+        mismatch = true;
+    }
+    checked += len;
+}
+
+void setUp()
+{
+    checked = 0;
+    mismatch = false;
+}
+
+void tearDown()
+{
+}
+
+// inSlice: fixture bytes offered per step, outSlice: inflated bytes read per step
+static void replay(size_t inSlice, size_t outSlice)
+{
+    ZTelnet telnet;
+    ZInflate inflate;
+    uint8_t buf[ZINFLATE_IN_SIZE];
+    size_t pos = 0;
+    size_t compressed = 0;
+    bool compressing = false;
+
+    telnet.setCompression(true);
+    while (pos < sizeof(MCCP_FIXTURE) || (compressing && (inflate.pendingInput() > 0 || inflate.pendingOutput() > 0)))
+    {
+        size_t len = sizeof(MCCP_FIXTURE) - pos < inSlice ? sizeof(MCCP_FIXTURE) - pos : inSlice;
+        if (!compressing)
+        {
+            memcpy(buf, MCCP_FIXTURE + pos, len);
+            pos += len;
+            size_t used = len;
+            check(buf, telnet.receive(buf, len, &used));
+            if (telnet.compressionStarted())
+            {
+                TEST_ASSERT_TRUE(inflate.begin());
+                compressing = true;
+                compressed += inflate.feed(buf + used, len - used);
+            }
+            continue;
+        }
+        size_t taken = inflate.feed(MCCP_FIXTURE + pos, len);
+        pos += taken;
+        compressed += taken;
+        size_t n = inflate.read(buf, outSlice);
+        TEST_ASSERT_FALSE(inflate.failed());
+        check(buf, telnet.receive(buf, n));
+        if (taken == 0 && n == 0)
+        {
+            break;
+        }
+    }
+    TEST_ASSERT_TRUE(compressing);
+    TEST_ASSERT_TRUE(inflate.finished());
+    TEST_ASSERT_FALSE(mismatch);
+    TEST_ASSERT_EQUAL(expectedLen, checked);
+    // the window is 32k, the stream inflates to more than that
+    TEST_ASSERT_GREATER_THAN(TINFL_LZ_DICT_SIZE, expectedLen);
+    TEST_ASSERT_GREATER_THAN(compressed * 5, expectedLen);
+}
+
+void test_whole_buffers()
+{
+    replay(ZINFLATE_IN_SIZE, ZINFLATE_IN_SIZE);
+}
+
+void test_small_slices()
+{
+    replay(7, 13);
+}
+
+void test_single_bytes()
+{
+    replay(1, 1);
+}
+
+void setup()
+{
+    delay(2000);
+    buildExpected();
+    UNITY_BEGIN();
+    RUN_TEST(test_whole_buffers);
+    RUN_TEST(test_small_slices);
+    RUN_TEST(test_single_bytes);
+    UNITY_END();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,161 @@
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include "ZCommand.h"
+
+static ZCommandParser parser;
+
+void setUp()
+{
+    parser = ZCommandParser();
+}
+
+void tearDown()
+{
+}
+
+// one sub-command per entry, as name[=arg][#value][/modifiers]; a + command
+// carries its own key as the argument, so only the name is shown
+static std::string split(const char *line)
+{
+    if (!parser.begin(line, strlen(line)))
+    {
+        return "-";
+    }
+    std::string out;
+    ZCommand c;
+    while (parser.next(c))
+    {
+        if (!out.empty())
+        {
+            out += ' ';
+        }
+        out += c.name;
+        if (c.cmd != '+' && c.vlen > 0)
+        {
+            out += '=';
+            out.append((const char *)c.vbuf, c.vlen);
+        }
+        if (c.cmd != '+' && c.isNumber && c.vlen > 0)
+        {
+            out += '#' + std::to_string(c.vval);
+        }
+        if (c.dmodifiers != nullptr && *c.dmodifiers)
+        {
+            out += '/';
+            out += c.dmodifiers;
+        }
+    }
+    return out;
+}
+
+struct Case
+{
+    const char *line;
+    const char *want;
+};
+
+static void check(const Case *cases, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(cases[i].want, split(cases[i].line).c_str(), cases[i].line);
+    }
+}
+
+void test_basic_commands()
+{
+    static const Case cases[] = {
+        {"ATZ", "z"},
+        {"at", ""},
+        {"ATE0V1", "e=0#0 v=1#1"},
+        {"ATH0 Z", "h=0#0 z"},
+        {"AT I 4", "i=4#4"},
+        {"hello", "-"},
+    };
+    check(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+void test_ampersand_and_percent()
+{
+    static const Case cases[] = {
+        {"AT&F", "&f"},
+        {"AT&V&W", "&v &w"},
+        {"AT%C1", "%c=1#1"},
+        {"AT&K3%C0", "&k=3#3 %c=0#0"},
+    };
+    check(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+void test_dial_modifiers()
+{
+    static const Case cases[] = {
+        {"ATD5551212", "d=5551212#5551212"},
+        {"ATDT bbs.example.org:23", "d=bbs.example.org:23/t"},
+        {"ATDPS,bbs:23", "d=bbs:23/ps,"},
+        {"ATDT\"bbs.example.org:6400\"", "d=bbs.example.org:6400/t"},
+    };
+    check(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+void test_quoted_args()
+{
+    static const Case cases[] = {
+        {"ATD\"host with space\"", "d=host with space"},
+        {"ATD\"a\\\"b\"", "d=a\\\"b"},
+        // a quoted argument is taken as text even when it is all digits
+        {"ATD\"12\"Z", "d=12 z"},
+    };
+    check(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+void test_dollar_settings()
+{
+    static const Case cases[] = {
+        {"AT$SSID=My Net", "$ssid=My Net"},
+        {"AT$Pass = secret ", "$pass=secret"},
+        {"AT$x=", "$x"},
+        {"AT+MUX", "+mux"},
+    };
+    check(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+void test_trailing_blanks()
+{
+    static const Case cases[] = {
+        {"ATZ   ", "z"},
+        {"  ATI4  ", "i=4#4"},
+        {"AT&V \r\n", "&v"},
+    };
+    check(cases, sizeof(cases) / sizeof(cases[0]));
+}
+
+void test_repeat_last()
+{
+    TEST_ASSERT_EQUAL_STRING("-", split("A/").c_str());
+    TEST_ASSERT_EQUAL_STRING("d=123#123", split("ATD123").c_str());
+    TEST_ASSERT_EQUAL_STRING("d=123#123", split("A/").c_str());
+    TEST_ASSERT_EQUAL_STRING("d=123#123", split("a/").c_str());
+}
+
+void test_shifted_petscii()
+{
+    TEST_ASSERT_EQUAL('z', ZCommandParser::lc((char)218));
+    TEST_ASSERT_EQUAL('a', ZCommandParser::lc((char)193));
+    TEST_ASSERT_EQUAL((char)219, ZCommandParser::lc((char)219));
+    TEST_ASSERT_EQUAL_STRING("z", split("\xC1\xD4\xDA").c_str());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_basic_commands);
+    RUN_TEST(test_ampersand_and_percent);
+    RUN_TEST(test_dial_modifiers);
+    RUN_TEST(test_quoted_args);
+    RUN_TEST(test_dollar_settings);
+    RUN_TEST(test_trailing_blanks);
+    RUN_TEST(test_repeat_last);
+    RUN_TEST(test_shifted_petscii);
+    return UNITY_END();
+}
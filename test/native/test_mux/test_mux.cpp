@@ -0,0 +1,171 @@
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include "ZCrc16.h"
+#include "ZMux.h"
+
+static ZMux mux;
+
+void setUp()
+{
+    mux = ZMux();
+}
+
+void tearDown()
+{
+}
+
+static std::string frame(uint16_t channel, uint8_t type, const std::string &payload)
+{
+    uint8_t head[ZMUX_HEADER_SIZE];
+    uint8_t tail[ZMUX_TRAILER_SIZE];
+    ZMux::wrap(head, tail, channel, type, (const uint8_t *)payload.data(), payload.size());
+    return std::string((char *)head, sizeof(head)) + payload + std::string((char *)tail, sizeof(tail));
+}
+
+// feeds data in slices of step bytes, returns the payloads of the frames found
+static std::string receive(const std::string &data, size_t step, int *frames)
+{
+    std::string out;
+    *frames = 0;
+    size_t i = 0;
+    while (i < data.size())
+    {
+        size_t len = data.size() - i < step ? data.size() - i : step;
+        size_t used = 0;
+        if (mux.receive((const uint8_t *)data.data() + i, len, &used))
+        {
+            (*frames)++;
+            out.append((const char *)mux.current().payload, mux.current().length);
+        }
+        i += used;
+    }
+    return out;
+}
+
+void test_crc_check_values()
+{
+    const uint8_t check[] = "123456789";
+    // CRC-16/CCITT-FALSE and CRC-16/XMODEM
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, ZCrc16::update(0xFFFF, check, 9));
+    TEST_ASSERT_EQUAL_HEX16(0x31C3, ZCrc16::update(0, check, 9));
+}
+
+void test_wrap_layout()
+{
+    std::string f = frame(0x0102, ZMUX_DATA, "hi");
+    TEST_ASSERT_EQUAL(ZMUX_HEADER_SIZE + 2 + ZMUX_TRAILER_SIZE, f.size());
+    const uint8_t want[] = {ZMUX_SOF, 0x02, 0x01, ZMUX_DATA, 0x02, 0x00, 'h', 'i'};
+    TEST_ASSERT_EQUAL_MEMORY(want, f.data(), sizeof(want));
+    uint16_t crc = ZCrc16::update(0xFFFF, (const uint8_t *)f.data() + 1, f.size() - 3);
+    TEST_ASSERT_EQUAL_HEX8(crc & 0xFF, (uint8_t)f[f.size() - 2]);
+    TEST_ASSERT_EQUAL_HEX8(crc >> 8, (uint8_t)f[f.size() - 1]);
+}
+
+void test_round_trip()
+{
+    int frames;
+    std::string got = receive(frame(7, ZMUX_DATA, "hello"), 64, &frames);
+    TEST_ASSERT_EQUAL(1, frames);
+    TEST_ASSERT_EQUAL_STRING("hello", got.c_str());
+    TEST_ASSERT_EQUAL(7, mux.current().channel);
+    TEST_ASSERT_EQUAL(ZMUX_DATA, mux.current().type);
+    TEST_ASSERT_EQUAL(1, mux.statistics().framesIn);
+}
+
+void test_stops_after_one_frame()
+{
+    std::string two = frame(1, ZMUX_DATA, "one") + frame(2, ZMUX_DATA, "two");
+    size_t used = 0;
+    TEST_ASSERT_TRUE(mux.receive((const uint8_t *)two.data(), two.size(), &used));
+    TEST_ASSERT_EQUAL(two.size() / 2, used);
+    TEST_ASSERT_EQUAL(1, mux.current().channel);
+    TEST_ASSERT_TRUE(mux.receive((const uint8_t *)two.data() + used, two.size() - used, &used));
+    TEST_ASSERT_EQUAL(2, mux.current().channel);
+}
+
+void test_split_across_slices()
+{
+    std::string stream = frame(1, ZMUX_DATA, "abc") + frame(3, ZMUX_CREDIT, std::string("\x00\x10", 2)) + frame(1, ZMUX_CLOSE, "");
+    for (size_t step = 1; step <= 8; step++)
+    {
+        setUp();
+        int frames;
+        std::string got = receive(stream, step, &frames);
+        TEST_ASSERT_EQUAL(3, frames);
+        TEST_ASSERT_EQUAL(5, got.size());
+        TEST_ASSERT_EQUAL(ZMUX_CLOSE, mux.current().type);
+        TEST_ASSERT_EQUAL(0, mux.current().length);
+    }
+}
+
+void test_needed_follows_the_frame()
+{
+    std::string f = frame(1, ZMUX_DATA, "abcd");
+    TEST_ASSERT_EQUAL(1, mux.needed());
+    mux.receive((const uint8_t *)f.data(), 1, nullptr);
+    TEST_ASSERT_EQUAL(ZMUX_HEADER_SIZE - 1, mux.needed());
+    mux.receive((const uint8_t *)f.data() + 1, ZMUX_HEADER_SIZE - 1, nullptr);
+    TEST_ASSERT_EQUAL(4, mux.needed());
+    mux.receive((const uint8_t *)f.data() + ZMUX_HEADER_SIZE, 4, nullptr);
+    TEST_ASSERT_EQUAL(ZMUX_TRAILER_SIZE, mux.needed());
+}
+
+void test_garbage_before_sof()
+{
+    int frames;
+    std::string got = receive(std::string("\x01\x02noise") + frame(4, ZMUX_DATA, "x"), 3, &frames);
+    TEST_ASSERT_EQUAL(1, frames);
+    TEST_ASSERT_EQUAL_STRING("x", got.c_str());
+}
+
+void test_crc_error_drops_whole_frame()
+{
+    // the payload of the bad frame looks like a frame of its own; it must
+    // not be found, the hunt starts after the bad frame
+    std::string inner = frame(9, ZMUX_DATA, "fake");
+    std::string bad = frame(1, ZMUX_DATA, inner);
+    bad[bad.size() - 1] ^= 0x55;
+    int frames;
+    std::string got = receive(bad + frame(2, ZMUX_DATA, "good"), 5, &frames);
+    TEST_ASSERT_EQUAL(1, frames);
+    TEST_ASSERT_EQUAL_STRING("good", got.c_str());
+    TEST_ASSERT_EQUAL(2, mux.current().channel);
+    TEST_ASSERT_EQUAL(1, mux.statistics().crcErrors);
+}
+
+void test_oversize_dropped()
+{
+    const uint8_t huge[] = {ZMUX_SOF, 0x01, 0x00, ZMUX_DATA, 0xFF, 0xFF};
+    std::string stream((const char *)huge, sizeof(huge));
+    int frames;
+    std::string got = receive(stream + frame(1, ZMUX_DATA, "ok"), 64, &frames);
+    TEST_ASSERT_EQUAL(1, frames);
+    TEST_ASSERT_EQUAL_STRING("ok", got.c_str());
+    TEST_ASSERT_EQUAL(1, mux.statistics().oversize);
+}
+
+void test_max_payload()
+{
+    std::string big(ZMUX_MAX_PAYLOAD, 'z');
+    int frames;
+    std::string got = receive(frame(1, ZMUX_DATA, big), 100, &frames);
+    TEST_ASSERT_EQUAL(1, frames);
+    TEST_ASSERT_EQUAL(ZMUX_MAX_PAYLOAD, got.size());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_check_values);
+    RUN_TEST(test_wrap_layout);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_stops_after_one_frame);
+    RUN_TEST(test_split_across_slices);
+    RUN_TEST(test_needed_follows_the_frame);
+    RUN_TEST(test_garbage_before_sof);
+    RUN_TEST(test_crc_error_drops_whole_frame);
+    RUN_TEST(test_oversize_dropped);
+    RUN_TEST(test_max_payload);
+    return UNITY_END();
+}
@@ -0,0 +1,126 @@
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include "ZProfileStore.h"
+
+static ZProfileRecord rec;
+
+void setUp()
+{
+    memset(&rec, 0xA5, sizeof(rec));
+}
+
+void tearDown()
+{
+}
+
+static bool fromJson(const std::string &json)
+{
+    return ZProfileStore::fromJson(rec, json.data(), json.size());
+}
+
+// every register at its default except the ones a test changes
+static void checkRegisters(int index, int value, int index2 = -1, int value2 = 0)
+{
+    for (const ZRegister &r : ZREGISTERS)
+    {
+        int want = r.index == index ? value : r.index == index2 ? value2 : r.defaultValue;
+        TEST_ASSERT_EQUAL_MESSAGE(want, rec.regs[r.index], "register");
+    }
+}
+
+void test_crc_check_value()
+{
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, ZProfileStore::crc32(0, check, 9));
+}
+
+void test_image_seal_and_valid()
+{
+    ZProfileImage image;
+    ZProfileStore::clear(image);
+    TEST_ASSERT_EQUAL(-1, image.active);
+    TEST_ASSERT_FALSE(ZProfileStore::valid(image));
+    image.active = 1;
+    image.profiles[1].used = 1;
+    ZProfileStore::seal(image);
+    TEST_ASSERT_TRUE(ZProfileStore::valid(image));
+    ((uint8_t *)&image)[20] ^= 1;
+    TEST_ASSERT_FALSE(ZProfileStore::valid(image));
+}
+
+void test_dense_registers()
+{
+    // the whole register space as an array, as the oldest profiles stored it
+    std::string json = "{\"hostname\":\"zmodem\",\"baudRate\":115200,\"listenPort\":6400,\"regs\":[";
+    for (int i = 0; i < ZREGISTER_SPACE; i++)
+    {
+        int slot = zregisterSlot(i);
+        int value = i == 0 ? 2 : i == 50 ? 0x11 : slot < 0 ? 0 : ZREGISTERS[slot].defaultValue;
+        json += (i ? "," : "") + std::to_string(value);
+    }
+    json += "]}";
+    TEST_ASSERT_TRUE(fromJson(json));
+    TEST_ASSERT_EQUAL(1, rec.used);
+    TEST_ASSERT_EQUAL(115200, rec.baudRate);
+    TEST_ASSERT_EQUAL(6400, rec.listenPort);
+    TEST_ASSERT_EQUAL_STRING("zmodem", rec.hostname);
+    TEST_ASSERT_EQUAL_STRING("", rec.wifiSSID);
+    checkRegisters(0, 2, 50, 0x11);
+}
+
+void test_sparse_registers()
+{
+    TEST_ASSERT_TRUE(fromJson("{\"version\":\"1.0\",\"wifiSSID\":\"Net\",\"wifiPSWD\":\"secret\","
+                              "\"sregs\":{\"12\":100,\"53\":13}}"));
+    TEST_ASSERT_EQUAL_STRING("Net", rec.wifiSSID);
+    TEST_ASSERT_EQUAL_STRING("secret", rec.wifiPSWD);
+    checkRegisters(12, 100, 53, 13);
+}
+
+void test_bad_registers_keep_defaults()
+{
+    // read-only, unknown, out of range and outside the mask
+    TEST_ASSERT_TRUE(fromJson("{\"sregs\":{\"1\":5,\"13\":1,\"200\":1,\"54\":3,\"14\":1}}"));
+    checkRegisters(-1, 0);
+    TEST_ASSERT_EQUAL(0, rec.regs[13]);
+}
+
+void test_missing_fields_default()
+{
+    TEST_ASSERT_TRUE(fromJson("{}"));
+    TEST_ASSERT_EQUAL(1, rec.used);
+    TEST_ASSERT_EQUAL(DEFAULT_BAUD_RATE, rec.baudRate);
+    TEST_ASSERT_EQUAL(0, rec.listenPort);
+    TEST_ASSERT_EQUAL_STRING("", rec.hostname);
+    TEST_ASSERT_EQUAL_STRING("", rec.wifiPSWD);
+    checkRegisters(-1, 0);
+}
+
+void test_long_strings_truncated()
+{
+    std::string ssid(40, 's');
+    TEST_ASSERT_TRUE(fromJson("{\"wifiSSID\":\"" + ssid + "\"}"));
+    TEST_ASSERT_EQUAL(sizeof(rec.wifiSSID) - 1, strlen(rec.wifiSSID));
+}
+
+void test_bad_json_untouched()
+{
+    ZProfileRecord before = rec;
+    TEST_ASSERT_FALSE(fromJson("{\"hostname\":"));
+    TEST_ASSERT_EQUAL_MEMORY(&before, &rec, sizeof(rec));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_check_value);
+    RUN_TEST(test_image_seal_and_valid);
+    RUN_TEST(test_dense_registers);
+    RUN_TEST(test_sparse_registers);
+    RUN_TEST(test_bad_registers_keep_defaults);
+    RUN_TEST(test_missing_fields_default);
+    RUN_TEST(test_long_strings_truncated);
+    RUN_TEST(test_bad_json_untouched);
+    return UNITY_END();
+}
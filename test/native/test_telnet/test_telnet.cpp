@@ -0,0 +1,215 @@
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include "ZTelnet.h"
+
+static std::string wire;
+static size_t writeLimit;
+
+static size_t sink(void *, const uint8_t *data, size_t len)
+{
+    size_t n = len < writeLimit ? len : writeLimit;
+    wire.append((const char *)data, n);
+    return n;
+}
+
+static ZTelnet telnet;
+
+void setUp()
+{
+    telnet = ZTelnet();
+    telnet.setOutput(sink, nullptr);
+    telnet.setTermType("ZTerm");
+    wire.clear();
+    writeLimit = (size_t)-1;
+}
+
+void tearDown()
+{
+}
+
+// feeds data in slices of step bytes and returns the clean stream
+static std::string receive(const std::string &data, size_t step)
+{
+    std::string out;
+    for (size_t i = 0; i < data.size(); i += step)
+    {
+        std::string slice = data.substr(i, step);
+        size_t n = telnet.receive((uint8_t *)&slice[0], slice.size());
+        out.append(slice, 0, n);
+    }
+    return out;
+}
+
+static std::string replies()
+{
+    std::string r((const char *)telnet.replyData(), telnet.replyLength());
+    telnet.clearReply();
+    return r;
+}
+
+static const std::string IAC(1, (char)TELNET_IAC);
+
+static std::string cmd(uint8_t verb, uint8_t option)
+{
+    return IAC + (char)verb + (char)option;
+}
+
+void test_plain_data_untouched()
+{
+    TEST_ASSERT_EQUAL_STRING("hello, world\r\n", receive("hello, world\r\n", 64).c_str());
+    TEST_ASSERT_EQUAL(0, telnet.replyLength());
+}
+
+void test_escaped_iac_in_every_slice_size()
+{
+    std::string in = "a" + IAC + IAC + "b" + IAC + IAC + IAC + IAC + "c";
+    std::string want = "a" + IAC + "b" + IAC + IAC + "c";
+    for (size_t step = 1; step <= in.size(); step++)
+    {
+        setUp();
+        TEST_ASSERT_EQUAL_STRING(want.c_str(), receive(in, step).c_str());
+    }
+}
+
+void test_commands_without_data_are_dropped()
+{
+    std::string in = "prompt>" + IAC + (char)TELNET_GA + "x" + IAC + (char)TELNET_NOP + "y";
+    TEST_ASSERT_EQUAL_STRING("prompt>xy", receive(in, 3).c_str());
+}
+
+void test_option_replies()
+{
+    std::string in = cmd(TELNET_WILL, TELNET_ECHO) + cmd(TELNET_WILL, TELNET_TERMTYPE) + cmd(TELNET_DO, TELNET_TERMTYPE) +
+                     cmd(TELNET_DO, TELNET_NAWS) + cmd(TELNET_DONT, TELNET_ECHO) + cmd(TELNET_WONT, TELNET_ECHO);
+    std::string want = cmd(TELNET_DONT, TELNET_ECHO) + cmd(TELNET_DO, TELNET_TERMTYPE) + cmd(TELNET_WILL, TELNET_TERMTYPE) +
+                       cmd(TELNET_WONT, TELNET_NAWS) + cmd(TELNET_WONT, TELNET_ECHO);
+    TEST_ASSERT_EQUAL_STRING("", receive(in, 1).c_str());
+    std::string got = replies();
+    TEST_ASSERT_EQUAL(want.size(), got.size());
+    TEST_ASSERT_EQUAL_MEMORY(want.data(), got.data(), want.size());
+}
+
+void test_terminal_type_split_across_slices()
+{
+    std::string in = "x" + IAC + (char)TELNET_SB + (char)TELNET_TERMTYPE + (char)TELNET_TTYPE_SEND + IAC + (char)TELNET_SE + "y";
+    std::string want = IAC + (char)TELNET_SB + (char)TELNET_TERMTYPE + (char)TELNET_TTYPE_IS + "ZTerm" + IAC + (char)TELNET_SE;
+    for (size_t step = 1; step <= in.size(); step++)
+    {
+        setUp();
+        TEST_ASSERT_EQUAL_STRING("xy", receive(in, step).c_str());
+        std::string got = replies();
+        TEST_ASSERT_EQUAL(want.size(), got.size());
+        TEST_ASSERT_EQUAL_MEMORY(want.data(), got.data(), want.size());
+    }
+}
+
+void test_compress2_refused_unless_enabled()
+{
+    receive(cmd(TELNET_WILL, TELNET_COMPRESS2), 1);
+    std::string got = replies();
+    TEST_ASSERT_EQUAL((uint8_t)TELNET_DONT, (uint8_t)got[1]);
+
+    telnet.setCompression(true);
+    receive(cmd(TELNET_WILL, TELNET_COMPRESS2), 1);
+    got = replies();
+    TEST_ASSERT_EQUAL((uint8_t)TELNET_DO, (uint8_t)got[1]);
+}
+
+void test_compress2_start_stops_at_stream()
+{
+    telnet.setCompression(true);
+    std::string in = "ab" + IAC + (char)TELNET_SB + (char)TELNET_COMPRESS2 + IAC + (char)TELNET_SE + "\x78\x9c";
+    std::string buf = in;
+    size_t used = 0;
+    size_t n = telnet.receive((uint8_t *)&buf[0], buf.size(), &used);
+    TEST_ASSERT_EQUAL(2, n);
+    TEST_ASSERT_EQUAL(in.size() - 2, used);
+    TEST_ASSERT_TRUE(telnet.compressionStarted());
+    TEST_ASSERT_FALSE(telnet.compressionStarted());
+}
+
+void test_send_escapes_iac()
+{
+    std::string data;
+    for (int i = 0; i < 300; i++)
+    {
+        data += (i % 7 == 0) ? IAC : std::string(1, (char)('a' + i % 26));
+    }
+    std::string want;
+    for (char c : data)
+    {
+        want += c;
+        if (c == IAC[0])
+            want += c;
+    }
+    TEST_ASSERT_EQUAL(data.size(), telnet.send((const uint8_t *)data.data(), data.size()));
+    TEST_ASSERT_EQUAL(want.size(), wire.size());
+    TEST_ASSERT_EQUAL_MEMORY(want.data(), wire.data(), want.size());
+    TEST_ASSERT_EQUAL(0, telnet.pending());
+}
+
+void test_send_clean_run_goes_direct()
+{
+    std::string data(1000, 'z');
+    TEST_ASSERT_EQUAL(data.size(), telnet.send((const uint8_t *)data.data(), data.size()));
+    TEST_ASSERT_TRUE(wire == data);
+}
+
+void test_send_short_writes()
+{
+    std::string data;
+    for (int i = 0; i < 500; i++)
+    {
+        data += (i % 50 == 0 || i % 51 == 0) ? IAC : std::string(1, (char)('0' + i % 10));
+    }
+    std::string want;
+    for (char c : data)
+    {
+        want += c;
+        if (c == IAC[0])
+            want += c;
+    }
+    // the output takes 7 bytes a call, send() reports what it took
+    writeLimit = 7;
+    size_t taken = 0;
+    int calls = 0;
+    while ((taken < data.size() || telnet.pending() > 0) && calls++ < 10000)
+    {
+        taken += telnet.send((const uint8_t *)data.data() + taken, data.size() - taken);
+        TEST_ASSERT_LESS_OR_EQUAL(data.size(), taken);
+    }
+    TEST_ASSERT_EQUAL(data.size(), taken);
+    TEST_ASSERT_EQUAL(want.size(), wire.size());
+    TEST_ASSERT_EQUAL_MEMORY(want.data(), wire.data(), want.size());
+}
+
+void test_send_blocked_output()
+{
+    writeLimit = 0;
+    std::string data = "abc" + IAC + "def";
+    size_t taken = telnet.send((const uint8_t *)data.data(), data.size());
+    TEST_ASSERT_EQUAL(data.size(), taken);
+    TEST_ASSERT_EQUAL(data.size() + 1, telnet.pending());
+    TEST_ASSERT_EQUAL(0, telnet.send((const uint8_t *)"more", 4));
+    writeLimit = (size_t)-1;
+    TEST_ASSERT_TRUE(telnet.flush());
+    TEST_ASSERT_EQUAL(data.size() + 1, wire.size());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_plain_data_untouched);
+    RUN_TEST(test_escaped_iac_in_every_slice_size);
+    RUN_TEST(test_commands_without_data_are_dropped);
+    RUN_TEST(test_option_replies);
+    RUN_TEST(test_terminal_type_split_across_slices);
+    RUN_TEST(test_compress2_refused_unless_enabled);
+    RUN_TEST(test_compress2_start_stops_at_stream);
+    RUN_TEST(test_send_escapes_iac);
+    RUN_TEST(test_send_clean_run_goes_direct);
+    RUN_TEST(test_send_short_writes);
+    RUN_TEST(test_send_blocked_output);
+    return UNITY_END();
+}
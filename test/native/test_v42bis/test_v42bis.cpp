@@ -0,0 +1,177 @@
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "ZV42bis.h"
+
+static ZV42bisEncoder encoder;
+static ZV42bisDecoder decoder;
+
+void setUp()
+{
+    encoder.begin();
+    decoder.begin();
+}
+
+void tearDown()
+{
+}
+
+static std::vector<uint8_t> text(size_t size)
+{
+    static const char *words[] = {"the ", "orc ", "swings ", "at ", "you ", "and ", "misses. ", "[HP 42]\r\n"};
+    std::vector<uint8_t> data;
+    srand(7);
+    while (data.size() < size)
+    {
+        const char *w = words[rand() % 8];
+        data.insert(data.end(), w, w + strlen(w));
+    }
+    data.resize(size);
+    return data;
+}
+
+static std::vector<uint8_t> noise(size_t size)
+{
+    std::vector<uint8_t> data(size);
+    srand(11);
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = rand();
+    }
+    return data;
+}
+
+// encodes in chunks of step bytes with a FLUSH every flushEvery chunks
+// (0 for none), ends with an ETM and decodes in one go
+static void roundTrip(const std::vector<uint8_t> &in, size_t step, int flushEvery)
+{
+    std::vector<uint8_t> packed;
+    std::vector<uint8_t> chunk(V42BIS_MAX_OUTPUT(step));
+    int chunks = 0;
+    for (size_t i = 0; i < in.size(); i += step)
+    {
+        size_t len = in.size() - i < step ? in.size() - i : step;
+        size_t n = encoder.encode(&in[i], len, chunk.data());
+        TEST_ASSERT_LESS_OR_EQUAL(V42BIS_MAX_OUTPUT(len), n);
+        packed.insert(packed.end(), chunk.begin(), chunk.begin() + n);
+        if (flushEvery && ++chunks % flushEvery == 0)
+        {
+            n = encoder.flush(chunk.data());
+            TEST_ASSERT_LESS_OR_EQUAL(V42BIS_MAX_OUTPUT(0), n);
+            packed.insert(packed.end(), chunk.begin(), chunk.begin() + n);
+        }
+    }
+    size_t n = encoder.finish(chunk.data());
+    TEST_ASSERT_LESS_OR_EQUAL(V42BIS_MAX_OUTPUT(0), n);
+    packed.insert(packed.end(), chunk.begin(), chunk.begin() + n);
+    TEST_ASSERT_FALSE(encoder.pending());
+
+    std::vector<uint8_t> out(packed.size() * V42BIS_MAX_STRING + 1);
+    size_t used = 0;
+    size_t got = decoder.decode(packed.data(), packed.size(), out.data(), &used);
+    TEST_ASSERT_FALSE(decoder.error());
+    TEST_ASSERT_TRUE(decoder.transparent());
+    TEST_ASSERT_EQUAL(packed.size(), used);
+    TEST_ASSERT_EQUAL(in.size(), got);
+    TEST_ASSERT_EQUAL_MEMORY(in.data(), out.data(), in.size());
+}
+
+void test_text_compresses()
+{
+    std::vector<uint8_t> in = text(16384);
+    std::vector<uint8_t> packed(V42BIS_MAX_OUTPUT(in.size()));
+    size_t n = encoder.encode(in.data(), in.size(), packed.data());
+    TEST_ASSERT_GREATER_THAN(n * 2, in.size());
+}
+
+void test_text_round_trip()
+{
+    roundTrip(text(16384), 512, 0);
+}
+
+void test_flushes_between_chunks()
+{
+    roundTrip(text(16384), 100, 3);
+}
+
+void test_noise_within_bound()
+{
+    roundTrip(noise(8192), 64, 0);
+}
+
+void test_dictionary_recycles()
+{
+    // enough distinct strings to fill the dictionary several times over
+    roundTrip(noise(65536), 1024, 5);
+}
+
+void test_single_bytes()
+{
+    roundTrip(text(2000), 1, 7);
+}
+
+void test_empty_stream_ends()
+{
+    roundTrip(std::vector<uint8_t>(), 1, 0);
+}
+
+void test_plain_after_etm()
+{
+    std::vector<uint8_t> in = text(300);
+    std::vector<uint8_t> packed(V42BIS_MAX_OUTPUT(in.size()) + 8);
+    size_t n = encoder.encode(in.data(), in.size(), packed.data());
+    n += encoder.finish(packed.data() + n);
+    const char *result = "\r\nOK\r\n";
+    memcpy(packed.data() + n, result, strlen(result));
+
+    std::vector<uint8_t> out(in.size() + 64);
+    size_t used = 0;
+    size_t got = decoder.decode(packed.data(), n + strlen(result), out.data(), &used);
+    TEST_ASSERT_EQUAL(in.size(), got);
+    TEST_ASSERT_EQUAL(n, used);
+    TEST_ASSERT_EQUAL_MEMORY(result, packed.data() + used, strlen(result));
+}
+
+void test_decoder_split_input()
+{
+    std::vector<uint8_t> in = text(4096);
+    std::vector<uint8_t> packed(V42BIS_MAX_OUTPUT(in.size()) + 8);
+    size_t n = encoder.encode(in.data(), in.size(), packed.data());
+    n += encoder.flush(packed.data() + n);
+    std::vector<uint8_t> out;
+    uint8_t buf[3 * V42BIS_MAX_STRING];
+    for (size_t i = 0; i < n; i += 3)
+    {
+        size_t got = decoder.decode(&packed[i], n - i < 3 ? n - i : 3, buf);
+        out.insert(out.end(), buf, buf + got);
+    }
+    TEST_ASSERT_FALSE(decoder.error());
+    TEST_ASSERT_EQUAL(in.size(), out.size());
+    TEST_ASSERT_EQUAL_MEMORY(in.data(), out.data(), in.size());
+}
+
+void test_bad_codeword_fails()
+{
+    // 9 bit codeword 511 before the dictionary got anywhere near it
+    const uint8_t bad[] = {0xFF, 0x01};
+    uint8_t out[64];
+    decoder.decode(bad, sizeof(bad), out);
+    TEST_ASSERT_TRUE(decoder.error());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_text_compresses);
+    RUN_TEST(test_text_round_trip);
+    RUN_TEST(test_flushes_between_chunks);
+    RUN_TEST(test_noise_within_bound);
+    RUN_TEST(test_dictionary_recycles);
+    RUN_TEST(test_single_bytes);
+    RUN_TEST(test_empty_stream_ends);
+    RUN_TEST(test_plain_after_etm);
+    RUN_TEST(test_decoder_split_input);
+    RUN_TEST(test_bad_codeword_fails);
+    return UNITY_END();
+}
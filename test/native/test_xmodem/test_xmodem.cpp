@@ -0,0 +1,257 @@
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include "ZCrc16.h"
+#include "ZXmodem.h"
+
+static unsigned long now;
+
+unsigned long millis()
+{
+    return now;
+}
+
+static std::string remote;
+static std::string dte;
+static int remoteWrites;
+
+static void toRemote(void *, const uint8_t *data, size_t len)
+{
+    remote.append((const char *)data, len);
+    remoteWrites++;
+}
+
+static void toDte(void *, const uint8_t *data, size_t len)
+{
+    dte.append((const char *)data, len);
+}
+
+static ZXmodem xmodem;
+
+void setUp()
+{
+    now = 1000;
+    remote.clear();
+    dte.clear();
+    remoteWrites = 0;
+    xmodem.end();
+    xmodem = ZXmodem();
+    xmodem.begin(toRemote, toDte, nullptr);
+}
+
+void tearDown()
+{
+}
+
+static std::string block(uint8_t n, bool crc, bool big = false, char fill = 'x')
+{
+    std::string payload(big ? 1024 : 128, fill);
+    std::string b;
+    b += (char)(big ? XMODEM_STX : XMODEM_SOH);
+    b += (char)n;
+    b += (char)(uint8_t)~n;
+    b += payload;
+    if (crc)
+    {
+        uint16_t c = ZCrc16::update(0, (const uint8_t *)payload.data(), payload.size());
+        b += (char)(c >> 8);
+        b += (char)(c & 0xFF);
+    }
+    else
+    {
+        uint8_t sum = 0;
+        for (char ch : payload)
+            sum += (uint8_t)ch;
+        b += (char)sum;
+    }
+    return b;
+}
+
+static void fromDte(const std::string &data)
+{
+    xmodem.fromDte((const uint8_t *)data.data(), data.size());
+}
+
+// returns what fromRemote() passes on to the DTE
+static std::string fromRemote(const std::string &data)
+{
+    std::string buf = data;
+    size_t n = xmodem.fromRemote((uint8_t *)&buf[0], buf.size());
+    return buf.substr(0, n);
+}
+
+static void start(bool crc)
+{
+    TEST_ASSERT_EQUAL_STRING(crc ? "C" : "\x15", fromRemote(crc ? "C" : "\x15").c_str());
+    fromDte(block(1, crc));
+}
+
+void test_plain_data_passes()
+{
+    fromDte("hello\x01world");
+    TEST_ASSERT_EQUAL_STRING("hello\x01world", remote.c_str());
+    TEST_ASSERT_EQUAL(1, remoteWrites);
+    TEST_ASSERT_FALSE(xmodem.active());
+}
+
+void test_first_block_acked_locally()
+{
+    start(true);
+    TEST_ASSERT_TRUE(xmodem.active());
+    TEST_ASSERT_EQUAL(block(1, true).size(), remote.size());
+    TEST_ASSERT_EQUAL_STRING("\x06", dte.c_str());
+    TEST_ASSERT_EQUAL(1, xmodem.statistics().transfers);
+    TEST_ASSERT_EQUAL(1, xmodem.statistics().blocks);
+}
+
+void test_checksum_mode()
+{
+    start(false);
+    fromDte(block(2, false, false, 'y'));
+    TEST_ASSERT_EQUAL_STRING("\x06\x06", dte.c_str());
+    TEST_ASSERT_EQUAL(2, xmodem.statistics().blocks);
+}
+
+void test_block_split_across_writes()
+{
+    fromRemote("C");
+    std::string b = block(1, true, true);
+    for (size_t i = 0; i < b.size(); i += 5)
+    {
+        fromDte(b.substr(i, 5));
+    }
+    TEST_ASSERT_EQUAL_STRING("\x06", dte.c_str());
+    TEST_ASSERT_EQUAL(b.size(), remote.size());
+    TEST_ASSERT_TRUE(remote == b);
+}
+
+void test_bad_block_nak_locally()
+{
+    start(true);
+    remote.clear();
+    std::string b = block(2, true);
+    b[10] ^= 1;
+    fromDte(b);
+    TEST_ASSERT_EQUAL_STRING("\x06\x15", dte.c_str());
+    TEST_ASSERT_EQUAL(0, remote.size());
+    TEST_ASSERT_EQUAL(1, xmodem.statistics().localNaks);
+    // the DTE resends and goes on
+    fromDte(block(2, true));
+    TEST_ASSERT_EQUAL_STRING("\x06\x15\x06", dte.c_str());
+}
+
+void test_window_full_holds_ack()
+{
+    start(true);
+    for (int n = 2; n <= XMODEM_WINDOW; n++)
+    {
+        fromDte(block(n, true));
+    }
+    // the last block filled the window, its ACK waits for the remote end
+    TEST_ASSERT_EQUAL(XMODEM_WINDOW - 1, dte.size());
+    fromRemote("\x06");
+    TEST_ASSERT_EQUAL(XMODEM_WINDOW, dte.size());
+}
+
+void test_eot_waits_for_window()
+{
+    start(true);
+    fromDte(block(2, true));
+    remote.clear();
+    fromDte("\x04");
+    TEST_ASSERT_EQUAL(0, remote.size());
+    fromRemote("\x06");
+    TEST_ASSERT_EQUAL(0, remote.size());
+    fromRemote("\x06");
+    TEST_ASSERT_EQUAL_STRING("\x04", remote.c_str());
+    TEST_ASSERT_FALSE(xmodem.active());
+}
+
+void test_remote_nak_resends_window()
+{
+    start(true);
+    fromDte(block(2, true));
+    fromDte(block(3, true));
+    fromRemote("\x06");
+    remote.clear();
+    fromRemote("\x15");
+    TEST_ASSERT_TRUE(remote == block(2, true) + block(3, true));
+    TEST_ASSERT_EQUAL(2, xmodem.statistics().resent);
+}
+
+void test_nak_before_first_ack_ignored()
+{
+    start(true);
+    remote.clear();
+    // the remote end repeating its request for block 1
+    fromRemote("C\x15");
+    TEST_ASSERT_EQUAL(0, remote.size());
+}
+
+void test_timeout_resends()
+{
+    start(true);
+    remote.clear();
+    now += XMODEM_TIMEOUT - 1;
+    xmodem.poll();
+    TEST_ASSERT_EQUAL(0, remote.size());
+    now += 1;
+    xmodem.poll();
+    TEST_ASSERT_TRUE(remote == block(1, true));
+}
+
+void test_ymodem_header_passes()
+{
+    fromRemote("C");
+    std::string header = block(0, true);
+    fromDte(header);
+    TEST_ASSERT_TRUE(remote == header);
+    TEST_ASSERT_EQUAL(0, dte.size());
+    TEST_ASSERT_FALSE(xmodem.active());
+}
+
+void test_lone_soh_let_through()
+{
+    fromRemote("C");
+    fromDte("\x01");
+    TEST_ASSERT_EQUAL(0, remote.size());
+    now += XMODEM_HOLD_TIME;
+    xmodem.poll();
+    TEST_ASSERT_EQUAL_STRING("\x01", remote.c_str());
+}
+
+void test_remote_cancel()
+{
+    start(true);
+    TEST_ASSERT_EQUAL_STRING("\x18", fromRemote("\x18").c_str());
+    TEST_ASSERT_FALSE(xmodem.active());
+    TEST_ASSERT_EQUAL(1, xmodem.statistics().cancels);
+}
+
+void test_out_of_sequence_cancels()
+{
+    start(true);
+    fromDte(block(5, true));
+    TEST_ASSERT_EQUAL_STRING("\x06\x18\x18\x18", dte.c_str());
+    TEST_ASSERT_FALSE(xmodem.active());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_plain_data_passes);
+    RUN_TEST(test_first_block_acked_locally);
+    RUN_TEST(test_checksum_mode);
+    RUN_TEST(test_block_split_across_writes);
+    RUN_TEST(test_bad_block_nak_locally);
+    RUN_TEST(test_window_full_holds_ack);
+    RUN_TEST(test_eot_waits_for_window);
+    RUN_TEST(test_remote_nak_resends_window);
+    RUN_TEST(test_nak_before_first_ack_ignored);
+    RUN_TEST(test_timeout_resends);
+    RUN_TEST(test_ymodem_header_passes);
+    RUN_TEST(test_lone_soh_let_through);
+    RUN_TEST(test_remote_cancel);
+    RUN_TEST(test_out_of_sequence_cancels);
+    return UNITY_END();
+}
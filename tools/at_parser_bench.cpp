@@ -0,0 +1,392 @@
+// AT command lines parsed per second, and a check that ZCommandParser splits
+// lines exactly as the String based parser it replaced did.
+//
+//   g++ -O2 -I include -o at_parser_bench tools/at_parser_bench.cpp src/ZCommand.cpp
+//   ./at_parser_bench [seconds]
+//
+// legacySplit() is the old ZModem::execCommandFrom() tokenizer with String
+// swapped for std::string.  Every line of the corpus, and a few thousand
+// random ones, must give the same commands, arguments, numbers and dial
+// modifiers from both.  The timing loop then runs a dialer-script style mix
+// through each.
+//
+// Three deliberate differences are folded into the reference: the line
+// length is taken after trimming (trailing blanks used to run an empty
+// command and answer ERROR), and the & / % letter and the dial modifiers
+// belong to one command instead of leaking into the next.
+
+#include "ZCommand.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Token
+{
+    std::string name;
+    std::string value;
+    long vval;
+    bool isNumber;
+    std::string modifiers;
+
+    bool operator==(const Token &o) const
+    {
+        return name == o.name && value == o.value && vval == o.vval && isNumber == o.isNumber && modifiers == o.modifiers;
+    }
+};
+
+static const char *const CORPUS[] = {
+    "AT",
+    "ATZ",
+    "at&v",
+    "ATE0V1Q0",
+    "ATE1 V0 X4",
+    "ATS0=1",
+    "ATS0?",
+    "ATS2=43S12=50",
+    "ATDT5551234",
+    "ATDTbbs.example.org:6400",
+    "ATD\"telnet.example.org:23\"",
+    "ATDS\"secure.example.org:992\"",
+    "ATC\"host:23\"E0",
+    "ATP3",
+    "ATW\"MySSID,secret\"",
+    "ATWSCAN",
+    "ATN6400",
+    "ATNE6400",
+    "ATA",
+    "ATH0",
+    "ATH1",
+    "ATO",
+    "ATI",
+    "ATI13",
+    "ATB115200",
+    "AT&K3",
+    "AT&W0",
+    "AT&Y1",
+    "AT&F",
+    "AT&T\"pool.ntp.org\"",
+    "AT%C1",
+    "AT%C?",
+    "AT+MUX",
+    "AT+console",
+    "AT$SSID=Home Network",
+    "AT$ pass = ",
+    "AT$XMODEM=1",
+    "AT$sb=9600",
+    "AT$noequals",
+    "ATL2M1",
+    "ATL-1",
+    "ATX1&D2&C1",
+    "ATE",
+    "AT&",
+    "  ATZ  ",
+    "xxATE0",
+    "ATDT,,5551234",
+    "ATD\"a\\\"b\"",
+    "ATS0=999999999999999999999",
+    "A/",
+};
+
+static std::vector<Token> legacySplit(std::string sbuf, bool *found = nullptr)
+{
+    std::vector<Token> out;
+    size_t b = sbuf.find_first_not_of(" \t\r\n\f\v");
+    size_t e = sbuf.find_last_not_of(" \t\r\n\f\v");
+    sbuf = b == std::string::npos ? "" : sbuf.substr(b, e - b + 1);
+    int len = sbuf.length();
+    auto at = [&](int k) -> char { return k < len ? sbuf[k] : '\0'; };
+    int i = 0;
+    while (i < len - 1 && (ZCommandParser::lc(at(i)) != 'a' || ZCommandParser::lc(at(i + 1)) != 't'))
+    {
+        i++;
+    }
+    if (found != nullptr)
+    {
+        *found = i < len - 1;
+    }
+    if (i >= len - 1)
+    {
+        return out;
+    }
+    i += 2;
+    char sec = ' ';
+    std::string dmodifiers;
+    while (i < len)
+    {
+        while (i < len && (at(i) == ' ' || at(i) == '\t'))
+        {
+            i++;
+        }
+        char cmd = ZCommandParser::lc(at(i++));
+        int vstart = i;
+        int vlen = 0;
+        bool isNumber = true;
+        sec = ' ';
+        dmodifiers.clear();
+        if (i < len)
+        {
+            if (cmd == '+' || cmd == '$')
+            {
+                vlen += len - i;
+                i = len;
+            }
+            else if (cmd == '&' || cmd == '%')
+            {
+                i++;
+                sec = ZCommandParser::lc(at(vstart));
+                vstart++;
+            }
+        }
+        while (i < len && (at(i) == ' ' || at(i) == '\t'))
+        {
+            vstart++;
+            i++;
+        }
+        if (i < len)
+        {
+            if (at(i) == '\"')
+            {
+                isNumber = false;
+                vstart++;
+                while (++i < len && (at(i) != '\"' || at(i - 1) == '\\'))
+                {
+                    vlen++;
+                }
+                if (i < len)
+                {
+                    i++;
+                }
+            }
+            else if (strchr("dcpatwn", cmd) != NULL)
+            {
+                while (i < len && (strchr(",exprts+", ZCommandParser::lc(at(i))) != NULL))
+                {
+                    dmodifiers += ZCommandParser::lc(at(i++));
+                }
+                while (i < len && (at(i) == ' ' || at(i) == '\t'))
+                {
+                    i++;
+                }
+                vstart = i;
+                if (at(i) == '\"')
+                {
+                    vstart++;
+                    while (++i < len && (at(i) != '\"' || at(i - 1) == '\\'))
+                    {
+                        vlen++;
+                    }
+                    if (i < len)
+                    {
+                        i++;
+                    }
+                }
+                else
+                {
+                    vlen += len - i;
+                    i = len;
+                }
+                for (int k = vstart; k < vstart + vlen; k++)
+                {
+                    char c = at(k);
+                    isNumber = ((c == '-') || ((c >= '0') && (c <= '9'))) && isNumber;
+                }
+            }
+            else
+            {
+                while ((i < len) && (!((ZCommandParser::lc(at(i)) >= 'a') && (ZCommandParser::lc(at(i)) <= 'z'))) && (at(i) != '&') && (at(i) != '%') && (at(i) != ' '))
+                {
+                    char c = at(i);
+                    isNumber = ((c == '-') || ((c >= '0') && (c <= '9'))) && isNumber;
+                    vlen++;
+                    i++;
+                }
+            }
+        }
+        std::string vbuf = sbuf.substr(vstart < len ? vstart : len, vlen);
+        long vval = 0;
+        if (vlen > 0 && isNumber)
+        {
+            std::string num;
+            for (char c : vbuf)
+            {
+                if (c >= '0' && c <= '9')
+                {
+                    num += c;
+                }
+            }
+            vval = atol(num.c_str());
+        }
+        Token t;
+        t.name = std::string(1, cmd);
+        if (cmd == '&' || cmd == '%')
+        {
+            t.name += sec;
+        }
+        t.value = vbuf;
+        t.vval = vval;
+        t.isNumber = isNumber;
+        t.modifiers = dmodifiers;
+        out.push_back(t);
+    }
+    return out;
+}
+
+static std::vector<Token> split(ZCommandParser &parser, const std::string &line)
+{
+    std::vector<Token> out;
+    if (!parser.begin(line.c_str(), line.length()))
+    {
+        return out;
+    }
+    ZCommand c;
+    while (parser.next(c))
+    {
+        Token t;
+        t.name = std::string(1, c.cmd);
+        if (c.cmd == '&' || c.cmd == '%')
+        {
+            t.name += c.sec;
+        }
+        t.value = std::string((const char *)c.vbuf, c.vlen);
+        t.vval = c.vval;
+        t.isNumber = c.isNumber;
+        t.modifiers = c.dmodifiers;
+        out.push_back(t);
+    }
+    return out;
+}
+
+// + and $ arguments become dispatch keys, checkKeys() covers those
+static void strip(std::vector<Token> &tokens)
+{
+    for (Token &t : tokens)
+    {
+        if (t.name == "+" || t.name == "$")
+        {
+            t.value.clear();
+            t.vval = 0;
+            t.isNumber = true;
+        }
+    }
+}
+
+static bool check(ZCommandParser &parser, const std::string &line, const std::string &previous)
+{
+    std::vector<Token> want = legacySplit(line == "A/" || line == "a/" ? previous : line);
+    std::vector<Token> got = split(parser, line);
+    strip(want);
+    strip(got);
+    if (want == got)
+    {
+        return true;
+    }
+    printf("MISMATCH \"%s\": %zu commands, expected %zu\n", line.c_str(), got.size(), want.size());
+    for (size_t k = 0; k < want.size() && k < got.size(); k++)
+    {
+        printf("  %s '%s' %ld %d '%s' / %s '%s' %ld %d '%s'\n",
+               want[k].name.c_str(), want[k].value.c_str(), want[k].vval, want[k].isNumber, want[k].modifiers.c_str(),
+               got[k].name.c_str(), got[k].value.c_str(), got[k].vval, got[k].isNumber, got[k].modifiers.c_str());
+    }
+    return false;
+}
+
+static bool checkKeys(ZCommandParser &parser)
+{
+    static const char *const cases[][2] = {
+        {"AT+MUX", "+mux"},
+        {"AT+Console", "+console"},
+        {"AT$ SSID = Home", "$ssid"},
+        {"AT$XMODEM=1", "$xmodem"},
+        {"AT$=1", ""},
+        {"AT$ssid", ""},
+        {"AT&V", "&v"},
+        {"AT%c1", "%c"},
+        {"AT+averyveryverylongextension", ""},
+    };
+    bool ok = true;
+    for (auto &k : cases)
+    {
+        ZCommand c;
+        parser.begin(k[0], strlen(k[0]));
+        if (!parser.next(c) || strcmp(c.name, k[1]) != 0)
+        {
+            printf("KEY \"%s\": got '%s', expected '%s'\n", k[0], c.name, k[1]);
+            ok = false;
+        }
+    }
+    ZCommand c;
+    parser.begin("AT$ssid =  Home Net ", 20);
+    parser.next(c);
+    if (strcmp((const char *)c.vbuf, "Home Net") != 0)
+    {
+        printf("VALUE: got '%s'\n", c.vbuf);
+        ok = false;
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    ZCommandParser parser;
+    bool ok = checkKeys(parser);
+    std::string previous;
+    for (const char *line : CORPUS)
+    {
+        ok = check(parser, line, previous) && ok;
+        bool found;
+        legacySplit(line, &found);
+        if (found)
+        {
+            previous = line;
+        }
+    }
+    srand(1);
+    const char alphabet[] = "atATdDsS0123456789=?&%+$\" \t,-\\wWpPnNeExX";
+    for (int n = 0; n < 20000; n++)
+    {
+        std::string line = "AT";
+        int size = rand() % 24;
+        for (int k = 0; k < size; k++)
+        {
+            line += alphabet[rand() % (sizeof(alphabet) - 1)];
+        }
+        ok = check(parser, line, previous) && ok;
+        previous = line;
+    }
+    printf("behaviour: %s\n", ok ? "matches" : "DIFFERS");
+
+    size_t count = sizeof(CORPUS) / sizeof(CORPUS[0]);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        unsigned long lines = 0;
+        unsigned long commands = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+        while (elapsed < seconds)
+        {
+            for (size_t k = 0; k < count; k++)
+            {
+                if (pass == 0)
+                {
+                    commands += legacySplit(CORPUS[k]).size();
+                }
+                else if (parser.begin(CORPUS[k], strlen(CORPUS[k])))
+                {
+                    ZCommand c;
+                    while (parser.next(c))
+                    {
+                        commands++;
+                    }
+                }
+            }
+            lines += count;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        printf("%-8s %10.0f lines/s %10.0f commands/s\n", pass == 0 ? "string" : "parser", lines / elapsed, commands / elapsed);
+    }
+    return ok ? 0 : 1;
+}
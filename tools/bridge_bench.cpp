@@ -0,0 +1,214 @@
+// Stream bridge throughput, byte at a time against the chunked bridge.
+//
+//   g++ -O2 -pthread -I include -o bridge_bench tools/bridge_bench.cpp
+//   ./bridge_bench [megabytes]
+//
+// The socket is one end of a local socketpair with a thread on the other
+// side, so every socket call is a real system call; on the modem each one
+// is an lwIP call through the tcpip thread, which costs far more.  The UART
+// is a memory buffer.
+//
+// upload    the old tick() loop: one "+++" guard check and one socket write
+//           per byte, against pumpSerialRx()/pumpSocketTx(): the escape scan
+//           over a BRIDGE_CHUNK_SIZE read, the uplink ring and one write per
+//           chunk.
+// download  one socket read per byte against one read per chunk.
+
+#include "ZRingBuffer.h"
+#include "z/options.h"
+#include "z/types.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define GUARD_TIME 1000
+
+static int sv[2];
+static unsigned long calls;
+
+static size_t socketWrite(const uint8_t *buf, size_t len)
+{
+    calls++;
+    size_t n = 0;
+    while (n < len)
+    {
+        ssize_t w = write(sv[0], buf + n, len - n);
+        if (w <= 0)
+        {
+            break;
+        }
+        n += w;
+    }
+    return n;
+}
+
+static size_t socketRead(uint8_t *buf, size_t len)
+{
+    calls++;
+    ssize_t n = read(sv[0], buf, len);
+    return n > 0 ? n : 0;
+}
+
+// a slow typist's "+" now and then so the guard check has work to do
+static std::vector<uint8_t> payload(size_t size)
+{
+    std::vector<uint8_t> data(size);
+    srand(1);
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = (i % 997 == 0) ? '+' : ' ' + rand() % 95;
+    }
+    return data;
+}
+
+static void uploadBytewise(const std::vector<uint8_t> &uart, unsigned long now)
+{
+    ZEscape esc = {};
+    for (uint8_t c : uart)
+    {
+        if (c != '+' || (now - esc.gt1) < GUARD_TIME || esc.len >= sizeof(esc.buf))
+        {
+            if (esc.len)
+            {
+                socketWrite(esc.buf, esc.len);
+                esc.len = 0;
+            }
+            socketWrite(&c, 1);
+            esc.gt1 = now;
+        }
+        else
+        {
+            esc.buf[esc.len++] = c;
+        }
+    }
+}
+
+static ZRingBuffer<BRIDGE_RING_SIZE> uplink;
+
+static void uploadChunked(const std::vector<uint8_t> &uart, unsigned long now)
+{
+    static uint8_t txChunk[BRIDGE_CHUNK_SIZE];
+    static uint8_t netChunk[BRIDGE_CHUNK_SIZE];
+    ZEscape esc = {};
+    size_t pos = 0;
+    while (pos < uart.size())
+    {
+        size_t len = uart.size() - pos < sizeof(txChunk) ? uart.size() - pos : sizeof(txChunk);
+        memcpy(txChunk, uart.data() + pos, len);
+        pos += len;
+        size_t span = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            uint8_t c = txChunk[i];
+            if (c != '+' || (now - esc.gt1) < GUARD_TIME || esc.len >= sizeof(esc.buf))
+            {
+                if (esc.len)
+                {
+                    uplink.write(esc.buf, esc.len);
+                    esc.len = 0;
+                }
+                esc.gt1 = now;
+            }
+            else
+            {
+                if (i > span)
+                {
+                    uplink.write(txChunk + span, i - span);
+                }
+                span = i + 1;
+                esc.buf[esc.len++] = c;
+            }
+        }
+        if (len > span)
+        {
+            uplink.write(txChunk + span, len - span);
+        }
+        while (!uplink.empty())
+        {
+            socketWrite(netChunk, uplink.read(netChunk, sizeof(netChunk)));
+        }
+    }
+}
+
+static void downloadBytewise(std::vector<uint8_t> &uart)
+{
+    for (size_t i = 0; i < uart.size(); i += socketRead(&uart[i], 1))
+    {
+    }
+}
+
+static void downloadChunked(std::vector<uint8_t> &uart)
+{
+    static uint8_t rxChunk[BRIDGE_CHUNK_SIZE];
+    for (size_t i = 0; i < uart.size();)
+    {
+        size_t want = uart.size() - i < sizeof(rxChunk) ? uart.size() - i : sizeof(rxChunk);
+        size_t n = socketRead(rxChunk, want);
+        memcpy(&uart[i], rxChunk, n);
+        i += n;
+    }
+}
+
+template <class F>
+static void measure(const char *what, size_t bytes, F f)
+{
+    calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-20s %8.2f MB/s %10lu socket calls\n", what, bytes / s / 1e6, calls);
+}
+
+int main(int argc, char **argv)
+{
+    size_t size = (argc > 1 ? atoi(argv[1]) : 1) << 20;
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+    {
+        perror("socketpair");
+        return 2;
+    }
+    std::vector<uint8_t> data = payload(size);
+
+    // the far end drains uploads, then feeds downloads
+    std::thread peer([&] {
+        std::vector<uint8_t> buf(65536);
+        for (int round = 0; round < 2; round++)
+        {
+            size_t got = 0;
+            while (got < size)
+            {
+                ssize_t n = read(sv[1], buf.data(), buf.size());
+                if (n <= 0)
+                    return;
+                got += n;
+            }
+        }
+        for (int round = 0; round < 2; round++)
+        {
+            for (size_t pos = 0; pos < size;)
+            {
+                ssize_t n = write(sv[1], data.data() + pos, size - pos);
+                if (n <= 0)
+                    return;
+                pos += n;
+            }
+        }
+    });
+
+    // the guard timer never expires, every "+" goes straight through
+    measure("upload bytewise", size, [&] { uploadBytewise(data, 0); });
+    measure("upload chunked", size, [&] { uploadChunked(data, 0); });
+    std::vector<uint8_t> uart(size);
+    measure("download bytewise", size, [&] { downloadBytewise(uart); });
+    bool ok = uart == data;
+    measure("download chunked", size, [&] { downloadChunked(uart); });
+    ok = ok && uart == data;
+    peer.join();
+    printf("data: %s\n", ok ? "OK" : "CORRUPTED");
+    return ok ? 0 : 1;
+}
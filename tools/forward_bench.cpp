@@ -0,0 +1,167 @@
+// Segments per second and goodput of the S51-S53 forwarding policies.
+//
+//   g++ -O2 -I include -o forward_bench tools/forward_bench.cpp
+//   ./forward_bench [seconds]
+//
+// A millisecond-step simulation of the bridge's DTE to network path.  The
+// DTE side moves whatever the UART received into the uplink ring and stamps
+// it like markUplink(); the NET side runs forwardReady() from ZModem.cpp
+// and, when it says go, writes everything pending in BRIDGE_CHUNK_SIZE
+// pieces, one TCP segment each.  A segment costs 40 bytes of TCP/IP
+// header on top of its payload.
+//
+// interactive  a typist at 8 characters per second, CR every 30 characters
+// bulk         an upload at 115200 bps
+//
+// Latency is the mean time a byte waits between reaching the UART and
+// going out in a segment.
+
+#include "z/options.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+#define SEGMENT_OVERHEAD 40
+
+struct Policy
+{
+    const char *name;
+    uint8_t s51; // forward after n*16 bytes
+    uint8_t s52; // forward after n/20 s idle
+    uint8_t s53; // forward on character
+};
+
+struct Result
+{
+    double segmentsPerSec;
+    double goodput;     // payload bytes per second
+    double efficiency;  // payload share of the bytes on the wire
+    double latencyMs;
+    size_t held;        // still queued at the end
+};
+
+class Bridge
+{
+private:
+    const Policy &p;
+    std::deque<unsigned long> pending;  // arrival time per queued byte
+    unsigned long uplinkStamp = 0;
+    bool forwardMark = false;
+
+    bool enabled() { return p.s51 || p.s52 || p.s53; }
+
+    // ZModem::forwardReady()
+    bool forwardReady(unsigned long now)
+    {
+        if (pending.empty())
+            return false;
+        if (!enabled())
+            return true;
+        if (forwardMark)
+        {
+            forwardMark = false;
+            return true;
+        }
+        if ((p.s51 && pending.size() >= p.s51 * 16u) || pending.size() >= BRIDGE_RING_SIZE / 2)
+            return true;
+        return (now - uplinkStamp) >= (p.s52 ? p.s52 : 1) * 50u;
+    }
+
+public:
+    unsigned long segments = 0;
+    unsigned long bytes = 0;
+    double waited = 0;
+
+    inline size_t queued() { return pending.size(); }
+
+    explicit Bridge(const Policy &policy) : p(policy) {}
+
+    void dte(unsigned long now, const char *data, size_t len)
+    {
+        if (len == 0)
+            return;
+        uplinkStamp = now;
+        if (p.s53 && memchr(data, p.s53, len) != nullptr)
+            forwardMark = true;
+        for (size_t i = 0; i < len; i++)
+            pending.push_back(now);
+    }
+
+    void net(unsigned long now)
+    {
+        if (!forwardReady(now))
+            return;
+        while (!pending.empty())
+        {
+            size_t n = pending.size() < BRIDGE_CHUNK_SIZE ? pending.size() : BRIDGE_CHUNK_SIZE;
+            for (size_t i = 0; i < n; i++)
+            {
+                waited += now - pending.front();
+                pending.pop_front();
+            }
+            bytes += n;
+            segments++;
+        }
+    }
+};
+
+static Result run(const Policy &policy, bool bulk, unsigned long ms)
+{
+    Bridge bridge(policy);
+    double owed = 0;
+    unsigned long typed = 0;
+    char chunk[64];
+    for (unsigned long now = 1; now <= ms; now++)
+    {
+        size_t len = 0;
+        if (bulk)
+        {
+            // 11.52 bytes per millisecond
+            owed += 11.52;
+            len = (size_t)owed;
+            owed -= len;
+            memset(chunk, 'x', len);
+        }
+        else if (now % 125 == 0)
+        {
+            chunk[0] = (++typed % 30 == 0) ? '\r' : 'a';
+            len = 1;
+        }
+        bridge.dte(now, chunk, len);
+        bridge.net(now);
+    }
+    Result r;
+    r.segmentsPerSec = bridge.segments * 1000.0 / ms;
+    r.goodput = bridge.bytes * 1000.0 / ms;
+    r.efficiency = bridge.bytes ? (double)bridge.bytes / (bridge.bytes + bridge.segments * SEGMENT_OVERHEAD) : 0;
+    r.latencyMs = bridge.bytes ? bridge.waited / bridge.bytes : 0;
+    r.held = bridge.queued();
+    return r;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long ms = (argc > 1 ? atoi(argv[1]) : 60) * 1000UL;
+    const Policy policies[] = {
+        {"off", 0, 0, 0},
+        {"S53=13 (CR)", 0, 0, 13},
+        {"S52=1 (50 ms)", 0, 1, 0},
+        {"S52=4 (200 ms)", 0, 4, 0},
+        {"S51=8 (128 B)", 8, 0, 0},
+        {"S51=32 (512 B)", 32, 0, 0},
+        {"S51=8 S52=2 S53=13", 8, 2, 13},
+    };
+    printf("%-20s %-12s %9s %10s %6s %9s %6s\n", "policy", "traffic", "segs/s", "goodput", "eff", "latency", "held");
+    for (const Policy &p : policies)
+    {
+        for (int bulk = 0; bulk < 2; bulk++)
+        {
+            Result r = run(p, bulk, ms);
+            printf("%-20s %-12s %9.1f %8.0f/s %5.1f%% %7.1fms %6zu\n", p.name, bulk ? "bulk" : "interactive",
+                   r.segmentsPerSec, r.goodput, r.efficiency * 100, r.latencyMs, r.held);
+        }
+    }
+    return 0;
+}
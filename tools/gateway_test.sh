@@ -0,0 +1,54 @@
+#!/bin/sh
+# Brings up the AT+PPP / AT+SLIP gateway from a Linux host and measures it.
+#
+#   tools/gateway_test.sh /dev/ttyUSB0 ppp|slip url
+#
+# The url should point at a server on the modem's WiFi network, e.g.
+#   python3 -m http.server 8000   (next to a test file)
+# so the run measures the gateway rather than someone else's uplink.
+#
+# socat gives pppd/slattach a PTY stand-in for the modem port, so the same
+# run works against a real adapter or a serial-over-TCP bridge
+# (e.g. SERIAL=tcp:host:port).  Needs socat, pppd (ppp) or slattach
+# (slip), curl and root.
+set -e
+
+PORT=${1:?serial port}
+PROTO=${2:?ppp or slip}
+URL=${3:?url to fetch, e.g. http://192.168.1.10:8000/100KB.bin}
+BAUD=${BAUD:-115200}
+SERIAL=${SERIAL:-$PORT,b$BAUD,raw,echo=0,crtscts=1}
+PTY=/tmp/zmodem-gw
+PEER=192.168.240.2
+LOCAL=192.168.240.1
+
+socat PTY,link=$PTY,raw,echo=0 "$SERIAL" &
+SOCAT=$!
+trap 'kill $SOCAT $LINK 2>/dev/null' EXIT
+sleep 1
+
+if [ "$PROTO" = ppp ]; then
+    pppd $PTY $BAUD nodetach noauth local crtscts nodefaultroute \
+        connect "chat -v '' AT OK AT+PPP CONNECT ''" \
+        $PEER:$LOCAL usepeerdns &
+    LINK=$!
+    IFACE=ppp0
+else
+    chat -v '' AT OK AT+SLIP CONNECT '' <$PTY >$PTY
+    slattach -p slip -s $BAUD -L $PTY &
+    LINK=$!
+    sleep 1
+    IFACE=sl0
+    ip addr add $PEER peer $LOCAL dev $IFACE
+    ip link set $IFACE mtu 1006 up
+fi
+
+for i in $(seq 30); do
+    ip addr show $IFACE 2>/dev/null | grep -q "inet $PEER" && break
+    sleep 1
+done
+
+ping -c 3 -I $IFACE $LOCAL
+# bytes/s against the raw line rate (10 bits per byte on the wire)
+curl -s -o /dev/null --interface $IFACE -w '%{size_download} bytes, %{speed_download} bytes/s\n' "$URL"
+echo "line rate: $((BAUD / 10)) bytes/s"
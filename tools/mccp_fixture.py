@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+"""Regenerates test/embedded/test_mccp/fixture.h, an MCCP2 telnet session.
+
+    python3 tools/mccp_fixture.py > test/embedded/test_mccp/fixture.h
+
+The server greets in plain text, starts COMPRESS2 and sends LINES lines of
+combat spam through zlib, with IAC GA after every tenth line and an
+escaped 0xFF in every fiftieth, then ends the zlib stream and says goodbye
+in plain text again.  test_mccp.cpp rebuilds the expected output with the
+same rules, so keep the two in step.
+"""
+
+import zlib
+
+IAC, SB, SE, WILL, GA, COMPRESS2 = 255, 250, 240, 251, 249, 86
+LINES = 1200
+
+
+def line(i):
+    return b"%05d The orc swings at you and misses. [HP %d]\r\n" % (i, 100 - i % 100)
+
+
+def main():
+    head = b"Welcome to the fixture MUD\r\n" + bytes([IAC, WILL, COMPRESS2, IAC, SB, COMPRESS2, IAC, SE])
+    body = b""
+    for i in range(LINES):
+        body += line(i)
+        if i % 10 == 9:
+            body += bytes([IAC, GA])
+        if i % 50 == 49:
+            body += bytes([IAC, IAC])
+    stream = head + zlib.compress(body, 9) + b"Goodbye\r\n"
+
+    print("// Generated by tools/mccp_fixture.py, %d lines, %d bytes inflated" % (LINES, len(body)))
+    print("#define MCCP_FIXTURE_LINES %d" % LINES)
+    print("static const uint8_t MCCP_FIXTURE[%d] = {" % len(stream))
+    for i in range(0, len(stream), 16):
+        print("    " + " ".join("0x%02x," % b for b in stream[i:i + 16]))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,113 @@
+// PETSCII translation speed in bytes per second, both directions.
+//
+//   g++ -O2 -I include -o petscii_bench tools/petscii_bench.cpp src/ZPetscii.cpp
+//   ./petscii_bench [seconds]
+//
+// The legacy side is the old per-character lookup, one table read and one
+// call per byte as the byte-at-a-time bridge did it; ZPetscii translates a
+// BRIDGE_CHUNK_SIZE buffer in place and skips words that are all space,
+// digits or punctuation.  Text is mixed case prose, "numeric" is the kind
+// of digit-heavy screen a BBS door or a stock ticker sends.
+
+#include "ZPetscii.h"
+#include "z/options.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static uint8_t legacyTable[2][256];
+
+// the old ZModem::asc2pet()/pet2asc() shape: one call per character
+static __attribute__((noinline)) bool legacyChar(char *c, int direction)
+{
+    *c = legacyTable[direction][(uint8_t)*c];
+    return true;
+}
+
+static void legacy(uint8_t *buf, size_t len, int direction)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        legacyChar((char *)&buf[i], direction);
+    }
+}
+
+static std::vector<uint8_t> text()
+{
+    std::string s;
+    while (s.size() < (1 << 20))
+    {
+        s += "The Quick Brown Fox jumps over the lazy dog; 0123456789 times.\r\n";
+    }
+    return std::vector<uint8_t>(s.begin(), s.begin() + (1 << 20));
+}
+
+static std::vector<uint8_t> numeric()
+{
+    std::string s;
+    for (int i = 0; s.size() < (1 << 20); i++)
+    {
+        char line[64];
+        snprintf(line, sizeof(line), "%08d  %10.2f  %10.2f  %+6.2f%%\r\n", i, i * 1.25, i * 0.75, (i % 200 - 100) / 10.0);
+        s += line;
+    }
+    return std::vector<uint8_t>(s.begin(), s.begin() + (1 << 20));
+}
+
+template <class F>
+static double rate(const std::vector<uint8_t> &in, std::vector<uint8_t> &work, double seconds, F f)
+{
+    unsigned long rounds = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    while (elapsed < seconds)
+    {
+        memcpy(work.data(), in.data(), in.size());
+        for (size_t pos = 0; pos < in.size(); pos += BRIDGE_CHUNK_SIZE)
+        {
+            f(work.data() + pos, in.size() - pos < BRIDGE_CHUNK_SIZE ? in.size() - pos : BRIDGE_CHUNK_SIZE);
+        }
+        rounds++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return in.size() * (double)rounds / elapsed / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 0.5;
+    // the reference tables are ZPetscii's own, read back one byte at a time
+    for (int c = 0; c < 256; c++)
+    {
+        legacyTable[0][c] = legacyTable[1][c] = c;
+    }
+    ZPetscii::ascToPet(legacyTable[0], 256);
+    ZPetscii::petToAsc(legacyTable[1], 256);
+
+    const struct
+    {
+        const char *name;
+        std::vector<uint8_t> data;
+    } inputs[] = {{"text", text()}, {"numeric", numeric()}};
+    bool ok = true;
+    for (auto &in : inputs)
+    {
+        std::vector<uint8_t> a(in.data.size());
+        std::vector<uint8_t> b(in.data.size());
+        for (int direction = 0; direction < 2; direction++)
+        {
+            double before = rate(in.data, a, seconds, [&](uint8_t *buf, size_t len) { legacy(buf, len, direction); });
+            double after = rate(in.data, b, seconds, [&](uint8_t *buf, size_t len) {
+                direction == 0 ? ZPetscii::ascToPet(buf, len) : ZPetscii::petToAsc(buf, len);
+            });
+            bool same = a == b;
+            ok = ok && same;
+            printf("%-8s %s  legacy %7.1f MB/s  ZPetscii %7.1f MB/s  x%.1f  %s\n", in.name,
+                   direction == 0 ? "ascToPet" : "petToAsc", before, after, after / before, same ? "OK" : "DIFFERS");
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+// Profile load/save cost, binary image against the JSON files it replaced.
+//
+//   g++ -O2 -I include -I lib/ArduinoJson/src -o profile_bench tools/profile_bench.cpp src/ZProfileStore.cpp
+//   ./profile_bench [directory] [rounds]
+//
+// Both formats go through real files in the given directory (default /tmp)
+// so the per-open cost shows up, but a host file system is far quicker than
+// SPIFFS.  On the modem an open costs milliseconds, so the
+// opens-per-operation column is the one to read.  The JSON side is what
+// loadProfile()/saveProfile() and activeProfile() did per profile: one
+// file and one StaticJsonDocument<1024> each, plus /profile/active.
+
+#include "ZProfileStore.h"
+#include <ArduinoJson.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+struct Profile
+{
+    char hostname[64];
+    char wifiSSID[32];
+    char wifiPSWD[64];
+    int baudRate;
+    int listenPort;
+    uint8_t regs[ZREGISTER_SPACE];
+};
+
+static unsigned long opens = 0;
+
+static FILE *openFile(const std::string &path, const char *mode)
+{
+    opens++;
+    return fopen(path.c_str(), mode);
+}
+
+static void sample(Profile &p, int num)
+{
+    memset(&p, 0, sizeof(p));
+    snprintf(p.hostname, sizeof(p.hostname), "zmodem-%d", num);
+    snprintf(p.wifiSSID, sizeof(p.wifiSSID), "Network %d", num);
+    snprintf(p.wifiPSWD, sizeof(p.wifiPSWD), "a fairly long passphrase %d", num);
+    p.baudRate = 115200;
+    p.listenPort = 6400 + num;
+    for (const ZRegister &r : ZREGISTERS)
+    {
+        p.regs[r.index] = r.defaultValue;
+    }
+    p.regs[0] = 2;
+    p.regs[50] = 0x11;
+}
+
+static void saveJson(const std::string &dir, const Profile &p, int num)
+{
+    StaticJsonDocument<1024> doc;
+    doc["version"] = "1.0";
+    doc["hostname"] = p.hostname;
+    doc["wifiSSID"] = p.wifiSSID;
+    doc["wifiPSWD"] = p.wifiPSWD;
+    doc["baudRate"] = p.baudRate;
+    doc["listenPort"] = p.listenPort;
+    JsonObject sregs = doc.createNestedObject("sregs");
+    for (const ZRegister &r : ZREGISTERS)
+    {
+        if ((r.flags & ZREG_PERSIST) && p.regs[r.index] != r.defaultValue)
+        {
+            char key[4];
+            snprintf(key, sizeof(key), "%d", r.index);
+            sregs[key] = p.regs[r.index];
+        }
+    }
+    char out[1024];
+    size_t len = serializeJson(doc, out, sizeof(out));
+    FILE *f = openFile(dir + "/profile_" + std::to_string(num), "wb");
+    fwrite(out, 1, len, f);
+    fclose(f);
+}
+
+static bool loadJson(const std::string &dir, Profile &p, int num)
+{
+    FILE *f = openFile(dir + "/profile_" + std::to_string(num), "rb");
+    if (f == nullptr)
+    {
+        return false;
+    }
+    char in[1024];
+    size_t len = fread(in, 1, sizeof(in), f);
+    fclose(f);
+    StaticJsonDocument<1024> doc;
+    if (deserializeJson(doc, in, len))
+    {
+        return false;
+    }
+    strncpy(p.hostname, doc["hostname"] | "", sizeof(p.hostname) - 1);
+    strncpy(p.wifiSSID, doc["wifiSSID"] | "", sizeof(p.wifiSSID) - 1);
+    strncpy(p.wifiPSWD, doc["wifiPSWD"] | "", sizeof(p.wifiPSWD) - 1);
+    p.baudRate = doc["baudRate"];
+    p.listenPort = doc["listenPort"];
+    for (const ZRegister &r : ZREGISTERS)
+    {
+        p.regs[r.index] = r.defaultValue;
+    }
+    for (JsonPair kv : doc["sregs"].as<JsonObject>())
+    {
+        int index = atoi(kv.key().c_str());
+        if (index >= 0 && index < ZREGISTER_SPACE)
+        {
+            p.regs[index] = kv.value().as<int>();
+        }
+    }
+    return true;
+}
+
+static int loadActiveJson(const std::string &dir)
+{
+    FILE *f = openFile(dir + "/profile_active", "rb");
+    if (f == nullptr)
+    {
+        return -1;
+    }
+    char in[8] = {0};
+    fread(in, 1, sizeof(in) - 1, f);
+    fclose(f);
+    return atoi(in);
+}
+
+static void saveImage(const std::string &dir, ZProfileImage &image)
+{
+    ZProfileStore::seal(image);
+    std::string tmp = dir + "/profiles.tmp";
+    std::string dst = dir + "/profiles.bin";
+    FILE *f = openFile(tmp, "wb");
+    fwrite(&image, 1, sizeof(image), f);
+    fclose(f);
+    remove(dst.c_str());
+    rename(tmp.c_str(), dst.c_str());
+}
+
+static bool loadImage(const std::string &dir, ZProfileImage &image)
+{
+    FILE *f = openFile(dir + "/profiles.bin", "rb");
+    if (f == nullptr)
+    {
+        return false;
+    }
+    bool ok = fread(&image, 1, sizeof(image), f) == sizeof(image) && ZProfileStore::valid(image);
+    fclose(f);
+    return ok;
+}
+
+static void toRecord(ZProfileRecord &rec, const Profile &p)
+{
+    memset(&rec, 0, sizeof(rec));
+    rec.used = 1;
+    rec.baudRate = p.baudRate;
+    rec.listenPort = p.listenPort;
+    memcpy(rec.hostname, p.hostname, sizeof(rec.hostname));
+    memcpy(rec.wifiSSID, p.wifiSSID, sizeof(rec.wifiSSID));
+    memcpy(rec.wifiPSWD, p.wifiPSWD, sizeof(rec.wifiPSWD));
+    memcpy(rec.regs, p.regs, sizeof(rec.regs));
+}
+
+static void fromRecord(Profile &p, const ZProfileRecord &rec)
+{
+    p.baudRate = rec.baudRate;
+    p.listenPort = rec.listenPort;
+    memcpy(p.hostname, rec.hostname, sizeof(p.hostname));
+    memcpy(p.wifiSSID, rec.wifiSSID, sizeof(p.wifiSSID));
+    memcpy(p.wifiPSWD, rec.wifiPSWD, sizeof(p.wifiPSWD));
+    memcpy(p.regs, rec.regs, sizeof(p.regs));
+}
+
+template <class F>
+static void measure(const char *what, int rounds, F f)
+{
+    opens = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+    {
+        f();
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    printf("%-28s %9.1f us %6.1f opens\n", what, us / rounds, (double)opens / rounds);
+}
+
+int main(int argc, char **argv)
+{
+    std::string dir = argc > 1 ? argv[1] : "/tmp";
+    int rounds = argc > 2 ? atoi(argv[2]) : 2000;
+
+    Profile profiles[MAX_USER_PROFILES];
+    for (int num = 0; num < MAX_USER_PROFILES; num++)
+    {
+        sample(profiles[num], num);
+    }
+    FILE *f = fopen((dir + "/profile_active").c_str(), "wb");
+    fputs("1", f);
+    fclose(f);
+
+    ZProfileImage image;
+    ZProfileStore::clear(image);
+    image.active = 1;
+    for (int num = 0; num < MAX_USER_PROFILES; num++)
+    {
+        toRecord(image.profiles[num], profiles[num]);
+    }
+
+    printf("image %zu bytes, %d profiles\n", sizeof(image), MAX_USER_PROFILES);
+
+    measure("JSON save (AT&W)", rounds, [&] { saveJson(dir, profiles[1], 1); });
+    measure("binary save (AT&W)", rounds, [&] { toRecord(image.profiles[1], profiles[1]); saveImage(dir, image); });
+
+    for (int num = 0; num < MAX_USER_PROFILES; num++)
+    {
+        saveJson(dir, profiles[num], num);
+    }
+    saveImage(dir, image);
+
+    Profile p;
+    measure("JSON boot (active + load)", rounds, [&] { loadJson(dir, p, loadActiveJson(dir)); });
+    measure("binary boot (active + load)", rounds, [&] { ZProfileImage i; loadImage(dir, i); fromRecord(p, i.profiles[i.active]); });
+    measure("JSON AT&V (all stored)", rounds, [&] { for (int n = 0; n < MAX_USER_PROFILES; n++) loadJson(dir, p, n); });
+    measure("binary AT&V (all stored)", rounds, [&] { for (int n = 0; n < MAX_USER_PROFILES; n++) fromRecord(p, image.profiles[n]); });
+
+    ZProfileImage check;
+    bool ok = loadImage(dir, check) && memcmp(check.profiles, image.profiles, sizeof(image.profiles)) == 0;
+    ((uint8_t *)&check)[20] ^= 1;
+    ok = ok && !ZProfileStore::valid(check);
+    printf("round trip and CRC: %s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+// Telnet receive throughput, ZTelnet against the processIAC() loop it replaced.
+//
+//   g++ -O2 -I include -o telnet_bench tools/telnet_bench.cpp src/ZTelnet.cpp
+//   ./telnet_bench [capture...]
+//
+// Captures are raw socket-to-modem streams with the telnet commands still in
+// them.  Without arguments three synthetic ones are used: MUD style prompts
+// ending in IAC GA with GMCP subnegotiations between them, a binary transfer
+// with every 0xFF doubled, and plain text.  The legacy side is the old
+// byte-at-a-time bridge, socketRead() becoming a read from memory so the
+// 250 ms waits never happen; ZTelnet gets BRIDGE_CHUNK_SIZE slices.  Both
+// outputs must match.
+
+#include "ZTelnet.h"
+#include "z/options.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+struct Source
+{
+    const Bytes &data;
+    size_t pos;
+
+    int read() { return pos < data.size() ? data[pos++] : -1; }
+};
+
+// ZModem::processIAC() from before the parser, replies dropped.  The SB loop
+// used to stop at the IAC itself (signed char, *c >= 0) and pass the SE on
+// as data; it runs to IAC SE here so the outputs can be compared.
+static bool legacyIAC(Source &src, char *c)
+{
+    if (*c == (char)0xFF)
+    {
+        *c = src.read();
+        if (*c == (char)TELNET_IAC)
+        {
+            *c = 0xFF;
+            return true;
+        }
+        if (*c == (char)TELNET_WILL || *c == (char)TELNET_DONT || *c == (char)TELNET_WONT || *c == (char)TELNET_DO)
+        {
+            src.read();
+            return false;
+        }
+        if (*c == (char)TELNET_SB)
+        {
+            src.read();
+            char lastC = *c;
+            while (((lastC != (char)TELNET_IAC) || (*c != (char)TELNET_SE)) && src.pos < src.data.size())
+            {
+                lastC = *c;
+                *c = src.read();
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+static size_t legacy(const Bytes &in, Bytes &out)
+{
+    Source src = {in, 0};
+    size_t n = 0;
+    while (src.pos < in.size())
+    {
+        char c = src.read();
+        if (legacyIAC(src, &c))
+        {
+            out[n++] = c;
+        }
+    }
+    return n;
+}
+
+static size_t parser(ZTelnet &telnet, const Bytes &in, Bytes &out)
+{
+    size_t n = 0;
+    for (size_t pos = 0; pos < in.size(); pos += BRIDGE_CHUNK_SIZE)
+    {
+        size_t len = in.size() - pos < BRIDGE_CHUNK_SIZE ? in.size() - pos : BRIDGE_CHUNK_SIZE;
+        memcpy(out.data() + n, in.data() + pos, len);
+        n += telnet.receive(out.data() + n, len);
+        telnet.clearReply();
+    }
+    return n;
+}
+
+static void append(Bytes &b, const std::string &s)
+{
+    b.insert(b.end(), s.begin(), s.end());
+}
+
+static Bytes mud()
+{
+    Bytes b;
+    for (int i = 0; i < 20000; i++)
+    {
+        append(b, "\x1b[1;32mYou are standing in a small clearing.\x1b[0m\r\n");
+        append(b, "<" + std::to_string(i % 500) + "hp 120m 300mv> ");
+        b.push_back(TELNET_IAC);
+        b.push_back(TELNET_GA);
+        if (i % 4 == 0)
+        {
+            const uint8_t sb[] = {TELNET_IAC, TELNET_SB, TELNET_GMCP};
+            b.insert(b.end(), sb, sb + sizeof(sb));
+            append(b, "Char.Vitals {\"hp\":\"120\",\"mp\":\"45\"}");
+            b.push_back(TELNET_IAC);
+            b.push_back(TELNET_SE);
+        }
+    }
+    return b;
+}
+
+static Bytes binary()
+{
+    Bytes b;
+    srand(1);
+    for (int i = 0; i < 1 << 20; i++)
+    {
+        uint8_t c = rand() & 0xFF;
+        b.push_back(c);
+        if (c == TELNET_IAC)
+        {
+            b.push_back(c);
+        }
+    }
+    return b;
+}
+
+static Bytes text()
+{
+    Bytes b;
+    for (int i = 0; i < 20000; i++)
+    {
+        append(b, "The quick brown fox jumps over the lazy dog " + std::to_string(i) + "\r\n");
+    }
+    return b;
+}
+
+static Bytes load(const char *path)
+{
+    Bytes data;
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr)
+    {
+        return data;
+    }
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        data.insert(data.end(), buf, buf + n);
+    }
+    fclose(f);
+    return data;
+}
+
+template <class F>
+static double rate(const Bytes &in, F f)
+{
+    int rounds = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    while (elapsed < 0.5)
+    {
+        f();
+        rounds++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return in.size() * (double)rounds / elapsed / 1e6;
+}
+
+static bool run(const char *name, const Bytes &in)
+{
+    Bytes a(in.size());
+    Bytes b(in.size());
+    ZTelnet telnet;
+    size_t na = legacy(in, a);
+    size_t nb = parser(telnet, in, b);
+    bool ok = na == nb && std::equal(a.begin(), a.begin() + na, b.begin());
+    double before = rate(in, [&] { legacy(in, a); });
+    double after = rate(in, [&] { telnet.reset(); parser(telnet, in, b); });
+    printf("%-10s %8zu bytes  legacy %7.1f MB/s  ZTelnet %7.1f MB/s  x%.1f  %s\n", name, in.size(), before, after,
+           after / before, ok ? "OK" : "DIFFERS");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    bool ok = true;
+    if (argc > 1)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            ok = run(argv[i], load(argv[i])) && ok;
+        }
+    }
+    else
+    {
+        ok = run("mud", mud()) && ok;
+        ok = run("binary", binary()) && ok;
+        ok = run("text", text()) && ok;
+    }
+    return ok ? 0 : 1;
+}
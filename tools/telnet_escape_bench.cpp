@@ -0,0 +1,113 @@
+// Telnet TX escaping cost, the stack VLA escaper against ZTelnet::send().
+//
+//   g++ -O2 -I include -o telnet_escape_bench tools/telnet_escape_bench.cpp src/ZTelnet.cpp
+//   ./telnet_escape_bench [seconds]
+//
+// The old socketWrite() copied every write into a uint8_t[size * 2] on the
+// stack, doubling 0xFF byte by byte, and wrote it in one call.  ZTelnet
+// scans for 0xFF a word at a time, hands long clean runs to the output
+// untouched and only copies short runs and escapes through its scratch
+// buffer.  The output here is a memcpy into a sink, so the numbers are the
+// escaping alone; the output call count shows how writes get split.
+// Both escapers must produce the same bytes.
+
+#include "ZTelnet.h"
+#include "z/options.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static std::vector<uint8_t> wire;
+static size_t wireLen;
+static unsigned long outputs;
+
+static size_t sink(void *, const uint8_t *data, size_t len)
+{
+    memcpy(wire.data() + wireLen, data, len);
+    wireLen += len;
+    outputs++;
+    return len;
+}
+
+// ZModem::socketWrite() before the escaper; the VLA becomes a static
+// buffer, which costs the same and keeps the compiler happy
+static size_t legacy(const uint8_t *buf, size_t size)
+{
+    static uint8_t escbuf[BRIDGE_CHUNK_SIZE * 2];
+    size_t k = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        escbuf[k++] = buf[i];
+        if (buf[i] == 0xFF)
+        {
+            escbuf[k++] = buf[i];
+        }
+    }
+    return sink(nullptr, escbuf, k);
+}
+
+// one 0xFF in every `every` bytes on average, 0 for none
+static std::vector<uint8_t> sample(size_t size, int every)
+{
+    std::vector<uint8_t> data(size);
+    srand(1);
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = (every > 0 && rand() % every == 0) ? 0xFF : rand() % 255;
+    }
+    return data;
+}
+
+template <class F>
+static double rate(const std::vector<uint8_t> &in, double seconds, F f)
+{
+    unsigned long rounds = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    outputs = 0;
+    while (elapsed < seconds)
+    {
+        wireLen = 0;
+        for (size_t pos = 0; pos < in.size(); pos += BRIDGE_CHUNK_SIZE)
+        {
+            f(in.data() + pos, in.size() - pos < BRIDGE_CHUNK_SIZE ? in.size() - pos : BRIDGE_CHUNK_SIZE);
+        }
+        rounds++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    outputs /= rounds;
+    return in.size() * (double)rounds / elapsed / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 0.5;
+    const struct
+    {
+        const char *name;
+        int every;
+    } cases[] = {{"no 0xFF", 0}, {"random", 256}, {"1 in 16", 16}, {"0xFF dense", 2}};
+
+    ZTelnet telnet;
+    telnet.setOutput(sink, nullptr);
+    bool ok = true;
+    for (auto &c : cases)
+    {
+        std::vector<uint8_t> in = sample(1 << 20, c.every);
+        wire.assign(in.size() * 2, 0);
+
+        double before = rate(in, seconds, legacy);
+        unsigned long beforeCalls = outputs;
+        std::vector<uint8_t> want(wire.begin(), wire.begin() + wireLen);
+
+        double after = rate(in, seconds, [&](const uint8_t *buf, size_t len) { telnet.send(buf, len); });
+        unsigned long afterCalls = outputs;
+        bool same = wireLen == want.size() && memcmp(wire.data(), want.data(), wireLen) == 0;
+        ok = ok && same;
+        printf("%-12s legacy %7.1f MB/s %5lu writes   ZTelnet %7.1f MB/s %5lu writes   x%.1f  %s\n", c.name, before,
+               beforeCalls, after, afterCalls, after / before, same ? "OK" : "DIFFERS");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Measures full vs. resumed TLS handshakes of ATCS dials.
+
+Runs a local TLS echo server (TLS 1.2, session IDs and tickets on) with a
+throwaway self-signed certificate, has the modem dial it ROUNDS times with
+ATCS and reads the handshake time back from ATI12.
+
+    tls_test.py /dev/ttyUSB0 --host 192.168.1.10 [--rounds 5]
+"""
+
+import argparse
+import os
+import re
+import socket
+import ssl
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+import serial
+
+
+def make_cert(directory):
+    cert = os.path.join(directory, "cert.pem")
+    key = os.path.join(directory, "key.pem")
+    subprocess.run(["openssl", "req", "-x509", "-newkey", "rsa:2048", "-nodes", "-days", "1",
+                    "-subj", "/CN=zmodem-test", "-keyout", key, "-out", cert],
+                   check=True, capture_output=True)
+    return cert, key
+
+
+def echo_server(listener, context, log):
+    while True:
+        conn, _ = listener.accept()
+        try:
+            tls = context.wrap_socket(conn, server_side=True)
+        except (ssl.SSLError, OSError) as e:
+            log.append("handshake failed: %s" % e)
+            continue
+        log.append("reused" if tls.session_reused else "full")
+
+        def serve(s=tls):
+            with s:
+                try:
+                    while True:
+                        data = s.recv(4096)
+                        if not data:
+                            return
+                        s.sendall(data)
+                except (ssl.SSLError, OSError):
+                    return
+
+        threading.Thread(target=serve, daemon=True).start()
+
+
+def command(port, line, timeout=15.0):
+    port.reset_input_buffer()
+    port.write(line.encode() + b"\r")
+    deadline = time.time() + timeout
+    reply = b""
+    while time.time() < deadline:
+        reply += port.read(256)
+        if any(r in reply for r in (b"OK", b"ERROR", b"CONNECT", b"NO ANSWER", b"NO CARRIER")):
+            time.sleep(0.1)
+            reply += port.read(port.in_waiting)
+            break
+    return reply.decode(errors="replace")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--host", required=True, help="address of this machine as seen by the modem")
+    parser.add_argument("--rounds", type=int, default=5)
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        cert, key = make_cert(tmp)
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.maximum_version = ssl.TLSVersion.TLSv1_2
+        context.load_cert_chain(cert, key)
+        listener = socket.socket()
+        listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        listener.bind(("0.0.0.0", 0))
+        listener.listen()
+        log = []
+        threading.Thread(target=echo_server, args=(listener, context, log), daemon=True).start()
+        address = "%s:%d" % (args.host, listener.getsockname()[1])
+
+        modem = serial.Serial(args.port, args.baud, timeout=0.1, rtscts=True)
+        times = {"full": [], "resumed": []}
+        for i in range(args.rounds):
+            reply = command(modem, 'ATCS"%s"' % address)
+            if "CONNECT" not in reply:
+                print("round %d: dial failed: %s" % (i, reply.strip()))
+                return 1
+            info = command(modem, "ATI12")
+            command(modem, "ATH")
+            for line in info.splitlines():
+                # "TLS <cipher>: full|resumed handshake N ms", not the session totals
+                m = re.search(r"(full|resumed) handshake (\d+) ms", line)
+                if m:
+                    kind, ms = m.group(1), int(m.group(2))
+                    times[kind].append(ms)
+                    print("round %d: %s handshake %d ms (server saw %s)" % (i, kind, ms, log[-1] if log else "?"))
+
+        for kind, values in times.items():
+            if values:
+                print("%s: %d handshakes, average %.0f ms" % (kind, len(values), sum(values) / len(values)))
+        return 0 if times["resumed"] else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
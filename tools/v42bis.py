@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Host-side decoder for the modem's compressed DTE link (AT%C1).
+
+    v42bis.py /dev/ttyUSB0 [--baud 1200]
+
+Works as a minimal terminal: keystrokes go to the modem unchanged, and
+network data is decoded while in data mode.  The modem restarts its
+dictionary every time it enters data mode, so the decoder is reset on each
+CONNECT result and on the OK that answers ATO.  Leaving data mode, for
+"+++" or a dropped call, the modem ends the compressed stream with an ETM
+codeword; everything after it, the result code first, is plain again.
+
+The decoder mirrors src/ZV42bis.cpp and has to use the same dictionary
+size and maximum string length (V42BIS_DICT_SIZE, V42BIS_MAX_STRING).
+"""
+
+import argparse
+import os
+import select
+import sys
+import termios
+import tty
+
+import serial
+
+ETM, FLUSH, STEPUP = 0, 1, 2
+N6 = 3
+N5 = N6 + 256
+
+
+class Decoder:
+    def __init__(self, dict_size=2048, max_string=32):
+        self.size = dict_size
+        self.max_string = max_string
+        self.reset()
+
+    def reset(self):
+        self.parent = [0] * self.size
+        self.child = [0] * self.size
+        self.sibling = [0] * self.size
+        self.symbol = [0] * self.size
+        self.next = N5
+        self.full = False
+        self.bits = 9
+        self.prev = None
+        self.acc = 0
+        self.acc_bits = 0
+        self.failed = False
+        self.ended = False
+
+    def slot(self, parent):
+        if not self.full:
+            return self.next
+        k = self.next
+        while self.child[k] or k == parent:
+            k = k + 1 if k + 1 < self.size else N5
+        return k
+
+    def add(self, parent, c):
+        k = self.slot(parent)
+        if self.full:
+            p = self.parent[k]
+            if self.child[p] == k:
+                self.child[p] = self.sibling[k]
+            else:
+                s = self.child[p]
+                while self.sibling[s] != k:
+                    s = self.sibling[s]
+                self.sibling[s] = self.sibling[k]
+        self.parent[k], self.symbol[k], self.child[k] = parent, c, 0
+        self.sibling[k] = self.child[parent]
+        self.child[parent] = k
+        self.next = k + 1
+        if self.next >= self.size:
+            self.next, self.full = N5, True
+
+    def expand(self, node):
+        out = bytearray()
+        while node >= N5:
+            out.append(self.symbol[node])
+            node = self.parent[node]
+        out.append(node - N6)
+        out.reverse()
+        return out
+
+    def decode(self, data):
+        """Returns the decoded bytes and the input left over after an ETM."""
+        out = bytearray()
+        for i, byte in enumerate(data):
+            if self.failed:
+                break
+            if self.ended:
+                return bytes(out), bytes(data[i:])
+            self.acc |= byte << self.acc_bits
+            self.acc_bits += 8
+            while self.acc_bits >= self.bits:
+                value = self.acc & ((1 << self.bits) - 1)
+                self.acc >>= self.bits
+                self.acc_bits -= self.bits
+                if value == STEPUP:
+                    self.bits += 1
+                    continue
+                if value == FLUSH:
+                    pad = self.acc_bits % 8
+                    self.acc >>= pad
+                    self.acc_bits -= pad
+                    self.prev = None
+                    continue
+                if value == ETM:
+                    # the rest of this octet is padding
+                    self.acc = self.acc_bits = 0
+                    self.ended = True
+                    break
+                if value >= self.size or (not self.full and value > self.next):
+                    self.failed = True
+                    break
+                prev = self.prev
+                if prev is not None and len(prev[1]) < self.max_string:
+                    if value == self.slot(prev[0]):
+                        s = prev[1] + prev[1][:1]
+                    else:
+                        s = self.expand(value)
+                    self.add(prev[0], s[0])
+                else:
+                    s = self.expand(value)
+                self.prev = (value, s)
+                out += s
+        return bytes(out), b""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=1200)
+    args = parser.parse_args()
+
+    port = serial.Serial(args.port, args.baud, timeout=0)
+    decoder = Decoder()
+    data_mode = False
+    line = bytearray()
+    stdin = sys.stdin.fileno()
+    saved = termios.tcgetattr(stdin)
+    tty.setraw(stdin)
+    try:
+        while True:
+            ready, _, _ = select.select([port, stdin], [], [])
+            if stdin in ready:
+                keys = os.read(stdin, 64)
+                if b"\x1d" in keys:  # ^] quits
+                    return 0
+                port.write(keys)
+            if port in ready:
+                raw = port.read(port.in_waiting or 1)
+                if data_mode:
+                    out, raw = decoder.decode(raw)
+                    os.write(sys.stdout.fileno(), out)
+                    if not decoder.ended:
+                        continue
+                    data_mode = False
+                os.write(sys.stdout.fileno(), raw)
+                # result codes switch the decoder on; anything after them is compressed
+                line += raw
+                for marker in (b"CONNECT", b"OK"):
+                    at = line.rfind(marker)
+                    if at >= 0 and b"\n" in line[at:]:
+                        end = line.index(b"\n", at) + 1
+                        if marker == b"CONNECT" or line[:at].rstrip().upper().endswith(b"ATO"):
+                            decoder.reset()
+                            data_mode = True
+                            out, rest = decoder.decode(line[end:])
+                            os.write(sys.stdout.fileno(), out)
+                            if decoder.ended:
+                                data_mode = False
+                                os.write(sys.stdout.fileno(), rest)
+                        line.clear()
+                        break
+                del line[:-256]
+    finally:
+        termios.tcsetattr(stdin, termios.TCSADRAIN, saved)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
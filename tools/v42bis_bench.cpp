@@ -0,0 +1,74 @@
+// Compression ratio and CPU cost of the V.42bis encoder on captured sessions.
+//
+//   g++ -O2 -I include -o v42bis_bench tools/v42bis_bench.cpp src/ZV42bis.cpp
+//   ./v42bis_bench capture1.ans capture2.seq ...
+//
+// Captures are raw network-to-DTE byte streams (ANSI or PETSCII).  Each file
+// is fed in BRIDGE_CHUNK_SIZE pieces as the bridge would, with a flush every
+// FLUSH_EVERY chunks to model idle periods, and decoded again to check the
+// round trip.
+
+#include "ZV42bis.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#define FLUSH_EVERY 4
+
+static std::vector<uint8_t> load(const char *path)
+{
+    std::vector<uint8_t> data;
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr)
+    {
+        return data;
+    }
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        data.insert(data.end(), buf, buf + n);
+    }
+    fclose(f);
+    return data;
+}
+
+int main(int argc, char **argv)
+{
+    ZV42bisEncoder encoder;
+    ZV42bisDecoder decoder;
+    if (argc < 2 || !encoder.begin() || !decoder.begin())
+    {
+        fprintf(stderr, "usage: %s capture...\n", argv[0]);
+        return 2;
+    }
+    int failures = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::vector<uint8_t> in = load(argv[i]);
+        std::vector<uint8_t> packed(V42BIS_MAX_OUTPUT(in.size()) + in.size() / BRIDGE_CHUNK_SIZE * 8);
+        encoder.reset();
+        size_t out = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t pos = 0, chunk = 0; pos < in.size(); pos += BRIDGE_CHUNK_SIZE, chunk++)
+        {
+            size_t len = in.size() - pos < BRIDGE_CHUNK_SIZE ? in.size() - pos : BRIDGE_CHUNK_SIZE;
+            out += encoder.encode(in.data() + pos, len, packed.data() + out);
+            if (chunk % FLUSH_EVERY == FLUSH_EVERY - 1)
+            {
+                out += encoder.flush(packed.data() + out);
+            }
+        }
+        out += encoder.flush(packed.data() + out);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<uint8_t> back(out * V42BIS_MAX_STRING + 1);
+        decoder.reset();
+        size_t n = decoder.decode(packed.data(), out, back.data());
+        bool ok = !decoder.error() && n == in.size() && std::equal(in.begin(), in.end(), back.begin());
+        failures += ok ? 0 : 1;
+        printf("%s: %zu -> %zu bytes, ratio %.2f, %.1f ns/byte, round trip %s\n", argv[i], in.size(), out,
+               out ? (double)in.size() / out : 0.0, in.size() ? ns / in.size() : 0.0, ok ? "OK" : "FAILED");
+    }
+    return failures ? 1 : 0;
+}
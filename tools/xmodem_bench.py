@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""Upload throughput with and without XMODEM ACK spoofing (AT$XMODEM=n).
+
+Starts a local XMODEM-CRC receiver behind a TCP stand-in that delays every
+byte by half the round trip in each direction, then uploads the same
+random file through the modem twice, once per setting.
+
+    xmodem_bench.py /dev/ttyUSB0 --host 192.168.1.10 [--rtt 150] [--size 32768] [--1k]
+"""
+
+import argparse
+import asyncio
+import os
+import sys
+import threading
+import time
+
+import serial
+
+SOH, STX, EOT, ACK, NAK, CAN = 0x01, 0x02, 0x04, 0x06, 0x15, 0x18
+
+
+def crc16(data):
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+class Delayed:
+    """Delivers writes delay seconds later, in order, without serializing them."""
+
+    def __init__(self, writer, delay):
+        self.writer = writer
+        self.delay = delay
+        self.queue = asyncio.Queue()
+        self.task = asyncio.ensure_future(self.run())
+
+    def write(self, data):
+        self.queue.put_nowait((time.monotonic() + self.delay, data))
+
+    async def run(self):
+        while True:
+            due, data = await self.queue.get()
+            await asyncio.sleep(max(0, due - time.monotonic()))
+            self.writer.write(data)
+
+
+async def receive(reader, writer, delay, results):
+    # everything the receiver reads arrives delay late as well
+    inbox = asyncio.Queue()
+
+    async def pump():
+        while True:
+            data = await reader.read(4096)
+            if not data:
+                inbox.put_nowait(None)
+                return
+            due = time.monotonic() + delay
+            inbox.put_nowait((due, data))
+
+    asyncio.ensure_future(pump())
+    buf = bytearray()
+
+    async def need(n):
+        while len(buf) < n:
+            item = await inbox.get()
+            if item is None:
+                raise EOFError
+            due, data = item
+            await asyncio.sleep(max(0, due - time.monotonic()))
+            buf.extend(data)
+        out = bytes(buf[:n])
+        del buf[:n]
+        return out
+
+    out = Delayed(writer, delay)
+    out.write(b"C")
+    expected, received = 1, bytearray()
+    try:
+        while True:
+            (kind,) = await need(1)
+            if kind == EOT:
+                out.write(bytes([ACK]))
+                break
+            if kind == CAN:
+                break
+            if kind not in (SOH, STX):
+                continue
+            size = 128 if kind == SOH else 1024
+            block = await need(2 + size + 2)
+            n, payload = block[0], block[2:2 + size]
+            ok = block[1] == 255 - n and crc16(payload) == int.from_bytes(block[-2:], "big")
+            if not ok:
+                out.write(bytes([NAK]))
+            elif n == expected & 0xFF:
+                received += payload
+                expected += 1
+                out.write(bytes([ACK]))
+            elif n == (expected - 1) & 0xFF:
+                out.write(bytes([ACK]))
+            else:
+                out.write(bytes([CAN, CAN]))
+                break
+    except EOFError:
+        pass
+    await asyncio.sleep(delay + 0.1)
+    results.append(bytes(received))
+    writer.close()
+
+
+def serve(port, delay, results, ready):
+    loop = asyncio.new_event_loop()
+    asyncio.set_event_loop(loop)
+    server = loop.run_until_complete(asyncio.start_server(
+        lambda r, w: receive(r, w, delay, results), "0.0.0.0", port))
+    ready.append(server.sockets[0].getsockname()[1])
+    loop.run_forever()
+
+
+def command(modem, line, expect=(b"OK", b"ERROR"), timeout=15.0):
+    modem.reset_input_buffer()
+    modem.write(line.encode() + b"\r")
+    reply, deadline = b"", time.time() + timeout
+    while time.time() < deadline and not any(e in reply for e in expect):
+        reply += modem.read(64)
+    return reply
+
+
+def send(modem, data, one_k, timeout=60.0):
+    size = 1024 if one_k else 128
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        c = modem.read(1)
+        if c == b"C":
+            break
+    else:
+        raise TimeoutError("receiver never asked for block 1")
+    started = time.time()
+    n = 1
+    for pos in range(0, len(data), size):
+        payload = data[pos:pos + size].ljust(size, b"\x1a")
+        block = bytes([STX if one_k else SOH, n & 0xFF, 255 - (n & 0xFF)]) + payload + crc16(payload).to_bytes(2, "big")
+        for _ in range(10):
+            modem.write(block)
+            reply = b""
+            while reply not in (bytes([ACK]), bytes([NAK]), bytes([CAN])):
+                reply = modem.read(1)
+                if time.time() > deadline:
+                    raise TimeoutError("block %d" % n)
+            if reply[0] == ACK:
+                break
+            if reply[0] == CAN:
+                raise RuntimeError("cancelled at block %d" % n)
+        n += 1
+    modem.write(bytes([EOT]))
+    while modem.read(1) != bytes([ACK]):
+        if time.time() > deadline:
+            raise TimeoutError("EOT")
+    return time.time() - started
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--host", required=True, help="address of this machine as seen by the modem")
+    parser.add_argument("--rtt", type=float, default=150, help="injected round trip in ms")
+    parser.add_argument("--size", type=int, default=32768)
+    parser.add_argument("--1k", dest="one_k", action="store_true", help="XMODEM-1K blocks")
+    args = parser.parse_args()
+
+    results, ready = [], []
+    threading.Thread(target=serve, args=(0, args.rtt / 2000, results, ready), daemon=True).start()
+    while not ready:
+        time.sleep(0.05)
+    address = "%s:%d" % (args.host, ready[0])
+    data = os.urandom(args.size)
+    modem = serial.Serial(args.port, args.baud, timeout=0.05, rtscts=True)
+
+    ok = True
+    for spoof in (0, 1):
+        command(modem, "AT$XMODEM=%d" % spoof)
+        if b"CONNECT" not in command(modem, 'ATD"%s"' % address, expect=(b"CONNECT", b"NO ")):
+            print("dial failed")
+            return 1
+        elapsed = send(modem, data, args.one_k)
+        time.sleep(args.rtt / 1000 + 0.5)
+        got = results[-1][:len(data)] if results else b""
+        ok &= got == data
+        print("spoofing %s: %d bytes in %.2f s, %.0f bytes/s, %s" % (
+            "on " if spoof else "off", len(data), elapsed, len(data) / elapsed, "OK" if got == data else "CORRUPT"))
+        time.sleep(1.2)
+        modem.write(b"+++")
+        time.sleep(1.2)
+        command(modem, "ATH")
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""Host side of the modem packet mode (AT+MUX).
+
+Frames are SOF | channel:2 | type:1 | length:2 | payload | crc16:2, little
+endian, CRC-16/CCITT (init 0xFFFF) over channel through payload.  Each side
+starts with ZMUX_WINDOW bytes of credit per channel and returns credit with
+CREDIT frames as it consumes data.
+
+    zmux.py /dev/ttyUSB0 open bbs.example.org:23
+    zmux.py /dev/ttyUSB0 bench --host 192.168.1.10 --channels 4
+
+bench starts local TCP echo servers, has the modem dial each of them and
+pushes data through all channels at once, checking what comes back.
+"""
+
+import argparse
+import os
+import socket
+import struct
+import sys
+import threading
+import time
+
+import serial
+
+SOF = 0xF9
+DATA, CREDIT, OPEN, CLOSE, EXIT, ERROR = range(6)
+MAX_PAYLOAD = 1024
+WINDOW = 4096
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+class Channel:
+    def __init__(self, cid, host):
+        self.id = cid
+        self.host = host
+        self.credit = WINDOW
+        self.received = bytearray()
+        self.closed = False
+
+
+class Mux:
+    def __init__(self, port, baud):
+        self.ser = serial.Serial(port, baud, timeout=0.05, rtscts=True)
+        self.buf = bytearray()
+        self.channels = {}
+        self.errors = []
+        self.crc_errors = 0
+
+    def command(self, line, timeout=2.0):
+        self.ser.reset_input_buffer()
+        self.ser.write(line.encode() + b"\r")
+        deadline = time.time() + timeout
+        reply = b""
+        while time.time() < deadline and b"OK" not in reply and b"ERROR" not in reply:
+            reply += self.ser.read(64)
+        return reply
+
+    def enter(self):
+        if b"OK" not in self.command("AT+MUX"):
+            raise RuntimeError("modem did not enter packet mode")
+
+    def send(self, channel, ftype, payload=b""):
+        body = struct.pack("<HBH", channel, ftype, len(payload)) + payload
+        self.ser.write(bytes([SOF]) + body + struct.pack("<H", crc16(body)))
+
+    def write(self, channel, data):
+        # blocks until the modem has granted enough credit
+        ch = self.channels[channel]
+        while data:
+            while ch.credit == 0:
+                self.poll()
+            n = min(len(data), ch.credit, MAX_PAYLOAD)
+            self.send(channel, DATA, data[:n])
+            ch.credit -= n
+            data = data[n:]
+
+    def open(self, address, timeout=15.0):
+        known = set(self.channels)
+        self.send(0, OPEN, address.encode())
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            self.poll()
+            if self.errors:
+                raise RuntimeError("open failed: %s" % self.errors.pop(0))
+            for cid in set(self.channels) - known:
+                return cid
+        raise TimeoutError(address)
+
+    def close(self, channel):
+        self.send(channel, CLOSE)
+
+    def exit(self):
+        self.send(0, EXIT)
+
+    def poll(self):
+        self.buf += self.ser.read(max(1, self.ser.in_waiting))
+        while True:
+            start = self.buf.find(bytes([SOF]))
+            if start < 0:
+                self.buf.clear()
+                return
+            del self.buf[:start]
+            if len(self.buf) < 6:
+                return
+            # same resync as the modem: a bad header or CRC drops what was
+            # parsed so far and the hunt for SOF starts after it
+            channel, ftype, length = struct.unpack_from("<HBH", self.buf, 1)
+            if length > MAX_PAYLOAD:
+                del self.buf[:6]
+                continue
+            if len(self.buf) < 8 + length:
+                return
+            body = bytes(self.buf[1:6 + length])
+            (crc,) = struct.unpack_from("<H", self.buf, 6 + length)
+            if crc != crc16(body):
+                self.crc_errors += 1
+                del self.buf[:8 + length]
+                continue
+            del self.buf[:8 + length]
+            self.dispatch(channel, ftype, body[5:])
+
+    def dispatch(self, channel, ftype, payload):
+        if ftype == OPEN:
+            self.channels[channel] = Channel(channel, payload.decode(errors="replace"))
+        elif ftype == DATA and channel in self.channels:
+            self.channels[channel].received += payload
+            self.send(channel, CREDIT, struct.pack("<H", len(payload)))
+        elif ftype == CREDIT and channel in self.channels and len(payload) >= 2:
+            self.channels[channel].credit += struct.unpack_from("<H", payload)[0]
+        elif ftype == CLOSE and channel in self.channels:
+            self.channels[channel].closed = True
+        elif ftype == ERROR:
+            self.errors.append(payload.decode(errors="replace"))
+
+
+def echo_server(listener):
+    def serve(conn):
+        with conn:
+            while True:
+                data = conn.recv(4096)
+                if not data:
+                    return
+                conn.sendall(data)
+
+    while True:
+        conn, _ = listener.accept()
+        threading.Thread(target=serve, args=(conn,), daemon=True).start()
+
+
+def bench(mux, args):
+    ports = []
+    for _ in range(args.channels):
+        listener = socket.socket()
+        listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        listener.bind(("0.0.0.0", 0))
+        listener.listen()
+        ports.append(listener.getsockname()[1])
+        threading.Thread(target=echo_server, args=(listener,), daemon=True).start()
+
+    channels = [mux.open("%s:%d" % (args.host, port)) for port in ports]
+    payloads = {cid: os.urandom(args.bytes) for cid in channels}
+    offsets = dict.fromkeys(channels, 0)
+    started = time.time()
+    # interleave writes so every channel is in flight at the same time
+    while any(offsets[c] < args.bytes for c in channels):
+        for cid in channels:
+            ch = mux.channels[cid]
+            n = min(ch.credit, MAX_PAYLOAD, args.bytes - offsets[cid])
+            if n > 0:
+                mux.send(cid, DATA, payloads[cid][offsets[cid]:offsets[cid] + n])
+                ch.credit -= n
+                offsets[cid] += n
+        mux.poll()
+    while any(len(mux.channels[c].received) < args.bytes for c in channels):
+        if time.time() - started > args.timeout:
+            break
+        mux.poll()
+    elapsed = time.time() - started
+
+    ok = True
+    for cid in channels:
+        got = bytes(mux.channels[cid].received)
+        good = got == payloads[cid]
+        ok &= good
+        print("channel %d: %d/%d bytes %s" % (cid, len(got), args.bytes, "OK" if good else "MISMATCH"))
+        mux.close(cid)
+    total = 2 * args.bytes * len(channels)
+    print("%d bytes in %.2f s, %.0f bytes/s, %d CRC errors" % (total, elapsed, total / elapsed, mux.crc_errors))
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=115200)
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    op = sub.add_parser("open", help="open one channel and print what arrives")
+    op.add_argument("address")
+    bp = sub.add_parser("bench", help="throughput test against local echo servers")
+    bp.add_argument("--host", required=True, help="address of this machine as seen by the modem")
+    bp.add_argument("--channels", type=int, default=4)
+    bp.add_argument("--bytes", type=int, default=65536)
+    bp.add_argument("--timeout", type=float, default=60.0)
+    args = parser.parse_args()
+
+    mux = Mux(args.port, args.baud)
+    mux.enter()
+    try:
+        if args.cmd == "bench":
+            return 0 if bench(mux, args) else 1
+        cid = mux.open(args.address)
+        ch = mux.channels[cid]
+        while not ch.closed:
+            mux.poll()
+            if ch.received:
+                sys.stdout.buffer.write(ch.received)
+                sys.stdout.flush()
+                ch.received.clear()
+        return 0
+    finally:
+        mux.exit()
+
+
+if __name__ == "__main__":
+    sys.exit(main())